@@ -3,11 +3,16 @@
 // For use by Mashenka Application
 #include "Mashenka/Core/Application.h"
 #include "Mashenka/Core/Layer.h"
+#include "Mashenka/Core/FramePacer.h"
+#include "Mashenka/Core/JobSystem.h"
+#include "Mashenka/Debug/FrameCapture.h"
 #include "Mashenka/Core/Log.h"
 #include "Mashenka/Core/Core.h"
 
 // PRODUCT_CORE
 #include "Mashenka/Core/Timestep.h"
+#include "Mashenka/Core/FileWatcher.h"
+#include "Mashenka/Debug/GPUProfiler.h"
 
 // INPUT
 #include "Mashenka/Core/Input.h"
@@ -26,9 +31,20 @@
 
 
 #include "Mashenka/Renderer/Buffer.h"
+#include "Mashenka/Renderer/Framebuffer.h"
+#include "Mashenka/Renderer/DynamicResolution.h"
 #include "Mashenka/Renderer/Shader.h"
+#include "Mashenka/Renderer/ComputeShader.h"
 #include "Mashenka/Renderer/Texture.h"
+#include "Mashenka/Renderer/TextureResidency.h"
+#include "Mashenka/Renderer/RendererStats.h"
+#include "Mashenka/Renderer/Culling.h"
+#include "Mashenka/Renderer/TileMap.h"
+#include "Mashenka/Renderer/SpriteBatch.h"
+#include "Mashenka/Renderer/ParticleSystem.h"
+#include "Mashenka/Renderer/GPUParticleSystem.h"
 #include "Mashenka/Renderer/VertexArray.h"
+#include "Mashenka/Renderer/MeshPool.h"
 
 // Camera
 #include "Mashenka/Renderer/Camera.h"
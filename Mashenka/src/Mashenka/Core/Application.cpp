@@ -3,6 +3,9 @@
 #include "Mashenka/Core/Log.h"
 #include "Mashenka/Core/Input.h"
 #include "Mashenka/Core/TimeStep.h"
+#include "Mashenka/Core/FramePacer.h"
+#include "Mashenka/Core/JobSystem.h"
+#include "Mashenka/Debug/FrameCapture.h"
 #include "Mashenka/Renderer/Renderer.h"
 
 #include <GLFW/glfw3.h>
@@ -14,7 +17,8 @@ namespace Mashenka
     Application* Application::s_Instance = nullptr;
 
     // this is the constructor of the application class
-    Application::Application()
+    Application::Application(ApplicationCommandLineArgs args)
+        : m_CommandLineArgs(args)
     {
         // Profiling
         MK_PROFILE_FUNCTION();
@@ -37,9 +41,17 @@ namespace Mashenka
         m_ImGuiLayer = new ImGuiLayer();
         PushOverlay(m_ImGuiLayer);
 
+        // the workers are up before anything can hand them jobs
+        JobSystem::Init();
+
         // ==================== Initialize the Renderer ====================
         // Initialize the Renderer
         Renderer::Init();
+        // no resize event comes for the initial size
+        Renderer::OnWindowResize(m_Window->GetWidth(), m_Window->GetHeight());
+        // VSync is off, the pacer bounds the frames in flight and caps the frame rate
+        FramePacer::Init();
+        FrameCapture::Init();
         
     }
 
@@ -47,6 +59,9 @@ namespace Mashenka
     {
         // Profiling
         MK_PROFILE_FUNCTION();
+        FrameCapture::Shutdown();
+        FramePacer::Shutdown();
+        JobSystem::Shutdown();
         Renderer::Shutdown();
     }
 
@@ -63,6 +78,8 @@ namespace Mashenka
         // If so, the bound event will be called (which is the Application.OnWindowClose functions)
         dispatcher.Dispatch<WindowCloseEvent>(MK_BIND_EVENT_FN(Application::OnWindowClose));
         dispatcher.Dispatch<WindowResizeEvent>(MK_BIND_EVENT_FN(Application::OnWindowResize));
+        dispatcher.Dispatch<WindowFocusEvent>(MK_BIND_EVENT_FN(Application::OnWindowFocus));
+        dispatcher.Dispatch<WindowLostFocusEvent>(MK_BIND_EVENT_FN(Application::OnWindowLostFocus));
 
         /*
          * Explain the following code:
@@ -103,17 +120,35 @@ namespace Mashenka
     }
 
 
+    void Application::Close()
+    {
+        m_Running = false;
+    }
+
+
     /*
      * 4. **Running the Application**:
      * The application is run by calling the `run` function on the application instance.
      * This initiates a while loop that keeps the application running.
      */
+    // While minimized nothing is drawn, the loop sleeps in the OS until an event arrives or this timeout runs out
+    static constexpr float s_MinimizedWaitTimeout = 0.5f; // seconds
+
     void Application::Run()
     {
         // Profiling
         MK_PROFILE_FUNCTION();
         while (m_Running)
         {
+            if (m_Minimized)
+            {
+                // no input polling, ImGui frame or swap, a minimized application costs next to nothing
+                m_Window->WaitEvents(s_MinimizedWaitTimeout);
+                // don't hand the time spent minimized to the layers as one huge time step
+                m_LastFrameTime = (float)glfwGetTime();
+                continue;
+            }
+
             // Profiling
             MK_PROFILE_SCOPE("RunLoop");
             // Calculate the Delta Time based on the TimeStep
@@ -121,18 +156,16 @@ namespace Mashenka
             TimeStep timeStep = time - m_LastFrameTime;
             m_LastFrameTime = time;
 
+            // Per frame renderer bookkeeping
+            Renderer::BeginFrame();
 
             // Poll Input, this is the polling of the input system
             Input::Poll();
 
             // Go through all the layers, as each layer can handle its own update
-            if (!m_Minimized)
-            {
-                // Profiling
-                MK_PROFILE_SCOPE("LayerStack OnUpdate");
-                for (Layer* layer : m_LayerStack)
-                    layer->OnUpdate(timeStep); // Update the needed info
-            }
+            // layers with a parallel update run on the JobSystem, their drawing comes back to this thread
+            m_LayerStack.Update(timeStep);
+            Renderer::EndFrame();
 
             // Initialize the ImGui frame, prepare for the rendering, context and input
             m_ImGuiLayer->Begin();
@@ -148,8 +181,13 @@ namespace Mashenka
             // finalize the rendering for the current frame, wraps up tasks like draw data
             m_ImGuiLayer->End();
 
+            // screenshots and recordings read the finished frame back, before it is presented
+            FrameCapture::EndFrame(m_Window->GetWidth(), m_Window->GetHeight());
+
             // Render the next frame and poll the glfw events
+            FramePacer::BeforePresent();
             m_Window->OnUpdate();
+            FramePacer::AfterPresent();
         }
     }
 
@@ -177,4 +215,17 @@ namespace Mashenka
         Renderer::OnWindowResize(e.GetWidth(), e.GetHeight());
         return false;
     }
+
+    bool Application::OnWindowFocus(WindowFocusEvent& e)
+    {
+        FramePacer::SetBackground(false);
+        return false;
+    }
+
+    bool Application::OnWindowLostFocus(WindowLostFocusEvent& e)
+    {
+        // other windows have the user's attention, run at the background frame rate
+        FramePacer::SetBackground(true);
+        return false;
+    }
 }
@@ -14,10 +14,23 @@ int main(int argc, char** argv); // declare the main function
 
 namespace Mashenka
 {
+    // The arguments main was started with, handed to CreateApplication
+    struct ApplicationCommandLineArgs
+    {
+        int Count = 0;
+        char** Args = nullptr;
+
+        const char* operator[](int index) const
+        {
+            MK_CORE_ASSERT(index < Count, "Command line argument out of range!");
+            return Args[index];
+        }
+    };
+
     class Application
     {
     public:
-        Application();
+        Application(ApplicationCommandLineArgs args = ApplicationCommandLineArgs());
 
         // virtual destructor to make sure the derived class destructor is called
         // explain this: https://stackoverflow.com/questions/461203/when-to-use-virtual-destructors
@@ -27,17 +40,25 @@ namespace Mashenka
 
         void PushLayer(Layer* layer);
         void PushOverlay(Layer* layer);
+
+        // Leaves the run loop after the current frame
+        void Close();
         
 
         //Using a static function to get the sole instance of the application
         inline Window& GetWindow() const {return *m_Window;}
+        inline ImGuiLayer* GetImGuiLayer() const {return m_ImGuiLayer;}
+        inline const ApplicationCommandLineArgs& GetCommandLineArgs() const {return m_CommandLineArgs;}
         inline static Application& Get() {return *s_Instance;}
 
     private:
         void Run(); // making the main loop private to make sure it is only called from the main function
         bool OnWindowClose(WindowCloseEvent& e);
         bool OnWindowResize(WindowResizeEvent& e);
+        bool OnWindowFocus(WindowFocusEvent& e);
+        bool OnWindowLostFocus(WindowLostFocusEvent& e);
 
+        ApplicationCommandLineArgs m_CommandLineArgs;
         std::unique_ptr<Window> m_Window;
         bool m_Running = true;
         bool m_Minimized = false;
@@ -53,5 +74,5 @@ namespace Mashenka
     };
 
     // To be defined in Client
-    Application* CreateApplication();
+    Application* CreateApplication(ApplicationCommandLineArgs args);
 }
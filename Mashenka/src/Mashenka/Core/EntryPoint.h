@@ -12,7 +12,7 @@
 // This is a common design pattern called, Platform layer or Application Framework
 #ifdef MK_PLATFORM_WINDOWS
 
-extern Mashenka::Application* Mashenka::CreateApplication();
+extern Mashenka::Application* Mashenka::CreateApplication(Mashenka::ApplicationCommandLineArgs args);
 
 int main(int argc, char** argv) //main cannot be inline
 {
@@ -22,7 +22,7 @@ int main(int argc, char** argv) //main cannot be inline
     MK_CORE_INFO("Hello {0}, Welcome to Mashenka!", a);
 
     MK_PROFILE_BEGIN_SESSION("Startup", "profile-data/MashenkaProfile-Startup.json");
-    auto app = Mashenka::CreateApplication();
+    auto app = Mashenka::CreateApplication({argc, argv});
     MK_PROFILE_END_SESSION();
 
     // Profile
@@ -0,0 +1,39 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Core/FileWatcher.h"
+
+#ifdef MK_PLATFORM_WINDOWS
+#include "Platform/Windows/WindowsFileWatcher.h"
+#elif defined(MK_PLATFORM_LINUX)
+#include "Platform/Linux/LinuxFileWatcher.h"
+#endif
+
+namespace Mashenka
+{
+    Scope<FileWatcher> FileWatcher::Create(const std::string& directory)
+    {
+        #ifdef MK_PLATFORM_WINDOWS
+                return CreateScope<WindowsFileWatcher>(directory);
+        #elif defined(MK_PLATFORM_LINUX)
+                return CreateScope<LinuxFileWatcher>(directory);
+        #else
+                MK_CORE_ASSERT(false, "Unknow Platform");
+                return nullptr;
+        #endif
+    }
+
+    std::vector<std::string> FileWatcher::PollChanges()
+    {
+        std::vector<std::string> changes;
+        std::lock_guard lock(m_Mutex);
+        changes.swap(m_Changes);
+        return changes;
+    }
+
+    void FileWatcher::PushChange(const std::string& path)
+    {
+        std::lock_guard lock(m_Mutex);
+        // Editors often write a file several times per save, report it once
+        if (std::find(m_Changes.begin(), m_Changes.end(), path) == m_Changes.end())
+            m_Changes.push_back(path);
+    }
+}
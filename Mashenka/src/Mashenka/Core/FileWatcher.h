@@ -0,0 +1,37 @@
+﻿#pragma once
+#include "Mashenka/Core/Core.h"
+
+#include <mutex>
+
+namespace Mashenka
+{
+    /*
+     * FileWatcher Class
+     * Watches a directory (not recursive) for files that are written, created or renamed into it
+     * The platform implementation waits for the changes on its own thread, PollChanges hands them to the caller
+     */
+    class FileWatcher
+    {
+    public:
+        virtual ~FileWatcher() = default;
+
+        // Paths ("<directory>/<file>") of the files changed since the last call, each path is reported once
+        // Never blocks, can be called every frame
+        std::vector<std::string> PollChanges();
+
+        const std::string& GetDirectory() const { return m_Directory; }
+
+        static Scope<FileWatcher> Create(const std::string& directory);
+
+    protected:
+        FileWatcher(const std::string& directory) : m_Directory(directory) {}
+
+        // called from the watcher thread
+        void PushChange(const std::string& path);
+
+    private:
+        std::string m_Directory;
+        std::mutex m_Mutex;
+        std::vector<std::string> m_Changes;
+    };
+}
@@ -0,0 +1,194 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Core/FramePacer.h"
+#include "Mashenka/Renderer/GPUFence.h"
+
+#include <deque>
+#include <thread>
+
+namespace Mashenka
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct FramePacerStorage
+    {
+        static const uint32_t MaxFramesInFlightLimit = 3;
+        static const uint32_t StatisticsFrames = 120;
+        // the scheduler may wake us up this late, the rest of the wait spins
+        static constexpr std::chrono::microseconds SpinThreshold{2000};
+        // a fence that takes longer than this means the GPU is hung, don't wait forever
+        static constexpr uint64_t FenceTimeout = 1000000000; // nanoseconds
+
+        uint32_t MaxFramesInFlight = 2;
+        std::deque<Scope<GPUFence>> Fences; // oldest first
+
+        float FrameRateCap = 0.0f;
+        float BackgroundFrameRateCap = 10.0f;
+        bool Background = false;
+        Clock::time_point NextPresent;
+
+        Clock::time_point LastPresent;
+        bool HasPresented = false;
+        std::array<float, StatisticsFrames> FrameTimes = {}; // milliseconds, ring buffer
+        uint32_t FrameTimeCount = 0, FrameTimeIndex = 0;
+        FramePacer::Statistics Stats;
+    };
+
+    static FramePacerStorage* s_Data;
+
+    void FramePacer::Init()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        s_Data = new FramePacerStorage();
+    }
+
+    void FramePacer::Shutdown()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        delete s_Data;
+        s_Data = nullptr;
+    }
+
+    void FramePacer::SetMaxFramesInFlight(uint32_t frames)
+    {
+        s_Data->MaxFramesInFlight = std::min(std::max(frames, 1u), FramePacerStorage::MaxFramesInFlightLimit);
+    }
+
+    uint32_t FramePacer::GetMaxFramesInFlight()
+    {
+        return s_Data->MaxFramesInFlight;
+    }
+
+    void FramePacer::SetFrameRateCap(float framesPerSecond)
+    {
+        s_Data->FrameRateCap = std::max(framesPerSecond, 0.0f);
+        s_Data->NextPresent = Clock::now();
+    }
+
+    float FramePacer::GetFrameRateCap()
+    {
+        return s_Data->FrameRateCap;
+    }
+
+    void FramePacer::SetBackgroundFrameRateCap(float framesPerSecond)
+    {
+        s_Data->BackgroundFrameRateCap = std::max(framesPerSecond, 0.0f);
+    }
+
+    float FramePacer::GetBackgroundFrameRateCap()
+    {
+        return s_Data->BackgroundFrameRateCap;
+    }
+
+    void FramePacer::SetBackground(bool background)
+    {
+        s_Data->Background = background;
+        s_Data->NextPresent = Clock::now();
+    }
+
+    bool FramePacer::IsBackground()
+    {
+        return s_Data->Background;
+    }
+
+    // the lower of the caps that apply, 0 when none does
+    static float GetEffectiveFrameRateCap()
+    {
+        float cap = s_Data->FrameRateCap;
+        float background = s_Data->Background ? s_Data->BackgroundFrameRateCap : 0.0f;
+        if (cap <= 0.0f)
+            return background;
+        if (background <= 0.0f)
+            return cap;
+        return std::min(cap, background);
+    }
+
+    const FramePacer::Statistics& FramePacer::GetStats()
+    {
+        return s_Data->Stats;
+    }
+
+    void FramePacer::BeforePresent()
+    {
+        if (!s_Data)
+            return;
+        const float frameRateCap = GetEffectiveFrameRateCap();
+        if (frameRateCap <= 0.0f)
+            return;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        const auto interval = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / frameRateCap));
+        Clock::time_point now = Clock::now();
+
+        // a frame that took too long starts a new schedule instead of rushing the next frames to catch up
+        if (s_Data->NextPresent < now - interval)
+            s_Data->NextPresent = now;
+
+        // sleep for most of the wait, spin for the rest, in the background a late frame is fine
+        Clock::time_point deadline = s_Data->NextPresent;
+        if (s_Data->Background)
+        {
+            std::this_thread::sleep_until(deadline);
+        }
+        else
+        {
+            if (deadline - now > FramePacerStorage::SpinThreshold)
+                std::this_thread::sleep_for(deadline - now - FramePacerStorage::SpinThreshold);
+            while (Clock::now() < deadline)
+                std::this_thread::yield();
+        }
+
+        s_Data->NextPresent = deadline + interval;
+    }
+
+    static void RecordPresent()
+    {
+        Clock::time_point now = Clock::now();
+        if (s_Data->HasPresented)
+        {
+            float frameTime = std::chrono::duration<float, std::milli>(now - s_Data->LastPresent).count();
+            s_Data->FrameTimes[s_Data->FrameTimeIndex] = frameTime;
+            s_Data->FrameTimeIndex = (s_Data->FrameTimeIndex + 1) % FramePacerStorage::StatisticsFrames;
+            s_Data->FrameTimeCount = std::min(s_Data->FrameTimeCount + 1, FramePacerStorage::StatisticsFrames);
+
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < s_Data->FrameTimeCount; i++)
+                sum += s_Data->FrameTimes[i];
+            float mean = sum / static_cast<float>(s_Data->FrameTimeCount);
+
+            float variance = 0.0f, maxDeviation = 0.0f;
+            for (uint32_t i = 0; i < s_Data->FrameTimeCount; i++)
+            {
+                float deviation = s_Data->FrameTimes[i] - mean;
+                variance += deviation * deviation;
+                maxDeviation = std::max(maxDeviation, std::abs(deviation));
+            }
+
+            s_Data->Stats.FrameTime = mean;
+            s_Data->Stats.Jitter = std::sqrt(variance / static_cast<float>(s_Data->FrameTimeCount));
+            s_Data->Stats.MaxDeviation = maxDeviation;
+        }
+        s_Data->LastPresent = now;
+        s_Data->HasPresented = true;
+    }
+
+    void FramePacer::AfterPresent()
+    {
+        if (!s_Data)
+            return;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        RecordPresent();
+
+        s_Data->Fences.push_back(GPUFence::Create());
+        Clock::time_point waitStart = Clock::now();
+        while (s_Data->Fences.size() > s_Data->MaxFramesInFlight)
+        {
+            MK_PROFILE_SCOPE("FramePacer Wait For GPU");
+            if (!s_Data->Fences.front()->Wait(FramePacerStorage::FenceTimeout))
+                MK_CORE_WARN("FramePacer: the GPU did not finish a frame within a second");
+            s_Data->Fences.pop_front();
+        }
+        s_Data->Stats.FenceWaitTime = std::chrono::duration<float, std::milli>(Clock::now() - waitStart).count();
+    }
+}
@@ -0,0 +1,52 @@
+﻿#pragma once
+
+namespace Mashenka
+{
+    /*
+     * FramePacer Class
+     * Keeps the CPU from running ahead of the GPU and optionally caps the frame rate
+     * After every present a GPU fence is inserted, once more frames than allowed are in flight the CPU waits for the
+     * oldest one. Fewer frames in flight means less input latency, more means fewer CPU stalls
+     * The frame rate cap sleeps for most of the remaining time and spins for the last bit, as sleeping alone
+     * overshoots by up to a scheduler tick
+     * Driven by Application::Run around Window::OnUpdate, which presents the frame
+     */
+    class FramePacer
+    {
+    public:
+        struct Statistics
+        {
+            float FrameTime = 0.0f; // mean present to present milliseconds
+            float Jitter = 0.0f; // standard deviation of the present to present time, milliseconds
+            float MaxDeviation = 0.0f; // largest distance of a frame from the mean, milliseconds
+            float FenceWaitTime = 0.0f; // milliseconds the last frame waited for the GPU
+        };
+
+    public:
+        static void Init();
+        static void Shutdown();
+
+        // 1 to 3, 2 by default
+        static void SetMaxFramesInFlight(uint32_t frames);
+        static uint32_t GetMaxFramesInFlight();
+
+        // Frames per second, 0 (the default) leaves the frame rate uncapped
+        static void SetFrameRateCap(float framesPerSecond);
+        static float GetFrameRateCap();
+
+        // Cap while the application is in the background (window not focused), 0 disables it, 10 by default
+        // Background frames only sleep, they don't spin for a precise present
+        static void SetBackgroundFrameRateCap(float framesPerSecond);
+        static float GetBackgroundFrameRateCap();
+        static void SetBackground(bool background);
+        static bool IsBackground();
+
+        // over the last 120 frames
+        static const Statistics& GetStats();
+
+        // Waits for the frame rate cap, right before the frame is presented
+        static void BeforePresent();
+        // Fences the presented frame and waits while too many frames are in flight
+        static void AfterPresent();
+    };
+}
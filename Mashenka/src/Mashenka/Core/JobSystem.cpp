@@ -0,0 +1,267 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Core/JobSystem.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace Mashenka
+{
+    struct QueuedJob
+    {
+        Job Function;
+        JobCounter* Counter = nullptr;
+    };
+
+    // One per thread, the owner works at the back, thieves take from the front
+    struct WorkQueue
+    {
+        std::mutex Mutex;
+        std::deque<QueuedJob> Jobs;
+    };
+
+    struct JobSystemStorage
+    {
+        std::vector<Scope<WorkQueue>> Queues; // 0 is the main thread, then one per worker
+        std::vector<std::thread> Workers;
+
+        // jobs in any queue, the workers sleep while there are none, Wait also sleeps until its counter is done
+        std::atomic<uint32_t> QueuedJobs{0};
+        std::mutex SleepMutex;
+        std::condition_variable WakeUp;
+        bool Stopping = false;
+    };
+
+    static JobSystemStorage* s_Data;
+    static thread_local uint32_t s_ThreadIndex = JobSystem::InvalidThreadIndex;
+
+    static void Push(QueuedJob job)
+    {
+        // threads outside of the pool hand their jobs to the main thread queue, anyone can steal them from there
+        uint32_t index = s_ThreadIndex != JobSystem::InvalidThreadIndex ? s_ThreadIndex : 0;
+        // counted before it can be taken, a thief's decrement must never come first and wrap the count around
+        s_Data->QueuedJobs.fetch_add(1, std::memory_order_release);
+        {
+            WorkQueue& queue = *s_Data->Queues[index];
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+            queue.Jobs.push_back(std::move(job));
+        }
+
+        // taking the lock makes sure a worker that just found nothing is waiting by now, and gets the notification
+        {
+            std::lock_guard<std::mutex> lock(s_Data->SleepMutex);
+        }
+        s_Data->WakeUp.notify_one();
+    }
+
+    static bool TryPop(QueuedJob& job)
+    {
+        const auto queueCount = static_cast<uint32_t>(s_Data->Queues.size());
+        uint32_t self = s_ThreadIndex;
+        if (self != JobSystem::InvalidThreadIndex)
+        {
+            WorkQueue& queue = *s_Data->Queues[self];
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+            if (!queue.Jobs.empty())
+            {
+                job = std::move(queue.Jobs.back());
+                queue.Jobs.pop_back();
+                s_Data->QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // steal, starting next to us so the thieves spread over the queues
+        uint32_t start = self != JobSystem::InvalidThreadIndex ? self + 1 : 0;
+        for (uint32_t i = 0; i < queueCount; i++)
+        {
+            uint32_t victim = (start + i) % queueCount;
+            if (victim == self)
+                continue;
+
+            WorkQueue& queue = *s_Data->Queues[victim];
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+            if (!queue.Jobs.empty())
+            {
+                job = std::move(queue.Jobs.front());
+                queue.Jobs.pop_front();
+                s_Data->QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void JobSystem::Init(uint32_t workerCount)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (workerCount == 0)
+            workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+        s_Data = new JobSystemStorage();
+        s_ThreadIndex = 0;
+        for (uint32_t i = 0; i <= workerCount; i++)
+            s_Data->Queues.push_back(CreateScope<WorkQueue>());
+        for (uint32_t i = 1; i <= workerCount; i++)
+            s_Data->Workers.emplace_back(WorkerLoop, i);
+        MK_CORE_INFO("JobSystem: {0} workers", workerCount);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        {
+            std::lock_guard<std::mutex> lock(s_Data->SleepMutex);
+            s_Data->Stopping = true;
+        }
+        s_Data->WakeUp.notify_all();
+        for (auto& worker : s_Data->Workers)
+            worker.join();
+
+        delete s_Data;
+        s_Data = nullptr;
+        s_ThreadIndex = InvalidThreadIndex;
+    }
+
+    uint32_t JobSystem::GetWorkerCount()
+    {
+        return s_Data ? static_cast<uint32_t>(s_Data->Workers.size()) : 0;
+    }
+
+    uint32_t JobSystem::GetThreadIndex()
+    {
+        return s_ThreadIndex;
+    }
+
+    void JobSystem::Run(Job job, JobCounter* counter)
+    {
+        if (counter)
+            counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+        Submit({std::move(job), counter});
+    }
+
+    void JobSystem::RunAfter(JobCounter& dependency, Job job, JobCounter* counter)
+    {
+        if (counter)
+            counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            // the last job of the dependency takes the continuations under the same lock, see FinishJob
+            std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+            if (!dependency.IsDone())
+            {
+                dependency.m_Continuations.emplace_back(std::move(job), counter);
+                return;
+            }
+        }
+        Submit({std::move(job), counter});
+    }
+
+    void JobSystem::WorkerLoop(uint32_t index)
+    {
+        s_ThreadIndex = index;
+        while (true)
+        {
+            QueuedJob job;
+            if (TryPop(job))
+            {
+                Execute(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(s_Data->SleepMutex);
+            s_Data->WakeUp.wait(lock, [] { return s_Data->Stopping || s_Data->QueuedJobs.load() > 0; });
+            if (s_Data->Stopping && s_Data->QueuedJobs.load() == 0)
+                return; // everything queued before Shutdown ran
+        }
+    }
+
+    // Without workers (or before Init) jobs run right away on the calling thread
+    void JobSystem::Submit(QueuedJob job)
+    {
+        if (!s_Data || s_Data->Workers.empty())
+        {
+            Execute(job);
+            return;
+        }
+        Push(std::move(job));
+    }
+
+    void JobSystem::Execute(QueuedJob& job)
+    {
+        job.Function();
+        if (job.Counter)
+            FinishJob(*job.Counter);
+    }
+
+    void JobSystem::FinishJob(JobCounter& counter)
+    {
+        std::vector<std::pair<Job, JobCounter*>> continuations;
+        bool done;
+        {
+            std::lock_guard<std::mutex> lock(counter.m_Mutex);
+            done = counter.m_Value.fetch_sub(1, std::memory_order_acq_rel) == 1;
+            if (done)
+                continuations.swap(counter.m_Continuations);
+        }
+        for (auto& [job, jobCounter] : continuations)
+            Submit({std::move(job), jobCounter});
+
+        // wake the threads sleeping in Wait, the counter may be gone by now and is not touched again
+        if (done && s_Data)
+        {
+            {
+                std::lock_guard<std::mutex> lock(s_Data->SleepMutex);
+            }
+            s_Data->WakeUp.notify_all();
+        }
+    }
+
+    void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& body)
+    {
+        if (count == 0)
+            return;
+
+        grainSize = std::max(grainSize, 1u);
+        uint32_t ranges = (count - 1) / grainSize + 1;
+        if (ranges == 1 || GetWorkerCount() == 0)
+        {
+            body(0, count);
+            return;
+        }
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        JobCounter counter;
+        for (uint32_t range = 1; range < ranges; range++)
+        {
+            uint32_t begin = range * grainSize;
+            uint32_t end = std::min(count, begin + grainSize);
+            Run([&body, begin, end]() { body(begin, end); }, &counter);
+        }
+        body(0, grainSize);
+        Wait(counter);
+    }
+
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        while (!counter.IsDone())
+        {
+            QueuedJob job;
+            if (s_Data && TryPop(job))
+            {
+                Execute(job);
+                continue;
+            }
+            if (!s_Data)
+                break; // without the pool every job ran inside Run
+
+            // nothing to help with, sleep until a job is queued or the last job of the counter finished
+            std::unique_lock<std::mutex> lock(s_Data->SleepMutex);
+            s_Data->WakeUp.wait(lock, [&counter] { return counter.IsDone() || s_Data->QueuedJobs.load() > 0; });
+        }
+
+        // the last job may still be inside FinishJob, the counter must not go away before it left
+        std::lock_guard<std::mutex> lock(counter.m_Mutex);
+    }
+}
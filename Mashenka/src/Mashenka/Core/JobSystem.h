@@ -0,0 +1,78 @@
+﻿#pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/*
+ * SUMMARY:
+ * A fixed pool of worker threads for splitting engine work (culling, vertex generation, particle updates...)
+ * across the cores
+ *
+ * HOW IT WORKS:
+ * Every thread of the pool, and the main thread, owns a deque of jobs. A thread pushes the jobs it creates to the
+ * back of its own deque and takes its next job from the back too, the most recent work is still in the cache
+ * A thread with an empty deque steals from the front of another one, so the oldest (usually biggest) work moves
+ * Workers without anything to do sleep until a job is submitted
+ * A JobCounter counts the unfinished jobs of a group. Wait on it helps running jobs instead of blocking, so waiting
+ * from the main thread or from inside a job never leaves a core idle, and RunAfter starts a job once it reaches zero
+ */
+
+namespace Mashenka
+{
+    using Job = std::function<void()>;
+    struct QueuedJob;
+
+    class JobCounter
+    {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        // the jobs of the group that have not finished yet
+        uint32_t GetValue() const { return m_Value.load(std::memory_order_acquire); }
+        bool IsDone() const { return GetValue() == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> m_Value{0};
+        // jobs waiting for the counter to reach zero, see JobSystem::RunAfter
+        std::mutex m_Mutex;
+        std::vector<std::pair<Job, JobCounter*>> m_Continuations;
+    };
+
+    class JobSystem
+    {
+    public:
+        // 0 workers picks one per core, minus the main thread
+        static void Init(uint32_t workerCount = 0);
+        // Finishes the jobs that are still queued
+        static void Shutdown();
+
+        static uint32_t GetWorkerCount();
+        // 0 is the main thread (the thread that called Init), the workers are 1 to GetWorkerCount()
+        // Threads that don't belong to the pool get InvalidThreadIndex
+        static constexpr uint32_t InvalidThreadIndex = ~0u;
+        static uint32_t GetThreadIndex();
+
+        // The job runs on any thread of the pool. The counter, if any, counts it until it finished
+        static void Run(Job job, JobCounter* counter = nullptr);
+        // Runs the job once dependency reaches zero, right away if it already did
+        static void RunAfter(JobCounter& dependency, Job job, JobCounter* counter = nullptr);
+
+        // Calls body(begin, end) for ranges of at most grainSize elements that cover [0, count), on every core,
+        // and returns once all of them are done. The calling thread takes one range itself
+        static void ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& body);
+
+        // Runs queued jobs on this thread until the counter reaches zero
+        static void Wait(JobCounter& counter);
+
+    private:
+        static void WorkerLoop(uint32_t index);
+        static void Submit(QueuedJob job);
+        static void Execute(QueuedJob& job);
+        static void FinishJob(JobCounter& counter);
+    };
+}
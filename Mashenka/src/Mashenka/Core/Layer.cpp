@@ -3,11 +3,33 @@
 
 namespace Mashenka
 {
+    static bool Intersects(const std::vector<std::string>& a, const std::vector<std::string>& b)
+    {
+        for (const std::string& name : a)
+        {
+            if (std::find(b.begin(), b.end(), name) != b.end())
+                return true;
+        }
+        return false;
+    }
+
+    bool LayerAccess::ConflictsWith(const LayerAccess& other) const
+    {
+        // reading together is fine, a write conflicts with any other access of the same state
+        return Intersects(Writes, other.Reads) || Intersects(Writes, other.Writes) || Intersects(Reads, other.Writes);
+    }
+
     Layer::Layer(const std::string& debugName)
         : m_DebugName(debugName)
     {
         
     }
 
+    void Layer::SetParallelUpdate(const LayerAccess& access)
+    {
+        m_ParallelUpdate = true;
+        m_Access = access;
+    }
+
 
 }
@@ -6,6 +6,16 @@
 
 namespace Mashenka
 {
+    // The shared state the OnUpdate of a layer reads and writes, by name ("World", "Audio"...), see SetParallelUpdate
+    struct LayerAccess
+    {
+        std::vector<std::string> Reads;
+        std::vector<std::string> Writes;
+
+        // true when the two updates must not run at the same time
+        bool ConflictsWith(const LayerAccess& other) const;
+    };
+
     /*The Layer class serves as a base class for different layers in the Mashenka game engine.
      *Layers can be thought of as individual components or stages in the rendering or update process of a game or application.
      *By providing virtual functions like OnAttach, OnDetach, OnUpdate, and OnEvent,
@@ -19,14 +29,29 @@ namespace Mashenka
         virtual void OnAttach(){}
         virtual void OnDetach(){}
         virtual void OnUpdate(TimeStep ts){}
+        // Runs on the main thread right after OnUpdate, for the drawing of layers with a parallel update
+        virtual void OnRender(){}
         virtual void OnImGuiRender(){} // Every layer could have its own thing to render
         virtual void OnEvent(Event& event){}
 
         inline const std::string& GetName() const {return m_DebugName;}
 
+        bool HasParallelUpdate() const { return m_ParallelUpdate; }
+        const LayerAccess& GetAccess() const { return m_Access; }
+
+    protected:
+        // Lets OnUpdate run on a JobSystem worker, next to the other parallel layers it does not conflict with
+        // OnUpdate then only touches the layer itself and the declared state, the GL work moves to OnRender
+        // Call it from the constructor or OnAttach, the LayerStack plans the updates when layers are pushed or popped
+        void SetParallelUpdate(const LayerAccess& access);
+
     protected:
         std::string m_DebugName;
-        
+
+    private:
+        bool m_ParallelUpdate = false;
+        LayerAccess m_Access;
+
     };
 }
 
@@ -1,5 +1,6 @@
 ﻿#include "mkpch.h"
 #include "Mashenka/Core/LayerStack.h"
+#include "Mashenka/Core/JobSystem.h"
 
 namespace Mashenka
 {
@@ -16,12 +17,14 @@ namespace Mashenka
     {
         m_Layers.emplace(m_Layers.begin() + m_LayerInsertIndex, layer);
         m_LayerInsertIndex++;
+        m_UpdateGraphDirty = true;
         layer->OnAttach(); // call OnAttach when the layer is pushed into the stack
     }
 
     void LayerStack::PushOverlay(Layer* overlay)
     {
         m_Layers.emplace_back(overlay);
+        m_UpdateGraphDirty = true;
         overlay->OnAttach();
     }
     
@@ -34,6 +37,7 @@ namespace Mashenka
             layer->OnDetach(); // call OnDetach when layer is poped
             m_Layers.erase(it);
             m_LayerInsertIndex--;
+            m_UpdateGraphDirty = true;
         }
     }
 
@@ -45,12 +49,92 @@ namespace Mashenka
         {
             overlay->OnDetach();
             m_Layers.erase(it);
+            m_UpdateGraphDirty = true;
         }
     }
 
+    void LayerStack::BuildUpdateGraph()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        const auto count = static_cast<uint32_t>(m_Layers.size());
+        m_UpdateSuccessors.assign(count, {});
+        m_UpdateDependencyCounts.assign(count, 0);
+        m_UpdateDependenciesLeft = std::vector<std::atomic<uint32_t>>(count);
 
+        // edges only inside a run of parallel layers, the main thread layers around it are barriers anyway
+        for (uint32_t later = 0; later < count; later++)
+        {
+            if (!m_Layers[later]->HasParallelUpdate())
+                continue;
+            for (uint32_t earlier = later; earlier-- > 0 && m_Layers[earlier]->HasParallelUpdate();)
+            {
+                if (m_Layers[earlier]->GetAccess().ConflictsWith(m_Layers[later]->GetAccess()))
+                {
+                    m_UpdateSuccessors[earlier].push_back(later);
+                    m_UpdateDependencyCounts[later]++;
+                }
+            }
+        }
+        m_UpdateGraphDirty = false;
+    }
 
+    void LayerStack::RunParallelUpdate(uint32_t index, TimeStep ts, JobCounter& counter)
+    {
+        JobSystem::Run([this, index, ts, &counter]()
+        {
+            {
+                MK_PROFILE_SCOPE("LayerStack OnUpdate");
+                m_Layers[index]->OnUpdate(ts);
+            }
+            // the last dependency to finish starts the layer, still counted by the same counter
+            for (uint32_t successor : m_UpdateSuccessors[index])
+            {
+                if (m_UpdateDependenciesLeft[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    RunParallelUpdate(successor, ts, counter);
+            }
+        }, &counter);
+    }
 
+    void LayerStack::Update(TimeStep ts)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (m_UpdateGraphDirty)
+            BuildUpdateGraph();
+
+        const auto count = static_cast<uint32_t>(m_Layers.size());
+        uint32_t first = 0;
+        while (first < count)
+        {
+            Layer* layer = m_Layers[first];
+            if (!layer->HasParallelUpdate())
+            {
+                {
+                    MK_PROFILE_SCOPE("LayerStack OnUpdate");
+                    layer->OnUpdate(ts);
+                }
+                layer->OnRender();
+                first++;
+                continue;
+            }
 
+            // the run of parallel layers, started from the ones without dependencies, the main thread helps
+            uint32_t end = first;
+            while (end < count && m_Layers[end]->HasParallelUpdate())
+                end++;
+            for (uint32_t i = first; i < end; i++)
+                m_UpdateDependenciesLeft[i].store(m_UpdateDependencyCounts[i], std::memory_order_relaxed);
 
+            JobCounter counter;
+            for (uint32_t i = first; i < end; i++)
+            {
+                if (m_UpdateDependencyCounts[i] == 0)
+                    RunParallelUpdate(i, ts, counter);
+            }
+            JobSystem::Wait(counter);
+
+            for (uint32_t i = first; i < end; i++)
+                m_Layers[i]->OnRender();
+            first = end;
+        }
+    }
 }
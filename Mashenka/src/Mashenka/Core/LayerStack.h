@@ -6,15 +6,21 @@
  * rendering in the correct order.
  * The distinction between layers and overlays can be thought of
  * as the difference between background content (layers) and foreground content (overlays).
+ * Update runs the layers as a task graph: runs of layers with a parallel update go to the JobSystem together, a
+ * layer waits only for the earlier layers of its run whose access conflicts with its own. Every other layer is
+ * updated on the main thread in stack order, and the drawing (OnRender) stays in stack order on the main thread.
  */
 #pragma once
 
 #include "Mashenka/Core/Core.h"
 #include "Mashenka/Core/Layer.h"
+#include <atomic>
 #include <vector>
 
 namespace Mashenka
 {
+    class JobCounter;
+
     class LayerStack
     {
     public:
@@ -26,10 +32,23 @@ namespace Mashenka
         void PopLayer(Layer* layer);
         void PopOverlay(Layer* overlay);
 
+        // OnUpdate and OnRender of every layer for one frame, see Layer::SetParallelUpdate
+        void Update(TimeStep ts);
+
         std::vector<Layer*>::iterator begin() {return m_Layers.begin();}
         std::vector<Layer*>::iterator end() {return  m_Layers.end();}
+    private:
+        void BuildUpdateGraph();
+        void RunParallelUpdate(uint32_t index, TimeStep ts, JobCounter& counter);
+
     private:
         std::vector<Layer*> m_Layers;
         unsigned int m_LayerInsertIndex = 0; //using an index instead of iterator
+
+        // The update graph, one entry per layer, rebuilt after the stack changed
+        bool m_UpdateGraphDirty = true;
+        std::vector<std::vector<uint32_t>> m_UpdateSuccessors; // the layers waiting for this one
+        std::vector<uint32_t> m_UpdateDependencyCounts;
+        std::vector<std::atomic<uint32_t>> m_UpdateDependenciesLeft; // counts down during Update
     };
 }
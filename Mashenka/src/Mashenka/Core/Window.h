@@ -13,11 +13,13 @@ namespace Mashenka
         std::string Title;
         unsigned int Width;
         unsigned int Height;
+        bool Visible; // hidden windows still get a context, for headless tools that render offscreen
 
         WindowProps(const std::string& title = "Mashenka Engine",
             unsigned int width = 1280,
-            unsigned int height = 720)
-                :Title(title), Width(width), Height(height)
+            unsigned int height = 720,
+            bool visible = true)
+                :Title(title), Width(width), Height(height), Visible(visible)
         {
             
         }
@@ -38,6 +40,8 @@ namespace Mashenka
          *and you cannot create instances of it directly.*/
         virtual ~Window() = default;
         virtual void OnUpdate() = 0;
+        // Blocks until an event arrives or the timeout ran out, then handles the events, nothing is presented
+        virtual void WaitEvents(float timeoutSeconds) = 0;
         virtual unsigned int GetWidth() const = 0;
         virtual unsigned int GetHeight() const = 0;
 
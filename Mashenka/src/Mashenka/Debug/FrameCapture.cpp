@@ -0,0 +1,308 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Debug/FrameCapture.h"
+#include "Mashenka/Renderer/FrameReadback.h"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace Mashenka
+{
+    // Frames waiting for a worker, the pixels are BGRA8 bottom row first
+    struct EncodeJob
+    {
+        std::string Path;
+        uint32_t Width = 0, Height = 0;
+        std::vector<uint8_t> Pixels;
+    };
+
+    struct FrameCaptureStorage
+    {
+        static const uint32_t ReadbackBuffers = 3; // frames the readback runs behind
+        static const uint32_t MaxQueuedEncodes = 8; // 8 MB each at 1080p
+        static const uint32_t WorkerCount = 2; // one 1080p frame takes a worker a few milliseconds
+
+        Scope<FrameReadback> Readback;
+        // one per pending readback, in the same order. Empty for a recorded frame, those are numbered once their
+        // encode is queued, so dropped frames leave no gaps in the file names
+        std::deque<std::string> PendingPaths;
+
+        std::string ScreenshotPath;
+        bool Recording = false;
+        std::string RecordingDirectory;
+        uint32_t RecordingFrame = 0;
+
+        // shared with the workers
+        std::mutex Mutex;
+        std::condition_variable JobAvailable;
+        std::deque<EncodeJob> Jobs;
+        std::vector<std::vector<uint8_t>> FreePixelBuffers; // recycled, a 1080p frame is 8 MB
+        uint32_t BusyWorkers = 0;
+        bool Stopping = false;
+        std::vector<std::thread> Workers;
+
+        FrameCapture::Statistics Stats;
+    };
+
+    static FrameCaptureStorage* s_Data;
+
+    // Uncompressed TGA files of a 1080p frame are 6 MB, run length encoding shrinks flat UI and clear colors a lot
+    // Alpha of the window is meaningless, the image is written as 24 bit
+    static bool WriteTGA(const EncodeJob& job)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        std::vector<uint8_t> data;
+        data.reserve(static_cast<size_t>(job.Width) * job.Height * 3 / 2);
+
+        const uint8_t header[18] = {
+            0, // no image id
+            0, // no color map
+            10, // run length encoded true color
+            0, 0, 0, 0, 0, // color map specification
+            0, 0, 0, 0, // origin
+            static_cast<uint8_t>(job.Width & 0xFF), static_cast<uint8_t>(job.Width >> 8),
+            static_cast<uint8_t>(job.Height & 0xFF), static_cast<uint8_t>(job.Height >> 8),
+            24, // bits per pixel
+            0 // bottom left origin, the rows are already in that order
+        };
+        data.insert(data.end(), header, header + sizeof(header));
+
+        auto samePixel = [](const uint8_t* a, const uint8_t* b)
+        {
+            return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+        };
+
+        // packets never cross a row
+        for (uint32_t y = 0; y < job.Height; y++)
+        {
+            const uint8_t* row = job.Pixels.data() + static_cast<size_t>(y) * job.Width * 4;
+            uint32_t x = 0;
+            while (x < job.Width)
+            {
+                uint32_t run = 1;
+                while (x + run < job.Width && run < 128 && samePixel(row + (x + run) * 4, row + x * 4))
+                    run++;
+
+                if (run > 1)
+                {
+                    const uint8_t* pixel = row + x * 4;
+                    data.push_back(static_cast<uint8_t>(0x80 | (run - 1)));
+                    data.insert(data.end(), pixel, pixel + 3);
+                    x += run;
+                    continue;
+                }
+
+                // raw packet up to the next run of at least two
+                uint32_t count = 1;
+                while (x + count < job.Width && count < 128 &&
+                    !(x + count + 1 < job.Width && samePixel(row + (x + count) * 4, row + (x + count + 1) * 4)))
+                    count++;
+
+                data.push_back(static_cast<uint8_t>(count - 1));
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    const uint8_t* pixel = row + (x + i) * 4;
+                    data.insert(data.end(), pixel, pixel + 3);
+                }
+                x += count;
+            }
+        }
+
+        std::ofstream file(job.Path, std::ios::binary);
+        if (!file)
+        {
+            MK_CORE_ERROR("FrameCapture: could not open '{0}'", job.Path);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        return true;
+    }
+
+    static void WorkerLoop()
+    {
+        while (true)
+        {
+            EncodeJob job;
+            {
+                std::unique_lock<std::mutex> lock(s_Data->Mutex);
+                s_Data->JobAvailable.wait(lock, [] { return s_Data->Stopping || !s_Data->Jobs.empty(); });
+                if (s_Data->Jobs.empty())
+                    return; // stopping and nothing left to write
+                job = std::move(s_Data->Jobs.front());
+                s_Data->Jobs.pop_front();
+                s_Data->BusyWorkers++;
+            }
+
+            bool written = WriteTGA(job);
+
+            {
+                std::lock_guard<std::mutex> lock(s_Data->Mutex);
+                s_Data->BusyWorkers--;
+                if (written)
+                    s_Data->Stats.FramesWritten++;
+                s_Data->FreePixelBuffers.push_back(std::move(job.Pixels));
+            }
+        }
+    }
+
+    // Hand the readbacks the GPU has finished to the workers
+    static void CollectReadbacks()
+    {
+        while (s_Data->Readback->GetPendingCount() > 0)
+        {
+            std::vector<uint8_t> pixels;
+            {
+                std::lock_guard<std::mutex> lock(s_Data->Mutex);
+                if (!s_Data->FreePixelBuffers.empty())
+                {
+                    pixels = std::move(s_Data->FreePixelBuffers.back());
+                    s_Data->FreePixelBuffers.pop_back();
+                }
+            }
+
+            EncodeJob job;
+            FrameReadback::PollResult result = s_Data->Readback->Poll(pixels, job.Width, job.Height);
+            if (result == FrameReadback::PollResult::NotReady)
+            {
+                // not done yet, keep the buffer for later
+                std::lock_guard<std::mutex> lock(s_Data->Mutex);
+                s_Data->FreePixelBuffers.push_back(std::move(pixels));
+                return;
+            }
+            job.Path = std::move(s_Data->PendingPaths.front());
+            s_Data->PendingPaths.pop_front();
+            job.Pixels = std::move(pixels);
+
+            {
+                std::lock_guard<std::mutex> lock(s_Data->Mutex);
+                // a failed readback, or the disk can't keep up and we rather lose a frame than stall the game
+                if (result == FrameReadback::PollResult::Failed ||
+                    s_Data->Jobs.size() >= FrameCaptureStorage::MaxQueuedEncodes)
+                {
+                    s_Data->Stats.FramesDropped++;
+                    s_Data->FreePixelBuffers.push_back(std::move(job.Pixels));
+                    continue;
+                }
+                if (job.Path.empty())
+                {
+                    char name[32];
+                    std::snprintf(name, sizeof(name), "frame_%05u.tga", s_Data->RecordingFrame++);
+                    job.Path = (std::filesystem::path(s_Data->RecordingDirectory) / name).string();
+                }
+                s_Data->Jobs.push_back(std::move(job));
+            }
+            s_Data->JobAvailable.notify_one();
+        }
+    }
+
+    void FrameCapture::Init()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        s_Data = new FrameCaptureStorage();
+        s_Data->Readback = FrameReadback::Create(FrameCaptureStorage::ReadbackBuffers);
+        for (uint32_t i = 0; i < FrameCaptureStorage::WorkerCount; i++)
+            s_Data->Workers.emplace_back(WorkerLoop);
+    }
+
+    void FrameCapture::Shutdown()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // give the GPU a moment to finish the last frames, a screenshot right before closing should still be saved
+        for (int attempt = 0; attempt < 1000 && s_Data->Readback->GetPendingCount() > 0; attempt++)
+        {
+            CollectReadbacks();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (s_Data->Readback->GetPendingCount() > 0)
+            MK_CORE_WARN("FrameCapture: {0} frames were still on the GPU", s_Data->Readback->GetPendingCount());
+
+        // the workers finish the queue before they leave
+        {
+            std::lock_guard<std::mutex> lock(s_Data->Mutex);
+            s_Data->Stopping = true;
+        }
+        s_Data->JobAvailable.notify_all();
+        for (auto& worker : s_Data->Workers)
+            worker.join();
+
+        delete s_Data;
+        s_Data = nullptr;
+    }
+
+    void FrameCapture::Screenshot(const std::string& path)
+    {
+        s_Data->ScreenshotPath = path;
+    }
+
+    void FrameCapture::StartRecording(const std::string& directory)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error)
+        {
+            MK_CORE_ERROR("FrameCapture: could not create '{0}': {1}", directory, error.message());
+            return;
+        }
+
+        s_Data->RecordingDirectory = directory;
+        s_Data->RecordingFrame = 0;
+        s_Data->Recording = true;
+        MK_CORE_INFO("FrameCapture: recording to '{0}'", directory);
+    }
+
+    void FrameCapture::StopRecording()
+    {
+        if (s_Data->Recording)
+            MK_CORE_INFO("FrameCapture: recorded {0} frames", s_Data->RecordingFrame);
+        s_Data->Recording = false;
+    }
+
+    bool FrameCapture::IsRecording()
+    {
+        return s_Data->Recording;
+    }
+
+    FrameCapture::Statistics FrameCapture::GetStats()
+    {
+        std::lock_guard<std::mutex> lock(s_Data->Mutex);
+        Statistics stats = s_Data->Stats;
+        stats.PendingReadbacks = s_Data->Readback->GetPendingCount();
+        stats.QueuedEncodes = static_cast<uint32_t>(s_Data->Jobs.size()) + s_Data->BusyWorkers;
+        return stats;
+    }
+
+    void FrameCapture::EndFrame(uint32_t width, uint32_t height)
+    {
+        if (!s_Data)
+            return;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        CollectReadbacks();
+
+        if (s_Data->ScreenshotPath.empty() && !s_Data->Recording)
+            return;
+        if (width == 0 || height == 0)
+            return;
+
+        // a recorded frame gets its name when its encode is queued, see CollectReadbacks
+        std::string path;
+        if (!s_Data->ScreenshotPath.empty())
+        {
+            path = std::move(s_Data->ScreenshotPath);
+            s_Data->ScreenshotPath.clear();
+        }
+
+        if (!s_Data->Readback->Request(width, height))
+        {
+            std::lock_guard<std::mutex> lock(s_Data->Mutex);
+            s_Data->Stats.FramesDropped++;
+            return;
+        }
+        s_Data->PendingPaths.push_back(std::move(path));
+        std::lock_guard<std::mutex> lock(s_Data->Mutex);
+        s_Data->Stats.FramesCaptured++;
+    }
+}
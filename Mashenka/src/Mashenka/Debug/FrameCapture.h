@@ -0,0 +1,47 @@
+﻿#pragma once
+
+/*
+ * SUMMARY:
+ * Screenshots and continuous capture of the window, for QA recordings
+ *
+ * HOW IT WORKS:
+ * At the end of a captured frame the back buffer is copied into a pixel pack buffer, which doesn't stall the GPU
+ * A few frames later, once the copy is done, the pixels are handed to worker threads that write them as
+ * RLE compressed TGA files. The main thread never waits: when every buffer or the encoder queue is full,
+ * the frame is dropped and counted in the statistics
+ * A recording is an image sequence (frame_00000.tga, ...), e.g. ffmpeg -i frame_%05d.tga turns it into a video
+ */
+
+namespace Mashenka
+{
+    class FrameCapture
+    {
+    public:
+        struct Statistics
+        {
+            uint32_t FramesCaptured = 0; // readbacks started
+            uint32_t FramesWritten = 0;
+            uint32_t FramesDropped = 0; // no free readback buffer or the encoder queue was full
+            uint32_t PendingReadbacks = 0;
+            uint32_t QueuedEncodes = 0;
+        };
+
+    public:
+        static void Init();
+        // Writes out everything that was captured so far
+        static void Shutdown();
+
+        // The frame that is being rendered is saved to path once it reaches the GPU, the extension should be .tga
+        static void Screenshot(const std::string& path);
+
+        // Captures every frame until StopRecording, into numbered files in directory
+        static void StartRecording(const std::string& directory);
+        static void StopRecording();
+        static bool IsRecording();
+
+        static Statistics GetStats();
+
+        // Called by the application once the frame is rendered, before it is presented
+        static void EndFrame(uint32_t width, uint32_t height);
+    };
+}
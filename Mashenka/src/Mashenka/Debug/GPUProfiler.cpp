@@ -0,0 +1,117 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Debug/GPUProfiler.h"
+#include "Mashenka/Renderer/GPUTimerQueryPool.h"
+
+#include <deque>
+
+namespace Mashenka
+{
+    // A scope whose queries are still on their way through the GPU
+    struct GPUSpan
+    {
+        const char* Name;
+        uint32_t BeginQuery;
+        uint32_t EndQuery;
+    };
+
+    struct GPUProfilerStorage
+    {
+        static const uint32_t MaxQueries = 1024; // two per span, enough for a few frames in flight
+        static const uint32_t CalibrationInterval = 120; // frames, the GPU clock drifts slowly
+
+        Scope<GPUTimerQueryPool> Queries;
+        std::deque<GPUSpan> PendingSpans; // in submission order, so the oldest finishes first
+
+        // a GPU timestamp and the CPU time taken at the same moment
+        uint64_t CalibrationGPUTime = 0;
+        FloatingMicroseconds CalibrationCPUTime{0.0};
+        uint64_t FrameIndex = 0;
+        bool PoolExhaustedWarned = false;
+    };
+
+    static GPUProfilerStorage* s_Data;
+
+    static void Calibrate()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        s_Data->CalibrationGPUTime = s_Data->Queries->GetCurrentTimestamp();
+        s_Data->CalibrationCPUTime = FloatingMicroseconds(std::chrono::steady_clock::now().time_since_epoch());
+    }
+
+    void GPUProfiler::Init()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        s_Data = new GPUProfilerStorage();
+        s_Data->Queries = GPUTimerQueryPool::Create(GPUProfilerStorage::MaxQueries);
+        Calibrate();
+    }
+
+    void GPUProfiler::Shutdown()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // unfinished spans are dropped with the pool
+        delete s_Data;
+        s_Data = nullptr;
+    }
+
+    void GPUProfiler::BeginFrame()
+    {
+        if (!s_Data)
+            return;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (++s_Data->FrameIndex % GPUProfilerStorage::CalibrationInterval == 0)
+            Calibrate();
+
+        GPUTimerQueryPool& queries = *s_Data->Queries;
+        while (!s_Data->PendingSpans.empty())
+        {
+            const GPUSpan& span = s_Data->PendingSpans.front();
+            // the GPU has not got that far yet, the rest is even newer
+            if (!queries.IsAvailable(span.EndQuery) || !queries.IsAvailable(span.BeginQuery))
+                break;
+
+            uint64_t begin = queries.GetTimestamp(span.BeginQuery);
+            uint64_t end = queries.GetTimestamp(span.EndQuery);
+            // nanoseconds relative to the calibration, can be negative for spans recorded before it
+            auto sinceCalibration = static_cast<int64_t>(begin - s_Data->CalibrationGPUTime);
+            FloatingMicroseconds start = s_Data->CalibrationCPUTime + FloatingMicroseconds(sinceCalibration / 1000.0);
+            FloatingMicroseconds elapsed(static_cast<double>(end - begin) / 1000.0);
+            Instrumentor::Get().WriteGPUProfile(span.Name, start, elapsed);
+
+            queries.Release(span.BeginQuery);
+            queries.Release(span.EndQuery);
+            s_Data->PendingSpans.pop_front();
+        }
+    }
+
+    uint32_t GPUProfiler::BeginScope()
+    {
+        // no point in timing what nobody records
+        if (!s_Data || !Instrumentor::Get().IsSessionActive())
+            return GPUTimerQueryPool::InvalidQuery;
+
+        uint32_t query = s_Data->Queries->WriteTimestamp();
+        if (query == GPUTimerQueryPool::InvalidQuery && !s_Data->PoolExhaustedWarned)
+        {
+            MK_CORE_WARN("GPUProfiler: all {0} timer queries are in flight, GPU scopes are skipped",
+                         GPUProfilerStorage::MaxQueries);
+            s_Data->PoolExhaustedWarned = true;
+        }
+        return query;
+    }
+
+    void GPUProfiler::EndScope(const char* name, uint32_t beginQuery)
+    {
+        if (beginQuery == GPUTimerQueryPool::InvalidQuery || !s_Data)
+            return;
+
+        uint32_t endQuery = s_Data->Queries->WriteTimestamp();
+        if (endQuery == GPUTimerQueryPool::InvalidQuery)
+        {
+            s_Data->Queries->Release(beginQuery);
+            return;
+        }
+        s_Data->PendingSpans.push_back({name, beginQuery, endQuery});
+    }
+}
@@ -0,0 +1,53 @@
+﻿#pragma once
+
+/*
+ * SUMMARY:
+ * GPU counterpart of the InstrumentorTimer, MK_PROFILE_GPU_SCOPE measures how long the GPU took for the commands
+ * issued inside the scope
+ *
+ * HOW IT WORKS:
+ * A timestamp query is written into the command stream when the scope begins and one when it ends
+ * The results are only read in GPUProfiler::BeginFrame once the GPU finished them, usually a few frames later,
+ * so the CPU never waits. The spans are converted to the CPU clock and written to the trace as the "GPU" track
+ */
+
+namespace Mashenka
+{
+    class GPUProfiler
+    {
+    public:
+        static void Init();
+        static void Shutdown();
+
+        // Reads back the spans the GPU has finished and writes them to the trace, called once per frame
+        static void BeginFrame();
+
+        // used by GPUProfileTimer, BeginScope returns the query to hand to EndScope
+        static uint32_t BeginScope();
+        static void EndScope(const char* name, uint32_t beginQuery);
+    };
+
+    class GPUProfileTimer
+    {
+    public:
+        GPUProfileTimer(const char* name)
+            : m_Name(name), m_BeginQuery(GPUProfiler::BeginScope())
+        {
+        }
+
+        ~GPUProfileTimer()
+        {
+            GPUProfiler::EndScope(m_Name, m_BeginQuery);
+        }
+
+    private:
+        const char* m_Name;
+        uint32_t m_BeginQuery;
+    };
+}
+
+#if MK_PROFILE
+#define MK_PROFILE_GPU_SCOPE(name) ::Mashenka::GPUProfileTimer gpuTimer##__LINE__(name);
+#else
+    #define MK_PROFILE_GPU_SCOPE(name)
+#endif
@@ -5,6 +5,9 @@
 #include <algorithm> // this is the algorithm library, which includes functions: sort, max, min, etc
 #include <fstream> // file stream
 #include <iomanip>
+#include <atomic>
+#include <mutex>
+#include <sstream>
 
 #include <thread>
 
@@ -46,8 +49,12 @@ namespace Mashenka
         // here the profiling session is not tied to the lifetime of any object, thus a raw prt is used
         std::mutex m_Mutex;
         InstrumentationSession* m_CurrentSession;
+        // read without the lock, so scopes outside of a session cost two clock reads and nothing else, even when
+        // many threads run them
+        std::atomic<bool> m_SessionActive{false};
 
         std::ofstream m_OutputStream;
+        static constexpr int s_GPUProcessID = 1; // the CPU spans use process 0
         // this is the output stream, used for writing to file
         // std::ofstream is a class to write on files, from the fstream library in C++
 
@@ -79,6 +86,7 @@ namespace Mashenka
             {
                 m_CurrentSession = new InstrumentationSession({name});
                 WriteHeader();
+                m_SessionActive = true;
             }
             else
             {
@@ -97,6 +105,9 @@ namespace Mashenka
 
         void WriteProfile(const ProfileResult& result)
         {
+            if (!m_SessionActive.load(std::memory_order_relaxed))
+                return;
+
             std::stringstream json; // this is the json stream
             std::string name = result.Name;
             std::replace(name.begin(), name.end(), '"', '\'');
@@ -113,13 +124,36 @@ namespace Mashenka
             json << "\"ts\":" << result.Start.count();
             json << "}";
 
+            WriteEvent(json.str());
+        }
 
-            std::lock_guard lock(m_Mutex);
-            if (m_CurrentSession)
-            {
-                m_OutputStream << json.str(); // write the json to the output stream
-                m_OutputStream.flush();
-            }
+        // GPU spans go to their own "GPU" track, the start is already converted to the CPU clock
+        void WriteGPUProfile(const std::string& name, FloatingMicroseconds start, FloatingMicroseconds elapsedTime)
+        {
+            if (!m_SessionActive.load(std::memory_order_relaxed))
+                return;
+
+            std::stringstream json;
+            std::string escapedName = name;
+            std::replace(escapedName.begin(), escapedName.end(), '"', '\'');
+
+            json << std::setprecision(3) << std::fixed;
+            json << ",{";
+            json << "\"cat\":\"gpu\",";
+            json << "\"dur\":" << elapsedTime.count() << ',';
+            json << "\"name\":\"" << escapedName << "\",";
+            json << "\"ph\":\"X\",";
+            json << "\"pid\":" << s_GPUProcessID << ",";
+            json << "\"tid\":0,";
+            json << "\"ts\":" << start.count();
+            json << "}";
+
+            WriteEvent(json.str());
+        }
+
+        bool IsSessionActive()
+        {
+            return m_SessionActive;
         }
 
         // this is the Get function, used to get the instance of the instrumentor
@@ -131,9 +165,22 @@ namespace Mashenka
         }
 
     private:
+        void WriteEvent(const std::string& event)
+        {
+            std::lock_guard lock(m_Mutex);
+            if (m_CurrentSession)
+            {
+                m_OutputStream << event; // write the json to the output stream
+                m_OutputStream.flush();
+            }
+        }
+
         void WriteHeader()
         {
             m_OutputStream << "{\"otherData\": {},\"traceEvents\":[{}";
+            // name the process of the GPU spans, so the viewer shows them as a separate track
+            m_OutputStream << ",{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << s_GPUProcessID
+                << ",\"args\":{\"name\":\"GPU\"}}";
             m_OutputStream.flush();
         }
 
@@ -149,6 +196,7 @@ namespace Mashenka
         {
             if (m_CurrentSession)
             {
+                m_SessionActive = false;
                 WriteFooter();
                 m_OutputStream.close();
                 delete m_CurrentSession;
@@ -37,6 +37,24 @@ namespace Mashenka
         EVENT_CLASS_CATEGORY(EventCategoryApplication)
     };
 
+    class WindowFocusEvent : public Event
+    {
+    public:
+        WindowFocusEvent() = default;
+
+        EVENT_CLASS_TYPE(WindowFocus)
+        EVENT_CLASS_CATEGORY(EventCategoryApplication)
+    };
+
+    class WindowLostFocusEvent : public Event
+    {
+    public:
+        WindowLostFocusEvent() = default;
+
+        EVENT_CLASS_TYPE(WindowLostFocus)
+        EVENT_CLASS_CATEGORY(EventCategoryApplication)
+    };
+
     class AppTickEvent : public Event
     {
     public:
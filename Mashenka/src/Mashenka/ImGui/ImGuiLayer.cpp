@@ -1,6 +1,8 @@
 ﻿#include "mkpch.h"
 #include "Mashenka/ImGui/ImGuiLayer.h"
 #include "Mashenka/Core/Application.h"
+#include "Mashenka/Renderer/RendererStats.h"
+#include "Mashenka/Debug/GPUProfiler.h"
 
 // Include the imgui header file
 #include <imgui.h>
@@ -92,7 +94,10 @@ namespace Mashenka
 
         // Rendering
         ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            MK_PROFILE_GPU_SCOPE("ImGui");
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
 
         // if multi viewport enabled
         if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
@@ -114,6 +119,27 @@ namespace Mashenka
     {
         static bool show = false;
         // ImGui::ShowDemoWindow(&show);
+
+        if (m_ShowRendererStats)
+        {
+            const RendererStats::Statistics& stats = RendererStats::GetStats();
+            ImGui::Begin("Renderer Stats", &m_ShowRendererStats);
+            ImGui::Text("Draw calls: %u", stats.DrawCalls);
+            ImGui::Text("Quads: %u (culled %u)", stats.QuadCount, stats.CulledQuadCount);
+            ImGui::Text("Vertices: %u", stats.VertexCount);
+            ImGui::Text("Indices: %u", stats.IndexCount);
+            ImGui::Text("Texture binds: %u", stats.TextureBinds);
+            ImGui::Text("Shader binds: %u", stats.ShaderBinds);
+            ImGui::Text("Buffer uploads: %.1f KB", static_cast<double>(stats.BufferBytesUploaded) / 1024.0);
+            ImGui::Separator();
+            ImGui::Text("Batches flushed: %u", stats.BatchesFlushed);
+            for (size_t i = 0; i < stats.FlushReasons.size(); i++)
+            {
+                auto reason = static_cast<RendererStats::FlushReason>(i);
+                ImGui::Text("  %s: %u", RendererStats::GetFlushReasonName(reason), stats.FlushReasons[i]);
+            }
+            ImGui::End();
+        }
     }
 
 
@@ -17,9 +17,14 @@ namespace Mashenka
         void Begin();
         void End();
 
+        // Optional panel with the RendererStats of the frame
+        void SetShowRendererStats(bool show) { m_ShowRendererStats = show; }
+        bool IsShowingRendererStats() const { return m_ShowRendererStats; }
+
     private:
         // float m_Time = 0.0f;
-        
+        bool m_ShowRendererStats = false;
+
     };
 }
 
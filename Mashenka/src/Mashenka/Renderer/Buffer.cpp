@@ -24,6 +24,19 @@ namespace Mashenka
         return nullptr;
     }
 
+    Ref<VertexBuffer> VertexBuffer::Create(uint32_t size)
+    {
+        switch (RendererAPI::GetAPI())
+        {
+        case RendererAPI::API::None:
+            MK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!")
+            return nullptr;
+        case RendererAPI::API::OpenGL:
+            return CreateRef<OpenGLVertexBuffer>(size);
+        }
+        return nullptr;
+    }
+
     Ref<IndexBuffer> Mashenka::IndexBuffer::Create(uint32_t* indices, uint32_t count)
     {
         // Factory Method for different renderer API
@@ -37,6 +50,32 @@ namespace Mashenka
         }
         return nullptr;
     }
+
+    Ref<IndexBuffer> IndexBuffer::Create(uint32_t count)
+    {
+        switch (RendererAPI::GetAPI())
+        {
+        case RendererAPI::API::None:
+            MK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!")
+            return nullptr;
+        case RendererAPI::API::OpenGL:
+            return CreateRef<OpenGLIndexBuffer>(count);
+        }
+        return nullptr;
+    }
+
+    Ref<StorageBuffer> StorageBuffer::Create(uint32_t size, const void* data)
+    {
+        switch (RendererAPI::GetAPI())
+        {
+        case RendererAPI::API::None:
+            MK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!")
+            return nullptr;
+        case RendererAPI::API::OpenGL:
+            return CreateRef<OpenGLStorageBuffer>(size, data);
+        }
+        return nullptr;
+    }
 }
 
 
@@ -19,7 +19,8 @@ namespace Mashenka
         Int2,
         Int3,
         Int4,
-        Bool
+        Bool,
+        UByte4 // 4 bytes, normalized it is a packed RGBA8 color
     };
 
     // get the size of the shader data type
@@ -38,6 +39,7 @@ namespace Mashenka
         case ShaderDataType::Int4: return 4 * 4;
         case ShaderDataType::Mat3: return 4 * 3 * 3;
         case ShaderDataType::Mat4: return 4 * 4 * 4;
+        case ShaderDataType::UByte4: return 4;
         case ShaderDataType::None: return 0;
         }
 
@@ -83,6 +85,7 @@ namespace Mashenka
             case ShaderDataType::Int3: return 3;
             case ShaderDataType::Int4: return 4;
             case ShaderDataType::Bool: return 1;
+            case ShaderDataType::UByte4: return 4;
             case ShaderDataType::None: break;
             }
 
@@ -101,9 +104,9 @@ namespace Mashenka
         // constructor, destructor and default constructor, the default constructor is used to create an empty buffer layout
         BufferLayout() = default;
 
-        // constructor
-        BufferLayout(const std::initializer_list<BufferElement>& elements)
-            : m_Elements(elements)
+        // constructor, a per instance layout advances once per instance instead of once per vertex
+        BufferLayout(const std::initializer_list<BufferElement>& elements, bool perInstance = false)
+            : m_Elements(elements), m_PerInstance(perInstance)
         {
             CalculateOffsetAndStride();
         }
@@ -111,6 +114,7 @@ namespace Mashenka
         // get stride and elements
         // stride is the size of the buffer, the elements are stored in the buffer one by one.
         inline uint32_t GetStride() const { return m_Stride; }
+        inline bool IsPerInstance() const { return m_PerInstance; }
 
         // elements is the list of elements
         inline const std::vector<BufferElement>& GetElements() const { return m_Elements; }
@@ -140,6 +144,7 @@ namespace Mashenka
     private:
         std::vector<BufferElement> m_Elements;
         uint32_t m_Stride = 0;
+        bool m_PerInstance = false;
     };
 
     // base vertex buffer class
@@ -162,9 +167,14 @@ namespace Mashenka
         virtual const BufferLayout& GetLayout() const = 0;
         virtual void SetLayout(const BufferLayout& layout) = 0;
 
+        // replace part of a dynamic buffer, size and offset are in bytes
+        virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+
         // create a new vertex buffer
         // the size is the size of the vertices
         static Ref<VertexBuffer> Create(float* vertices, uint32_t size);
+        // create an empty dynamic vertex buffer of size bytes, filled with SetData
+        static Ref<VertexBuffer> Create(uint32_t size);
     };
 
     // base index buffer class
@@ -180,6 +190,9 @@ namespace Mashenka
         // get the count of indices
         virtual uint32_t GetCount() const = 0;
 
+        // replace part of a dynamic buffer, count and offset are in indices
+        virtual void SetData(const uint32_t* indices, uint32_t count, uint32_t offset = 0) = 0;
+
         // create a new index buffer
         // the count is the number of indices
         // the indices is the array of indices
@@ -189,5 +202,35 @@ namespace Mashenka
         // so we need to use different functions to create different index buffers
         // this is called a static factory function
         static Ref<IndexBuffer> Create(uint32_t* indices, uint32_t count);
+        // create an empty dynamic index buffer of count indices, filled with SetData
+        static Ref<IndexBuffer> Create(uint32_t count);
+    };
+
+    // One draw of RenderCommand::DrawIndexedIndirect and MultiDrawIndexedIndirect, the layout is given by OpenGL
+    struct DrawIndexedIndirectCommand
+    {
+        uint32_t Count; // indices per instance
+        uint32_t InstanceCount;
+        uint32_t FirstIndex;
+        int32_t BaseVertex; // added to every index
+        uint32_t BaseInstance; // first instance for per instance attributes
+    };
+
+    // base storage buffer class
+    // a buffer shaders can read and write, bound to a binding point: layout(std430, binding = n) buffer
+    // it can also hold the commands of an indirect draw, see RenderCommand::DrawIndexedIndirect
+    class StorageBuffer
+    {
+    public:
+        virtual ~StorageBuffer() = default;
+
+        virtual void Bind(uint32_t binding) const = 0;
+
+        // replace part of the buffer, size and offset are in bytes
+        virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+        virtual uint32_t GetSize() const = 0;
+
+        // create a storage buffer of size bytes, data may be null to leave it uninitialized
+        static Ref<StorageBuffer> Create(uint32_t size, const void* data = nullptr);
     };
 }
@@ -0,0 +1,22 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/ComputeShader.h"
+#include "Mashenka/Renderer/Renderer.h"
+#include "Platform/OpenGL/OpenGLComputeShader.h"
+
+namespace Mashenka
+{
+    Ref<ComputeShader> ComputeShader::Create(const std::string& filepath)
+    {
+        switch (RendererAPI::GetAPI())
+        {
+        case RendererAPI::API::None:
+            MK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!")
+            return nullptr;
+        case RendererAPI::API::OpenGL:
+            return CreateRef<OpenGLComputeShader>(filepath);
+        }
+
+        MK_CORE_ASSERT(false, "Unknown RendererAPI!")
+        return nullptr;
+    }
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+#include <string>
+#include <glm/glm.hpp>
+
+namespace Mashenka
+{
+    /*
+     * ComputeShader Class
+     * A single compute stage loaded from a GLSL file, it works on StorageBuffers bound to its binding points
+     * Unlike Shader there are no variants and no hot reload, the file is the compute source as is
+     */
+    class ComputeShader
+    {
+    public:
+        virtual ~ComputeShader() = default;
+
+        virtual void Bind() const = 0;
+
+        // Uniforms go to this program, it does not have to be bound
+        virtual void SetInt(const std::string& name, int value) = 0;
+        virtual void SetFloat(const std::string& name, float value) = 0;
+        virtual void SetFloat2(const std::string& name, const glm::vec2& value) = 0;
+        virtual void SetFloat4(const std::string& name, const glm::vec4& value) = 0;
+
+        // Runs the work groups, their writes are visible to every later shader, indirect draw and buffer update
+        virtual void Dispatch(uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1) = 0;
+
+        virtual const std::string& GetName() const = 0;
+
+        static Ref<ComputeShader> Create(const std::string& filepath);
+    };
+}
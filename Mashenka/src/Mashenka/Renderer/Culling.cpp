@@ -0,0 +1,115 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/Culling.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define MK_CULLING_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace Mashenka
+{
+    Bounds2D Bounds2D::FromViewProjection(const glm::mat4& viewProjection)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // Bring the corners of clip space back to the world
+        glm::mat4 inverse = glm::inverse(viewProjection);
+        Bounds2D bounds;
+        bounds.Min = glm::vec2(std::numeric_limits<float>::max());
+        bounds.Max = glm::vec2(std::numeric_limits<float>::lowest());
+        for (const glm::vec2& corner : {glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(1.0f, 1.0f),
+                                        glm::vec2(-1.0f, 1.0f)})
+        {
+            glm::vec4 world = inverse * glm::vec4(corner, 0.0f, 1.0f);
+            glm::vec2 point = glm::vec2(world.x, world.y) / world.w;
+            bounds.Min = glm::min(bounds.Min, point);
+            bounds.Max = glm::max(bounds.Max, point);
+        }
+        return bounds;
+    }
+
+    static inline bool IsBoxVisible(const Bounds2D& bounds, float centerX, float centerY, float halfX, float halfY)
+    {
+        return centerX + halfX >= bounds.Min.x && centerX - halfX <= bounds.Max.x &&
+            centerY + halfY >= bounds.Min.y && centerY - halfY <= bounds.Max.y;
+    }
+
+#ifdef MK_CULLING_SSE2
+    // Visibility of 4 boxes as a 4 bit mask
+    static inline int TestBoxesSSE2(const Bounds2D& bounds, __m128 centerX, __m128 centerY, __m128 halfX,
+                                    __m128 halfY)
+    {
+        __m128 visible = _mm_and_ps(
+            _mm_cmpge_ps(_mm_add_ps(centerX, halfX), _mm_set1_ps(bounds.Min.x)),
+            _mm_cmple_ps(_mm_sub_ps(centerX, halfX), _mm_set1_ps(bounds.Max.x)));
+        visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(centerY, halfY), _mm_set1_ps(bounds.Min.y)));
+        visible = _mm_and_ps(visible, _mm_cmple_ps(_mm_sub_ps(centerY, halfY), _mm_set1_ps(bounds.Max.y)));
+        return _mm_movemask_ps(visible);
+    }
+
+    static inline uint32_t WriteMask(int mask, uint8_t* visible)
+    {
+        for (int lane = 0; lane < 4; lane++)
+            visible[lane] = static_cast<uint8_t>((mask >> lane) & 1);
+        return visible[0] + visible[1] + visible[2] + visible[3];
+    }
+#endif
+
+    uint32_t Culling::TestBoxes(const Bounds2D& bounds, const float* centerX, const float* centerY,
+                                const float* halfSizeX, const float* halfSizeY, uint32_t count, uint8_t* visible)
+    {
+        uint32_t visibleCount = 0;
+        uint32_t i = 0;
+#ifdef MK_CULLING_SSE2
+        for (; i + 4 <= count; i += 4)
+        {
+            int mask = TestBoxesSSE2(bounds, _mm_loadu_ps(centerX + i), _mm_loadu_ps(centerY + i),
+                                     _mm_loadu_ps(halfSizeX + i), _mm_loadu_ps(halfSizeY + i));
+            visibleCount += WriteMask(mask, visible + i);
+        }
+#endif
+        for (; i < count; i++)
+        {
+            visible[i] = IsBoxVisible(bounds, centerX[i], centerY[i], halfSizeX[i], halfSizeY[i]);
+            visibleCount += visible[i];
+        }
+        return visibleCount;
+    }
+
+    uint32_t Culling::TestQuads(const Bounds2D& bounds, const QuadKernelInput& quads, uint32_t count,
+                                uint8_t* visible)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        uint32_t visibleCount = 0;
+        uint32_t i = 0;
+#ifdef MK_CULLING_SSE2
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)); // sizes can be negative to flip
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 halfX = _mm_and_ps(_mm_mul_ps(_mm_loadu_ps(quads.SizeX + i), half), absMask);
+            __m128 halfY = _mm_and_ps(_mm_mul_ps(_mm_loadu_ps(quads.SizeY + i), half), absMask);
+
+            // rotated quads use the radius of the circle around them in both directions
+            __m128 radius = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(halfX, halfX), _mm_mul_ps(halfY, halfY)));
+            __m128 rotated = _mm_cmpneq_ps(_mm_loadu_ps(quads.Rotation + i), _mm_setzero_ps());
+            halfX = _mm_or_ps(_mm_and_ps(rotated, radius), _mm_andnot_ps(rotated, halfX));
+            halfY = _mm_or_ps(_mm_and_ps(rotated, radius), _mm_andnot_ps(rotated, halfY));
+
+            int mask = TestBoxesSSE2(bounds, _mm_loadu_ps(quads.PositionX + i), _mm_loadu_ps(quads.PositionY + i),
+                                     halfX, halfY);
+            visibleCount += WriteMask(mask, visible + i);
+        }
+#endif
+        for (; i < count; i++)
+        {
+            float halfX = std::abs(quads.SizeX[i] * 0.5f);
+            float halfY = std::abs(quads.SizeY[i] * 0.5f);
+            if (quads.Rotation[i] != 0.0f)
+                halfX = halfY = std::sqrt(halfX * halfX + halfY * halfY);
+
+            visible[i] = IsBoxVisible(bounds, quads.PositionX[i], quads.PositionY[i], halfX, halfY);
+            visibleCount += visible[i];
+        }
+        return visibleCount;
+    }
+}
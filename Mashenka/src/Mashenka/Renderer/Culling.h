@@ -0,0 +1,38 @@
+﻿#pragma once
+#include "Mashenka/Renderer/QuadKernel.h"
+
+namespace Mashenka
+{
+    // Axis aligned rectangle in world space
+    struct Bounds2D
+    {
+        glm::vec2 Min = glm::vec2(0.0f);
+        glm::vec2 Max = glm::vec2(0.0f);
+
+        bool Intersects(const Bounds2D& other) const
+        {
+            return Max.x >= other.Min.x && Min.x <= other.Max.x && Max.y >= other.Min.y && Min.y <= other.Max.y;
+        }
+
+        // The world space rectangle a camera sees, the view projection is inverted so rotated cameras are covered too
+        static Bounds2D FromViewProjection(const glm::mat4& viewProjection);
+    };
+
+    /*
+     * Culling Class
+     * Tests many boxes against the camera bounds at once, 4 per iteration with SSE2
+     * visible[i] is set to 1 for the boxes that intersect the bounds, 0 otherwise, the functions return how many
+     * are visible. Culling is conservative, a box that touches the bounds is visible
+     */
+    class Culling
+    {
+    public:
+        // Boxes given by their center and half size
+        static uint32_t TestBoxes(const Bounds2D& bounds, const float* centerX, const float* centerY,
+                                  const float* halfSizeX, const float* halfSizeY, uint32_t count, uint8_t* visible);
+
+        // Quads as submitted to Renderer2D, rotated quads are tested with the circle around them to avoid sin/cos
+        static uint32_t TestQuads(const Bounds2D& bounds, const QuadKernelInput& quads, uint32_t count,
+                                  uint8_t* visible);
+    };
+}
@@ -0,0 +1,209 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/DynamicResolution.h"
+#include "Mashenka/Renderer/GPUTimerQueryPool.h"
+#include "Mashenka/Renderer/RenderCommand.h"
+
+#include <deque>
+
+namespace Mashenka
+{
+    struct DynamicResolutionStorage
+    {
+        static const uint32_t MaxQueries = 16; // two per frame, enough for a few frames in flight
+        static const uint32_t AdjustInterval = 30; // frames between two scale changes
+        static constexpr float ScaleStep = 0.05f; // every scale change resizes the framebuffer, keep them coarse
+        static constexpr float Headroom = 0.8f; // grow only while below this fraction of the target
+
+        bool Enabled = false;
+        float TargetFrameTime = 16.6f;
+        float MinScale = 0.5f, MaxScale = 1.0f;
+        float Scale = 1.0f;
+        float GPUFrameTime = 0.0f;
+
+        uint32_t WindowWidth = 0, WindowHeight = 0;
+        Ref<Framebuffer> SceneFramebuffer;
+
+        Scope<GPUTimerQueryPool> Queries;
+        std::deque<std::pair<uint32_t, uint32_t>> PendingFrames; // begin and end query, oldest first
+        uint32_t BeginQuery = GPUTimerQueryPool::InvalidQuery;
+        uint32_t FramesSinceAdjust = 0;
+        bool FrameActive = false;
+    };
+
+    static DynamicResolutionStorage* s_Data;
+
+    static uint32_t ScaledSize(uint32_t size)
+    {
+        return std::max(1u, static_cast<uint32_t>(static_cast<float>(size) * s_Data->Scale + 0.5f));
+    }
+
+    void DynamicResolution::Init()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        s_Data = new DynamicResolutionStorage();
+        s_Data->Queries = GPUTimerQueryPool::Create(DynamicResolutionStorage::MaxQueries);
+    }
+
+    void DynamicResolution::Shutdown()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        delete s_Data;
+        s_Data = nullptr;
+    }
+
+    void DynamicResolution::SetEnabled(bool enabled)
+    {
+        // takes effect with the next frame
+        s_Data->Enabled = enabled;
+    }
+
+    bool DynamicResolution::IsEnabled()
+    {
+        return s_Data->Enabled;
+    }
+
+    void DynamicResolution::SetTargetFrameTime(float milliseconds)
+    {
+        s_Data->TargetFrameTime = milliseconds;
+    }
+
+    float DynamicResolution::GetTargetFrameTime()
+    {
+        return s_Data->TargetFrameTime;
+    }
+
+    void DynamicResolution::SetScaleLimits(float minScale, float maxScale)
+    {
+        MK_CORE_ASSERT(minScale > 0.0f && minScale <= maxScale, "Invalid dynamic resolution scale limits!");
+        s_Data->MinScale = minScale;
+        s_Data->MaxScale = maxScale;
+        s_Data->Scale = std::min(std::max(s_Data->Scale, minScale), maxScale);
+    }
+
+    float DynamicResolution::GetScale()
+    {
+        return s_Data->Scale;
+    }
+
+    float DynamicResolution::GetGPUFrameTime()
+    {
+        return s_Data->GPUFrameTime;
+    }
+
+    const Ref<Framebuffer>& DynamicResolution::GetSceneFramebuffer()
+    {
+        return s_Data->SceneFramebuffer;
+    }
+
+    void DynamicResolution::OnWindowResize(uint32_t width, uint32_t height)
+    {
+        s_Data->WindowWidth = width;
+        s_Data->WindowHeight = height;
+    }
+
+    // Read the frames the GPU has finished and smooth their times
+    static void ReadFrameTimes()
+    {
+        GPUTimerQueryPool& queries = *s_Data->Queries;
+        while (!s_Data->PendingFrames.empty())
+        {
+            auto [begin, end] = s_Data->PendingFrames.front();
+            if (!queries.IsAvailable(end) || !queries.IsAvailable(begin))
+                break;
+
+            float milliseconds = static_cast<float>(queries.GetTimestamp(end) - queries.GetTimestamp(begin)) / 1e6f;
+            queries.Release(begin);
+            queries.Release(end);
+            s_Data->PendingFrames.pop_front();
+
+            // exponential moving average, one slow frame should not change the resolution
+            s_Data->GPUFrameTime = s_Data->GPUFrameTime == 0.0f
+                                       ? milliseconds
+                                       : s_Data->GPUFrameTime + 0.1f * (milliseconds - s_Data->GPUFrameTime);
+        }
+    }
+
+    static void AdjustScale()
+    {
+        if (++s_Data->FramesSinceAdjust < DynamicResolutionStorage::AdjustInterval || s_Data->GPUFrameTime == 0.0f)
+            return;
+        s_Data->FramesSinceAdjust = 0;
+
+        // the GPU time goes with the pixel count, so with the square of the scale
+        float target = s_Data->TargetFrameTime;
+        float frameTime = s_Data->GPUFrameTime;
+        float scale = s_Data->Scale;
+        if (frameTime > target)
+            scale *= std::sqrt(target / frameTime);
+        else if (frameTime < target * DynamicResolutionStorage::Headroom)
+            scale += DynamicResolutionStorage::ScaleStep;
+        else
+            return;
+
+        const float step = DynamicResolutionStorage::ScaleStep;
+        scale = std::floor(scale / step + 0.5f) * step;
+        s_Data->Scale = std::min(std::max(scale, s_Data->MinScale), s_Data->MaxScale);
+    }
+
+    void DynamicResolution::BeginFrame()
+    {
+        if (!s_Data)
+            return;
+        if (!s_Data->Enabled)
+        {
+            s_Data->SceneFramebuffer = nullptr; // don't keep the memory around
+            return;
+        }
+        if (s_Data->WindowWidth == 0 || s_Data->WindowHeight == 0)
+            return;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        ReadFrameTimes();
+        AdjustScale();
+
+        const uint32_t width = ScaledSize(s_Data->WindowWidth);
+        const uint32_t height = ScaledSize(s_Data->WindowHeight);
+        if (!s_Data->SceneFramebuffer)
+        {
+            FramebufferSpecification specification;
+            specification.Width = width;
+            specification.Height = height;
+            s_Data->SceneFramebuffer = Framebuffer::Create(specification);
+        }
+        else
+        {
+            s_Data->SceneFramebuffer->Resize(width, height);
+        }
+
+        s_Data->SceneFramebuffer->Bind();
+        s_Data->BeginQuery = s_Data->Queries->WriteTimestamp();
+        s_Data->FrameActive = true;
+    }
+
+    void DynamicResolution::EndFrame()
+    {
+        if (!s_Data || !s_Data->FrameActive)
+            return;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        s_Data->FrameActive = false;
+        uint32_t endQuery = s_Data->Queries->WriteTimestamp();
+        if (s_Data->BeginQuery != GPUTimerQueryPool::InvalidQuery && endQuery != GPUTimerQueryPool::InvalidQuery)
+        {
+            s_Data->PendingFrames.emplace_back(s_Data->BeginQuery, endQuery);
+        }
+        else
+        {
+            // the pool ran dry, the GPU is far behind, skip measuring this frame
+            if (s_Data->BeginQuery != GPUTimerQueryPool::InvalidQuery)
+                s_Data->Queries->Release(s_Data->BeginQuery);
+            if (endQuery != GPUTimerQueryPool::InvalidQuery)
+                s_Data->Queries->Release(endQuery);
+        }
+
+        const Ref<Framebuffer>& scene = s_Data->SceneFramebuffer;
+        scene->Unbind();
+        RenderCommand::SetViewport(0, 0, s_Data->WindowWidth, s_Data->WindowHeight);
+        scene->BlitToScreen(s_Data->WindowWidth, s_Data->WindowHeight);
+    }
+}
@@ -0,0 +1,42 @@
+﻿#pragma once
+#include "Mashenka/Renderer/Framebuffer.h"
+
+namespace Mashenka
+{
+    /*
+     * DynamicResolution Class
+     * While enabled, the scene is rendered into an offscreen framebuffer whose size is a fraction of the window,
+     * then stretched over the window before ImGui draws on top at native resolution
+     * The fraction follows the GPU time of the scene, measured with timestamp queries a few frames late:
+     * over the target it shrinks right away, well under it grows back slowly, so it does not oscillate
+     * Driven by Renderer::BeginFrame and Renderer::EndFrame
+     */
+    class DynamicResolution
+    {
+    public:
+        static void Init();
+        static void Shutdown();
+
+        static void SetEnabled(bool enabled);
+        static bool IsEnabled();
+
+        // GPU milliseconds the scene may take, 16.6 by default
+        static void SetTargetFrameTime(float milliseconds);
+        static float GetTargetFrameTime();
+        // Scale of width and height, the pixel count goes with its square
+        static void SetScaleLimits(float minScale, float maxScale);
+
+        static float GetScale();
+        // smoothed GPU milliseconds of the scene, 0 until the first measurement is back
+        static float GetGPUFrameTime();
+        static const Ref<Framebuffer>& GetSceneFramebuffer();
+
+        // the size the scene is scaled from and stretched back to
+        static void OnWindowResize(uint32_t width, uint32_t height);
+
+        // Binds the scene framebuffer at the current scale
+        static void BeginFrame();
+        // Upscales the scene to the window and leaves the window framebuffer bound
+        static void EndFrame();
+    };
+}
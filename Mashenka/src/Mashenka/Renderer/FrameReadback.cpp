@@ -0,0 +1,20 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/FrameReadback.h"
+#include "Mashenka/Renderer/Renderer.h"
+#include "Platform/OpenGL/OpenGLFrameReadback.h"
+
+namespace Mashenka
+{
+    Scope<FrameReadback> FrameReadback::Create(uint32_t bufferCount)
+    {
+        switch (Renderer::GetAPI())
+        {
+        case RendererAPI::API::None: MK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+            return nullptr;
+        case RendererAPI::API::OpenGL: return CreateScope<OpenGLFrameReadback>(bufferCount);
+        }
+
+        MK_CORE_ASSERT(false, "Unknown RendererAPI!")
+        return nullptr;
+    }
+}
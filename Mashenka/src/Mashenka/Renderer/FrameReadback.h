@@ -0,0 +1,34 @@
+﻿#pragma once
+
+namespace Mashenka
+{
+    /*
+     * FrameReadback Class
+     * Reads pixels back from the GPU without stalling it
+     * Request starts an asynchronous copy of the bound read framebuffer into one of a ring of buffers, Poll hands
+     * out the oldest copy once the GPU is done with it, usually a couple of frames later
+     * Pixels are BGRA8 with the bottom row first, which is what the GPU produces without converting
+     */
+    class FrameReadback
+    {
+    public:
+        enum class PollResult
+        {
+            NotReady, // nothing requested, or the oldest copy is still running
+            Ready, // the oldest request is in pixels
+            Failed // the oldest request could not be read and is dropped, the next Poll moves on to the one after
+        };
+
+    public:
+        virtual ~FrameReadback() = default;
+
+        // Starts copying width x height pixels from the lower left corner, false when every buffer is in flight
+        virtual bool Request(uint32_t width, uint32_t height) = 0;
+        // Non blocking, copies the oldest finished request into pixels
+        virtual PollResult Poll(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) = 0;
+        // Requests that were not handed out by Poll yet
+        virtual uint32_t GetPendingCount() const = 0;
+
+        static Scope<FrameReadback> Create(uint32_t bufferCount = 3);
+    };
+}
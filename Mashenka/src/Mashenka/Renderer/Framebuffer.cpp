@@ -0,0 +1,22 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/Framebuffer.h"
+#include "Mashenka/Renderer/Renderer.h"
+#include "Platform/OpenGL/OpenGLFramebuffer.h"
+
+namespace Mashenka
+{
+    Ref<Framebuffer> Framebuffer::Create(const FramebufferSpecification& specification)
+    {
+        switch (Renderer::GetAPI())
+        {
+        case RendererAPI::API::None:
+            MK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!")
+            return nullptr;
+        case RendererAPI::API::OpenGL:
+            return CreateRef<OpenGLFramebuffer>(specification);
+        }
+
+        MK_CORE_ASSERT(false, "Unknown RendererAPI!")
+        return nullptr;
+    }
+}
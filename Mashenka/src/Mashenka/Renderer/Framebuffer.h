@@ -0,0 +1,39 @@
+﻿#pragma once
+
+namespace Mashenka
+{
+    struct FramebufferSpecification
+    {
+        uint32_t Width = 0, Height = 0;
+        uint32_t Samples = 1; // more than 1 is multisampled, Resolve it into a single sampled framebuffer
+        bool Depth = true; // a depth and stencil attachment next to the color attachment
+    };
+
+    /*
+     * Framebuffer Class
+     * An offscreen render target with an RGBA8 color attachment and an optional depth-stencil attachment
+     * Bind it to render into it instead of the window, then Resolve or BlitToScreen the color attachment
+     */
+    class Framebuffer
+    {
+    public:
+        virtual ~Framebuffer() = default;
+
+        // Binding also sets the viewport to the size of the framebuffer, Unbind goes back to the window
+        virtual void Bind() = 0;
+        virtual void Unbind() = 0;
+
+        // Recreates the attachments, the content is lost
+        virtual void Resize(uint32_t width, uint32_t height) = 0;
+
+        // Copies the color attachment into target, resolving the samples, both must have the same size
+        virtual void Resolve(const Ref<Framebuffer>& target) const = 0;
+        // Stretches the color attachment over the window framebuffer, linear filtering for upscaling
+        virtual void BlitToScreen(uint32_t width, uint32_t height, bool linearFilter = true) const = 0;
+
+        virtual uint32_t GetColorAttachmentRendererID() const = 0;
+        virtual const FramebufferSpecification& GetSpecification() const = 0;
+
+        static Ref<Framebuffer> Create(const FramebufferSpecification& specification);
+    };
+}
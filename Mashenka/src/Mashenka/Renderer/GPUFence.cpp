@@ -0,0 +1,20 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/GPUFence.h"
+#include "Mashenka/Renderer/Renderer.h"
+#include "Platform/OpenGL/OpenGLFence.h"
+
+namespace Mashenka
+{
+    Scope<GPUFence> GPUFence::Create()
+    {
+        switch (Renderer::GetAPI())
+        {
+        case RendererAPI::API::None: MK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+            return nullptr;
+        case RendererAPI::API::OpenGL: return CreateScope<OpenGLFence>();
+        }
+
+        MK_CORE_ASSERT(false, "Unknown RendererAPI!")
+        return nullptr;
+    }
+}
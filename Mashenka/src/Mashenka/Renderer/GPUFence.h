@@ -0,0 +1,21 @@
+﻿#pragma once
+
+namespace Mashenka
+{
+    /*
+     * GPUFence Class
+     * Put into the command stream when created, signaled once the GPU finished every command issued before it
+     */
+    class GPUFence
+    {
+    public:
+        virtual ~GPUFence() = default;
+
+        // Non blocking
+        virtual bool IsSignaled() const = 0;
+        // Blocks until the fence is signaled or the timeout ran out, returns whether it was signaled
+        virtual bool Wait(uint64_t timeoutNanoseconds) const = 0;
+
+        static Scope<GPUFence> Create();
+    };
+}
@@ -0,0 +1,106 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/GPUParticleSystem.h"
+#include "Mashenka/Renderer/RenderCommand.h"
+
+namespace Mashenka
+{
+    // must match the Particle struct of the GPU particle shaders, std430 layout
+    struct GPUParticle
+    {
+        glm::vec2 Position;
+        glm::vec2 Velocity;
+        glm::vec4 Color;
+        glm::vec4 ColorDelta;
+        float Size;
+        float SizeDelta;
+        float Life;
+        float Padding;
+    };
+
+    static_assert(sizeof(GPUParticle) == 64, "GPUParticle must match the std430 layout of the shaders");
+
+    static constexpr uint32_t s_WorkGroupSize = 256; // local_size_x of the compute shaders
+
+    static uint32_t GroupCount(uint32_t threads)
+    {
+        return (threads + s_WorkGroupSize - 1) / s_WorkGroupSize;
+    }
+
+    GPUParticleSystem::GPUParticleSystem(uint32_t maxParticles)
+        : m_MaxParticles(maxParticles)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        m_UpdateShader = ComputeShader::Create("assets/shaders/GPUParticle_Update.glsl");
+        m_EmitShader = ComputeShader::Create("assets/shaders/GPUParticle_Emit.glsl");
+        m_EmitShader->SetInt("u_MaxParticles", static_cast<int>(maxParticles));
+
+        DrawIndexedIndirectCommand command = {6, 0, 0, 0, 0};
+        for (int i = 0; i < 2; i++)
+        {
+            m_ParticleBuffers[i] = StorageBuffer::Create(maxParticles * sizeof(GPUParticle));
+            m_CommandBuffers[i] = StorageBuffer::Create(sizeof(command), &command);
+        }
+
+        m_VertexArray = VertexArray::Create();
+        uint32_t indices[6] = {0, 1, 2, 2, 3, 0};
+        m_VertexArray->SetIndexBuffer(IndexBuffer::Create(indices, 6));
+    }
+
+    void GPUParticleSystem::Emit(const ParticleProps& props, uint32_t count)
+    {
+        if (count > 0)
+            m_EmitQueue.push_back({props, count});
+    }
+
+    void GPUParticleSystem::OnUpdate(TimeStep ts)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        const uint32_t source = m_Current;
+        const uint32_t destination = 1 - m_Current;
+
+        // the live particles are appended, start the destination empty
+        const uint32_t zero = 0;
+        m_CommandBuffers[destination]->SetData(&zero, sizeof(zero), offsetof(DrawIndexedIndirectCommand, InstanceCount));
+
+        m_ParticleBuffers[source]->Bind(0);
+        m_CommandBuffers[source]->Bind(1);
+        m_ParticleBuffers[destination]->Bind(2);
+        m_CommandBuffers[destination]->Bind(3);
+
+        // the live count is only known on the GPU, the threads past it return right away
+        m_UpdateShader->SetFloat("u_DeltaTime", ts.GetSeconds());
+        m_UpdateShader->Dispatch(GroupCount(m_MaxParticles));
+
+        for (const auto& request : m_EmitQueue)
+            EmitParticles(request.Props, request.Count);
+        m_EmitQueue.clear();
+
+        m_Current = destination;
+    }
+
+    void GPUParticleSystem::EmitParticles(const ParticleProps& props, uint32_t count)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        count = std::min(count, m_MaxParticles);
+        m_EmitShader->SetInt("u_Count", static_cast<int>(count));
+        m_EmitShader->SetInt("u_Seed", static_cast<int>(m_Seed++));
+        m_EmitShader->SetFloat2("u_Position", props.Position);
+        m_EmitShader->SetFloat2("u_Velocity", props.Velocity);
+        m_EmitShader->SetFloat2("u_VelocityVariation", props.VelocityVariation);
+        m_EmitShader->SetFloat4("u_ColorBegin", props.ColorBegin);
+        m_EmitShader->SetFloat4("u_ColorEnd", props.ColorEnd);
+        m_EmitShader->SetFloat("u_SizeBegin", props.SizeBegin);
+        m_EmitShader->SetFloat("u_SizeEnd", props.SizeEnd);
+        m_EmitShader->SetFloat("u_SizeVariation", props.SizeVariation);
+        m_EmitShader->SetFloat("u_LifeTime", props.LifeTime);
+        m_EmitShader->Dispatch(GroupCount(count));
+    }
+
+    void GPUParticleSystem::Draw()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        m_ParticleBuffers[m_Current]->Bind(0);
+        m_VertexArray->Bind();
+        RenderCommand::DrawIndexedIndirect(m_VertexArray, m_CommandBuffers[m_Current]);
+    }
+}
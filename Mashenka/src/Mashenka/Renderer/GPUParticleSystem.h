@@ -0,0 +1,59 @@
+﻿#pragma once
+#include "Mashenka/Renderer/ParticleSystem.h"
+#include "Mashenka/Renderer/ComputeShader.h"
+
+namespace Mashenka
+{
+    /*
+     * GPUParticleSystem Class
+     * The GPU backend of ParticleSystem, for effects too large to update and upload from the CPU every frame
+     * Particles live in two storage buffers, every update a compute shader reads one and appends the live
+     * particles to the other, new particles are appended by a second compute shader
+     * The append counter is the instance count of an indirect draw command, so the particles are drawn without
+     * the CPU ever knowing how many are alive. Needs OpenGL 4.5 for the compute shaders
+     */
+    class GPUParticleSystem
+    {
+    public:
+        GPUParticleSystem(uint32_t maxParticles = 1000000);
+
+        // queued until the next OnUpdate, particles that do not fit into the pool are dropped
+        void Emit(const ParticleProps& props, uint32_t count = 1);
+        void OnUpdate(TimeStep ts);
+
+        uint32_t GetMaxParticles() const { return m_MaxParticles; }
+
+        // all particles of the system are drawn at this depth
+        void SetDepth(float depth) { m_Depth = depth; }
+        float GetDepth() const { return m_Depth; }
+
+        // Draws the live particles with the bound GPU particle shader, the count comes from the GPU
+        void Draw();
+
+    private:
+        void EmitParticles(const ParticleProps& props, uint32_t count);
+
+    private:
+        struct EmitRequest
+        {
+            ParticleProps Props;
+            uint32_t Count;
+        };
+
+        uint32_t m_MaxParticles;
+        float m_Depth = 0.0f;
+        uint32_t m_Seed = 0;
+        std::vector<EmitRequest> m_EmitQueue;
+
+        Ref<ComputeShader> m_UpdateShader;
+        Ref<ComputeShader> m_EmitShader;
+
+        // ping-pong, the current buffers hold the particles to draw
+        Ref<StorageBuffer> m_ParticleBuffers[2];
+        Ref<StorageBuffer> m_CommandBuffers[2];
+        uint32_t m_Current = 0;
+
+        // only the index buffer, the vertex shader reads the particles and builds the corners
+        Ref<VertexArray> m_VertexArray;
+    };
+}
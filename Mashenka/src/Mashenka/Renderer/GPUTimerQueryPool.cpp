@@ -0,0 +1,20 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/GPUTimerQueryPool.h"
+#include "Mashenka/Renderer/Renderer.h"
+#include "Platform/OpenGL/OpenGLTimerQueryPool.h"
+
+namespace Mashenka
+{
+    Scope<GPUTimerQueryPool> GPUTimerQueryPool::Create(uint32_t capacity)
+    {
+        switch (Renderer::GetAPI())
+        {
+        case RendererAPI::API::None: MK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+            return nullptr;
+        case RendererAPI::API::OpenGL: return CreateScope<OpenGLTimerQueryPool>(capacity);
+        }
+
+        MK_CORE_ASSERT(false, "Unknown RendererAPI!")
+        return nullptr;
+    }
+}
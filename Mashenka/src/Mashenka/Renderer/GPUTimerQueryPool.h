@@ -0,0 +1,30 @@
+﻿#pragma once
+
+namespace Mashenka
+{
+    /*
+     * GPUTimerQueryPool Class
+     * A fixed number of timestamp queries, written into the command stream and read back once the GPU got there
+     * Timestamps are in nanoseconds on the GPU clock
+     */
+    class GPUTimerQueryPool
+    {
+    public:
+        static constexpr uint32_t InvalidQuery = ~0u;
+
+        virtual ~GPUTimerQueryPool() = default;
+
+        // Records the GPU time once the previous commands are done, InvalidQuery when the pool is exhausted
+        virtual uint32_t WriteTimestamp() = 0;
+        // Non blocking, true once the result of the query can be read
+        virtual bool IsAvailable(uint32_t query) const = 0;
+        virtual uint64_t GetTimestamp(uint32_t query) const = 0;
+        // gives the query back to the pool
+        virtual void Release(uint32_t query) = 0;
+
+        // The current GPU time, used to line the GPU clock up with the CPU clock
+        virtual uint64_t GetCurrentTimestamp() const = 0;
+
+        static Scope<GPUTimerQueryPool> Create(uint32_t capacity);
+    };
+}
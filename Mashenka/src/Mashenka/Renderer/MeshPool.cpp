@@ -0,0 +1,87 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/MeshPool.h"
+#include "Mashenka/Renderer/RenderCommand.h"
+
+namespace Mashenka
+{
+    MeshPool::MeshPool(const BufferLayout& layout, uint32_t maxVertices, uint32_t maxIndices, uint32_t maxDraws)
+        : m_MaxVertices(maxVertices), m_MaxIndices(maxIndices), m_MaxDraws(maxDraws), m_VertexStride(layout.GetStride())
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        MK_CORE_ASSERT(!layout.IsPerInstance(), "The mesh vertices can't be per instance!");
+        m_Commands.reserve(maxDraws);
+
+        m_VertexArray = VertexArray::Create();
+        m_VertexBuffer = VertexBuffer::Create(maxVertices * m_VertexStride);
+        m_VertexBuffer->SetLayout(layout);
+        m_VertexArray->AddVertexBuffer(m_VertexBuffer);
+
+        m_IndexBuffer = IndexBuffer::Create(maxIndices);
+        m_VertexArray->SetIndexBuffer(m_IndexBuffer);
+
+        m_CommandBuffer = StorageBuffer::Create(maxDraws * sizeof(DrawIndexedIndirectCommand));
+    }
+
+    MeshHandle MeshPool::Add(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (m_VertexCount + vertexCount > m_MaxVertices || m_IndexCount + indexCount > m_MaxIndices)
+        {
+            MK_CORE_ERROR("MeshPool is full, a mesh of {0} vertices and {1} indices does not fit", vertexCount,
+                          indexCount);
+            return {};
+        }
+
+        // the indices stay relative to the mesh, the base vertex of the draw moves them
+        m_VertexBuffer->SetData(vertices, vertexCount * m_VertexStride, m_VertexCount * m_VertexStride);
+        m_IndexBuffer->SetData(indices, indexCount, m_IndexCount);
+
+        m_Meshes.push_back({m_IndexCount, indexCount, m_VertexCount});
+        m_VertexCount += vertexCount;
+        m_IndexCount += indexCount;
+        return {static_cast<uint32_t>(m_Meshes.size() - 1)};
+    }
+
+    void MeshPool::Clear()
+    {
+        m_Meshes.clear();
+        m_Commands.clear();
+        m_VertexCount = 0;
+        m_IndexCount = 0;
+    }
+
+    void MeshPool::AddInstanceBuffer(const Ref<VertexBuffer>& instanceBuffer)
+    {
+        MK_CORE_ASSERT(instanceBuffer->GetLayout().IsPerInstance(), "Instance buffer layout must be per instance!");
+        m_VertexArray->AddVertexBuffer(instanceBuffer);
+    }
+
+    void MeshPool::Submit(MeshHandle mesh, uint32_t instanceCount, uint32_t baseInstance)
+    {
+        MK_CORE_ASSERT(IsValid(mesh), "Invalid mesh handle!");
+        // no draw from here, only Renderer::Submit binds the shader and the camera, Draw grows the command buffer
+        const Mesh& data = m_Meshes[mesh.Index];
+        m_Commands.push_back({data.IndexCount, instanceCount, data.FirstIndex, static_cast<int32_t>(data.BaseVertex),
+                              baseInstance});
+    }
+
+    void MeshPool::Draw()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (m_Commands.empty())
+            return;
+
+        const uint32_t drawCount = static_cast<uint32_t>(m_Commands.size());
+        if (drawCount > m_MaxDraws)
+        {
+            MK_CORE_WARN("MeshPool: {0} draws queued for a command buffer of {1}, growing it", drawCount, m_MaxDraws);
+            m_MaxDraws = std::max(drawCount, m_MaxDraws * 2);
+            m_CommandBuffer = StorageBuffer::Create(m_MaxDraws * sizeof(DrawIndexedIndirectCommand));
+        }
+        m_CommandBuffer->SetData(m_Commands.data(), drawCount * sizeof(DrawIndexedIndirectCommand));
+
+        m_VertexArray->Bind();
+        RenderCommand::MultiDrawIndexedIndirect(m_VertexArray, m_CommandBuffer, drawCount);
+        m_Commands.clear();
+    }
+}
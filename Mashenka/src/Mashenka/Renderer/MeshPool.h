@@ -0,0 +1,68 @@
+﻿#pragma once
+#include "Mashenka/Renderer/VertexArray.h"
+
+namespace Mashenka
+{
+    // A mesh added to a MeshPool, valid for the life time of the pool
+    struct MeshHandle
+    {
+        uint32_t Index = ~0u;
+    };
+
+    /*
+     * MeshPool Class
+     * Many meshes with the same vertex layout packed into one vertex buffer and one index buffer
+     * Every mesh is a range of both buffers, so a whole scene of different meshes is drawn from one vertex array
+     * Submitted draws become DrawIndexedIndirectCommand and go out in a single MultiDrawIndexedIndirect call
+     * Per draw data (e.g. transforms) goes into a per instance vertex buffer, picked by the baseInstance of Submit
+     * Meshes are allocated one after the other and live as long as the pool, Clear frees all of them
+     */
+    class MeshPool
+    {
+    public:
+        // maxDraws is the initial size of the command buffer, Draw grows it when more draws were queued
+        MeshPool(const BufferLayout& layout, uint32_t maxVertices, uint32_t maxIndices, uint32_t maxDraws = 4096);
+
+        // Copies the mesh into the shared buffers, indices are relative to the first vertex of this mesh
+        // Returns an invalid handle when the pool is full
+        MeshHandle Add(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+        bool IsValid(MeshHandle mesh) const { return mesh.Index < m_Meshes.size(); }
+        void Clear();
+
+        // Attributes that advance per instance, the layout must be per instance
+        void AddInstanceBuffer(const Ref<VertexBuffer>& instanceBuffer);
+
+        // Queues a draw of the mesh until the next Draw, instances start at baseInstance of the instance buffers
+        void Submit(MeshHandle mesh, uint32_t instanceCount = 1, uint32_t baseInstance = 0);
+
+        // Uploads the queued draws and issues them with one call to the bound shader, then clears the queue
+        // Use Renderer::Submit(shader, meshPool), it binds the shader and the camera first
+        void Draw();
+
+        uint32_t GetMeshCount() const { return static_cast<uint32_t>(m_Meshes.size()); }
+        uint32_t GetVertexCount() const { return m_VertexCount; }
+        uint32_t GetIndexCount() const { return m_IndexCount; }
+        uint32_t GetSubmittedCount() const { return static_cast<uint32_t>(m_Commands.size()); }
+        const Ref<VertexArray>& GetVertexArray() const { return m_VertexArray; }
+
+    private:
+        struct Mesh
+        {
+            uint32_t FirstIndex;
+            uint32_t IndexCount;
+            uint32_t BaseVertex;
+        };
+
+        uint32_t m_MaxVertices, m_MaxIndices, m_MaxDraws;
+        uint32_t m_VertexStride;
+        uint32_t m_VertexCount = 0;
+        uint32_t m_IndexCount = 0;
+        std::vector<Mesh> m_Meshes;
+        std::vector<DrawIndexedIndirectCommand> m_Commands;
+
+        Ref<VertexArray> m_VertexArray;
+        Ref<VertexBuffer> m_VertexBuffer;
+        Ref<IndexBuffer> m_IndexBuffer;
+        Ref<StorageBuffer> m_CommandBuffer;
+    };
+}
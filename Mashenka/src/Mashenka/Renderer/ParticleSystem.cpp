@@ -0,0 +1,227 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/ParticleSystem.h"
+#include "Mashenka/Renderer/RenderCommand.h"
+#include "Mashenka/Core/JobSystem.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define MK_PARTICLES_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace Mashenka
+{
+    // particles per job of the update and the packing, a multiple of 4 so only the last range has a scalar tail
+    static constexpr uint32_t s_ParticlesPerJob = 16384;
+
+    ParticleSystem::ParticleSystem(uint32_t maxParticles)
+        : m_MaxParticles(maxParticles)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        for (auto* attribute : {&m_PositionX, &m_PositionY, &m_VelocityX, &m_VelocityY, &m_ColorR, &m_ColorG,
+                                &m_ColorB, &m_ColorA, &m_ColorDeltaR, &m_ColorDeltaG, &m_ColorDeltaB,
+                                &m_ColorDeltaA, &m_Size, &m_SizeDelta, &m_Life})
+            attribute->resize(maxParticles);
+        m_Instances.resize(maxParticles);
+
+        m_VertexArray = VertexArray::Create();
+
+        // one quad, every instance scales and moves it
+        float corners[4 * 2] = {
+            -0.5f, -0.5f,
+            0.5f, -0.5f,
+            0.5f, 0.5f,
+            -0.5f, 0.5f
+        };
+        Ref<VertexBuffer> cornerBuffer = VertexBuffer::Create(corners, sizeof(corners));
+        cornerBuffer->SetLayout({{ShaderDataType::Float2, "a_Corner"}});
+        m_VertexArray->AddVertexBuffer(cornerBuffer);
+
+        m_InstanceBuffer = VertexBuffer::Create(maxParticles * sizeof(ParticleInstance));
+        m_InstanceBuffer->SetLayout(BufferLayout({
+            {ShaderDataType::Float2, "a_Position"},
+            {ShaderDataType::Float, "a_Size"},
+            {ShaderDataType::UByte4, "a_Color", true}
+        }, true));
+        m_VertexArray->AddVertexBuffer(m_InstanceBuffer);
+
+        uint32_t indices[6] = {0, 1, 2, 2, 3, 0};
+        m_VertexArray->SetIndexBuffer(IndexBuffer::Create(indices, 6));
+    }
+
+    float ParticleSystem::Random()
+    {
+        // xorshift32, plenty for particles and much cheaper than the std engines
+        m_RandomState ^= m_RandomState << 13;
+        m_RandomState ^= m_RandomState >> 17;
+        m_RandomState ^= m_RandomState << 5;
+        return static_cast<float>(m_RandomState >> 8) / 16777216.0f;
+    }
+
+    void ParticleSystem::Emit(const ParticleProps& props, uint32_t count)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        count = std::min(count, m_MaxParticles - m_ActiveCount);
+        float inverseLifeTime = 1.0f / props.LifeTime;
+        glm::vec4 colorDelta = (props.ColorEnd - props.ColorBegin) * inverseLifeTime;
+
+        for (uint32_t n = 0; n < count; n++)
+        {
+            uint32_t i = m_ActiveCount++;
+            m_PositionX[i] = props.Position.x;
+            m_PositionY[i] = props.Position.y;
+            m_VelocityX[i] = props.Velocity.x + props.VelocityVariation.x * (Random() - 0.5f);
+            m_VelocityY[i] = props.Velocity.y + props.VelocityVariation.y * (Random() - 0.5f);
+
+            m_ColorR[i] = props.ColorBegin.r;
+            m_ColorG[i] = props.ColorBegin.g;
+            m_ColorB[i] = props.ColorBegin.b;
+            m_ColorA[i] = props.ColorBegin.a;
+            m_ColorDeltaR[i] = colorDelta.r;
+            m_ColorDeltaG[i] = colorDelta.g;
+            m_ColorDeltaB[i] = colorDelta.b;
+            m_ColorDeltaA[i] = colorDelta.a;
+
+            float sizeBegin = props.SizeBegin + props.SizeVariation * (Random() - 0.5f);
+            m_Size[i] = sizeBegin;
+            m_SizeDelta[i] = (props.SizeEnd - sizeBegin) * inverseLifeTime;
+            m_Life[i] = props.LifeTime;
+        }
+    }
+
+    void ParticleSystem::OnUpdate(TimeStep ts)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        float dt = ts.GetSeconds();
+        JobSystem::ParallelFor(m_ActiveCount, s_ParticlesPerJob, [this, dt](uint32_t begin, uint32_t end)
+        {
+            UpdateParticles(dt, begin, end);
+        });
+        RemoveDeadParticles();
+    }
+
+    void ParticleSystem::UpdateParticles(float dt, uint32_t begin, uint32_t end)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // value += delta * dt for every attribute, in one pass so each block of particles is loaded once
+        float* values[] = {m_PositionX.data(), m_PositionY.data(), m_ColorR.data(), m_ColorG.data(),
+                           m_ColorB.data(), m_ColorA.data(), m_Size.data()};
+        const float* deltas[] = {m_VelocityX.data(), m_VelocityY.data(), m_ColorDeltaR.data(),
+                                 m_ColorDeltaG.data(), m_ColorDeltaB.data(), m_ColorDeltaA.data(),
+                                 m_SizeDelta.data()};
+        float* life = m_Life.data();
+        uint32_t i = begin;
+#ifdef MK_PARTICLES_SSE2
+        const __m128 step = _mm_set1_ps(dt);
+        for (; i + 4 <= end; i += 4)
+        {
+            for (int attribute = 0; attribute < 7; attribute++)
+            {
+                float* value = values[attribute] + i;
+                __m128 delta = _mm_mul_ps(_mm_loadu_ps(deltas[attribute] + i), step);
+                _mm_storeu_ps(value, _mm_add_ps(_mm_loadu_ps(value), delta));
+            }
+            _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), step));
+        }
+#endif
+        for (; i < end; i++)
+        {
+            for (int attribute = 0; attribute < 7; attribute++)
+                values[attribute][i] += deltas[attribute][i] * dt;
+            life[i] -= dt;
+        }
+    }
+
+    void ParticleSystem::RemoveDeadParticles()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        uint32_t i = 0;
+        while (i < m_ActiveCount)
+        {
+            if (m_Life[i] > 0.0f)
+            {
+                i++;
+                continue;
+            }
+
+            // swap remove, the last particle takes the slot and is tested next
+            uint32_t last = --m_ActiveCount;
+            if (i == last)
+                break;
+            for (auto* attribute : {&m_PositionX, &m_PositionY, &m_VelocityX, &m_VelocityY, &m_ColorR, &m_ColorG,
+                                    &m_ColorB, &m_ColorA, &m_ColorDeltaR, &m_ColorDeltaG, &m_ColorDeltaB,
+                                    &m_ColorDeltaA, &m_Size, &m_SizeDelta, &m_Life})
+                (*attribute)[i] = (*attribute)[last];
+        }
+    }
+
+    static inline uint32_t PackColor(float r, float g, float b, float a)
+    {
+        auto channel = [](float value)
+        {
+            return static_cast<uint32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+        };
+        return channel(r) | channel(g) << 8 | channel(b) << 16 | channel(a) << 24;
+    }
+
+    void ParticleSystem::PackInstances(uint32_t begin, uint32_t end)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        ParticleInstance* instances = m_Instances.data();
+        uint32_t i = begin;
+#ifdef MK_PARTICLES_SSE2
+        static_assert(sizeof(ParticleInstance) == 16, "ParticleInstance must fill one SSE register");
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        auto channel = [&](const float* value)
+        {
+            // clamp to [0, 1] and round to 0..255
+            __m128 clamped = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(value), zero), one);
+            return _mm_cvtps_epi32(_mm_mul_ps(clamped, scale));
+        };
+
+        for (; i + 4 <= end; i += 4)
+        {
+            __m128i color = channel(m_ColorR.data() + i);
+            color = _mm_or_si128(color, _mm_slli_epi32(channel(m_ColorG.data() + i), 8));
+            color = _mm_or_si128(color, _mm_slli_epi32(channel(m_ColorB.data() + i), 16));
+            color = _mm_or_si128(color, _mm_slli_epi32(channel(m_ColorA.data() + i), 24));
+
+            // 4 particles as columns, transposed into 4 instances
+            __m128 x = _mm_loadu_ps(m_PositionX.data() + i);
+            __m128 y = _mm_loadu_ps(m_PositionY.data() + i);
+            __m128 size = _mm_loadu_ps(m_Size.data() + i);
+            __m128 packed = _mm_castsi128_ps(color);
+            _MM_TRANSPOSE4_PS(x, y, size, packed);
+            _mm_storeu_ps(reinterpret_cast<float*>(instances + i + 0), x);
+            _mm_storeu_ps(reinterpret_cast<float*>(instances + i + 1), y);
+            _mm_storeu_ps(reinterpret_cast<float*>(instances + i + 2), size);
+            _mm_storeu_ps(reinterpret_cast<float*>(instances + i + 3), packed);
+        }
+#endif
+        for (; i < end; i++)
+        {
+            instances[i].PositionX = m_PositionX[i];
+            instances[i].PositionY = m_PositionY[i];
+            instances[i].Size = m_Size[i];
+            instances[i].Color = PackColor(m_ColorR[i], m_ColorG[i], m_ColorB[i], m_ColorA[i]);
+        }
+    }
+
+    void ParticleSystem::Draw()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (m_ActiveCount == 0)
+            return;
+
+        JobSystem::ParallelFor(m_ActiveCount, s_ParticlesPerJob, [this](uint32_t begin, uint32_t end)
+        {
+            PackInstances(begin, end);
+        });
+        m_InstanceBuffer->SetData(m_Instances.data(), m_ActiveCount * sizeof(ParticleInstance));
+
+        m_VertexArray->Bind();
+        RenderCommand::DrawIndexedInstanced(m_VertexArray, 6, m_ActiveCount);
+        RendererStats::AddQuads(m_ActiveCount, 0);
+    }
+}
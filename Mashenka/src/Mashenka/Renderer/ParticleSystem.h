@@ -0,0 +1,80 @@
+﻿#pragma once
+#include "Mashenka/Renderer/VertexArray.h"
+#include "Mashenka/Core/TimeStep.h"
+
+#include <glm/glm.hpp>
+
+namespace Mashenka
+{
+    // How new particles start, the variations are spread evenly around the base value
+    struct ParticleProps
+    {
+        glm::vec2 Position = glm::vec2(0.0f);
+        glm::vec2 Velocity = glm::vec2(0.0f), VelocityVariation = glm::vec2(0.0f);
+        glm::vec4 ColorBegin = glm::vec4(1.0f), ColorEnd = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+        float SizeBegin = 0.1f, SizeEnd = 0.0f, SizeVariation = 0.0f;
+        float LifeTime = 1.0f; // seconds
+    };
+
+    /*
+     * ParticleSystem Class
+     * Particles live in a preallocated pool stored as structure of arrays, the live ones are packed at the front
+     * and a dead particle is replaced by the last one, so updating only walks over live particles
+     * Color and size change linearly over the life time, the per second deltas are computed when emitting
+     * The update and the packing of the instance data run 4 particles at a time with SSE2, split into ranges over
+     * the JobSystem workers
+     * Draw it with Renderer2D::DrawParticles, all particles go out in one instanced draw call
+     */
+    class ParticleSystem
+    {
+    public:
+        ParticleSystem(uint32_t maxParticles = 100000);
+
+        // particles that do not fit into the pool are dropped
+        void Emit(const ParticleProps& props, uint32_t count = 1);
+        void OnUpdate(TimeStep ts);
+
+        uint32_t GetActiveCount() const { return m_ActiveCount; }
+        uint32_t GetMaxParticles() const { return m_MaxParticles; }
+
+        // all particles of the system are drawn at this depth
+        void SetDepth(float depth) { m_Depth = depth; }
+        float GetDepth() const { return m_Depth; }
+
+        // Packs and uploads the live particles, then draws them with the bound particle shader
+        void Draw();
+
+    private:
+        // both work on the particles [begin, end), the ranges run in parallel on the JobSystem
+        void UpdateParticles(float dt, uint32_t begin, uint32_t end);
+        void RemoveDeadParticles();
+        void PackInstances(uint32_t begin, uint32_t end);
+        float Random(); // in [0, 1)
+
+    private:
+        uint32_t m_MaxParticles;
+        uint32_t m_ActiveCount = 0;
+        float m_Depth = 0.0f;
+        uint32_t m_RandomState = 0x9E3779B9u;
+
+        std::vector<float> m_PositionX, m_PositionY;
+        std::vector<float> m_VelocityX, m_VelocityY;
+        std::vector<float> m_ColorR, m_ColorG, m_ColorB, m_ColorA;
+        std::vector<float> m_ColorDeltaR, m_ColorDeltaG, m_ColorDeltaB, m_ColorDeltaA;
+        std::vector<float> m_Size, m_SizeDelta;
+        std::vector<float> m_Life; // seconds left
+
+        // what the GPU gets per particle, 16 bytes
+        struct ParticleInstance
+        {
+            float PositionX, PositionY;
+            float Size;
+            uint32_t Color; // RGBA8
+        };
+
+        std::vector<ParticleInstance> m_Instances;
+
+        Ref<VertexArray> m_VertexArray;
+        Ref<VertexBuffer> m_InstanceBuffer;
+    };
+}
@@ -0,0 +1,372 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/QuadKernel.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define MK_QUAD_KERNEL_X86
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        // MSVC allows AVX2 intrinsics in any function
+        #define MK_TARGET_AVX2
+    #else
+        // GCC and Clang only allow AVX2 intrinsics in functions compiled for AVX2
+        #define MK_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace Mashenka
+{
+    // Unit quad corners and their texture coordinates, in the order of the index buffer (0, 1, 2, 2, 3, 0)
+    static constexpr float s_CornerX[4] = {-0.5f, 0.5f, 0.5f, -0.5f};
+    static constexpr float s_CornerY[4] = {-0.5f, -0.5f, 0.5f, 0.5f};
+    static constexpr float s_TexCoordX[4] = {0.0f, 1.0f, 1.0f, 0.0f};
+    static constexpr float s_TexCoordY[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+
+    // Write the four vertices of a quad whose corner positions are already transformed
+    static inline void WriteQuad(const QuadKernelInput& input, uint32_t quad, const float* x, const float* y,
+                                 QuadVertex* output)
+    {
+        QuadVertex* vertex = output + quad * 4;
+        for (uint32_t corner = 0; corner < 4; corner++, vertex++)
+        {
+            vertex->Position = {x[corner], y[corner], input.PositionZ[quad]};
+            vertex->Color = input.Color[quad];
+            vertex->TexCoord = {s_TexCoordX[corner], s_TexCoordY[corner]};
+            vertex->TexIndex = input.TexIndex[quad];
+            vertex->TilingFactor = input.TilingFactor[quad];
+        }
+    }
+
+    /*
+     * ==============================SCALAR==============================
+     */
+    static void TransformScalar(const QuadKernelInput& input, uint32_t first, uint32_t count, QuadVertex* output)
+    {
+        for (uint32_t i = first; i < count; i++)
+        {
+            float c = std::cos(input.Rotation[i]);
+            float s = std::sin(input.Rotation[i]);
+
+            float x[4], y[4];
+            for (uint32_t corner = 0; corner < 4; corner++)
+            {
+                float localX = s_CornerX[corner] * input.SizeX[i];
+                float localY = s_CornerY[corner] * input.SizeY[i];
+                x[corner] = input.PositionX[i] + c * localX - s * localY;
+                y[corner] = input.PositionY[i] + s * localX + c * localY;
+            }
+            WriteQuad(input, i, x, y, output);
+        }
+    }
+
+#ifdef MK_QUAD_KERNEL_X86
+    /*
+     * ==============================SSE2==============================
+     * sin and cos use the Cephes polynomials (as in sse_mathfun): the angle is reduced to [-pi/4, pi/4] around
+     * the nearest multiple of pi/4 and the quadrant picks the polynomial and the sign of each result
+     */
+    static inline void SinCosSSE2(__m128 x, __m128& sinResult, __m128& cosResult)
+    {
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+        __m128 sinSign = _mm_and_ps(x, signMask);
+        x = _mm_andnot_ps(signMask, x); // |x|
+
+        // quadrant j = (int)(|x| * 4 / pi), rounded up to even
+        __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+        j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+        __m128 y = _mm_cvtepi32_ps(j);
+
+        __m128 sinSwap = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+        __m128 cosSign = _mm_castsi128_ps(
+            _mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+        __m128 polyMask = _mm_castsi128_ps(
+            _mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+        sinSign = _mm_xor_ps(sinSign, sinSwap);
+
+        // x - j * pi / 4 in extended precision
+        x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+        x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+        x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+        __m128 z = _mm_mul_ps(x, x);
+
+        // cos polynomial
+        __m128 cosPoly = _mm_set1_ps(2.443315711809948e-5f);
+        cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(-1.388731625493765e-3f));
+        cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(4.166664568298827e-2f));
+        cosPoly = _mm_mul_ps(_mm_mul_ps(cosPoly, z), z);
+        cosPoly = _mm_add_ps(_mm_sub_ps(cosPoly, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+        // sin polynomial
+        __m128 sinPoly = _mm_set1_ps(-1.9515295891e-4f);
+        sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(8.3321608736e-3f));
+        sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(-1.6666654611e-1f));
+        sinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, z), x), x);
+
+        __m128 sinValue = _mm_or_ps(_mm_and_ps(polyMask, sinPoly), _mm_andnot_ps(polyMask, cosPoly));
+        __m128 cosValue = _mm_or_ps(_mm_and_ps(polyMask, cosPoly), _mm_andnot_ps(polyMask, sinPoly));
+        sinResult = _mm_xor_ps(sinValue, sinSign);
+        cosResult = _mm_xor_ps(cosValue, cosSign);
+    }
+
+    static void TransformSSE2(const QuadKernelInput& input, uint32_t first, uint32_t count, QuadVertex* output)
+    {
+        const __m128 half = _mm_set1_ps(0.5f);
+        uint32_t i = first;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 positionX = _mm_loadu_ps(input.PositionX + i);
+            __m128 positionY = _mm_loadu_ps(input.PositionY + i);
+            __m128 halfX = _mm_mul_ps(_mm_loadu_ps(input.SizeX + i), half);
+            __m128 halfY = _mm_mul_ps(_mm_loadu_ps(input.SizeY + i), half);
+            __m128 s, c;
+            SinCosSSE2(_mm_loadu_ps(input.Rotation + i), s, c);
+
+            // rotated half extents, each corner is position +- a +- b
+            __m128 cosX = _mm_mul_ps(c, halfX), sinY = _mm_mul_ps(s, halfY);
+            __m128 sinX = _mm_mul_ps(s, halfX), cosY = _mm_mul_ps(c, halfY);
+
+            // [corner][quad]
+            alignas(16) float x[4][4], y[4][4];
+            _mm_store_ps(x[0], _mm_add_ps(_mm_sub_ps(positionX, cosX), sinY));
+            _mm_store_ps(y[0], _mm_sub_ps(_mm_sub_ps(positionY, sinX), cosY));
+            _mm_store_ps(x[1], _mm_add_ps(_mm_add_ps(positionX, cosX), sinY));
+            _mm_store_ps(y[1], _mm_sub_ps(_mm_add_ps(positionY, sinX), cosY));
+            _mm_store_ps(x[2], _mm_sub_ps(_mm_add_ps(positionX, cosX), sinY));
+            _mm_store_ps(y[2], _mm_add_ps(_mm_add_ps(positionY, sinX), cosY));
+            _mm_store_ps(x[3], _mm_sub_ps(_mm_sub_ps(positionX, cosX), sinY));
+            _mm_store_ps(y[3], _mm_add_ps(_mm_sub_ps(positionY, sinX), cosY));
+
+            for (uint32_t quad = 0; quad < 4; quad++)
+            {
+                float quadX[4] = {x[0][quad], x[1][quad], x[2][quad], x[3][quad]};
+                float quadY[4] = {y[0][quad], y[1][quad], y[2][quad], y[3][quad]};
+                WriteQuad(input, i + quad, quadX, quadY, output);
+            }
+        }
+        TransformScalar(input, i, count, output);
+    }
+
+    /*
+     * ==============================AVX2==============================
+     * Same as SSE2 with 8 quads per iteration
+     */
+    MK_TARGET_AVX2 static inline void SinCosAVX2(__m256 x, __m256& sinResult, __m256& cosResult)
+    {
+        const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x80000000));
+        __m256 sinSign = _mm256_and_ps(x, signMask);
+        x = _mm256_andnot_ps(signMask, x);
+
+        __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)));
+        j = _mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+        __m256 y = _mm256_cvtepi32_ps(j);
+
+        __m256 sinSwap = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29));
+        __m256 cosSign = _mm256_castsi256_ps(
+            _mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)),
+                              29));
+        __m256 polyMask = _mm256_castsi256_ps(
+            _mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+        sinSign = _mm256_xor_ps(sinSign, sinSwap);
+
+        x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-0.78515625f)));
+        x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-2.4187564849853515625e-4f)));
+        x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-3.77489497744594108e-8f)));
+        __m256 z = _mm256_mul_ps(x, x);
+
+        __m256 cosPoly = _mm256_set1_ps(2.443315711809948e-5f);
+        cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, z), _mm256_set1_ps(-1.388731625493765e-3f));
+        cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, z), _mm256_set1_ps(4.166664568298827e-2f));
+        cosPoly = _mm256_mul_ps(_mm256_mul_ps(cosPoly, z), z);
+        cosPoly = _mm256_add_ps(_mm256_sub_ps(cosPoly, _mm256_mul_ps(z, _mm256_set1_ps(0.5f))),
+                                _mm256_set1_ps(1.0f));
+
+        __m256 sinPoly = _mm256_set1_ps(-1.9515295891e-4f);
+        sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, z), _mm256_set1_ps(8.3321608736e-3f));
+        sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, z), _mm256_set1_ps(-1.6666654611e-1f));
+        sinPoly = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinPoly, z), x), x);
+
+        __m256 sinValue = _mm256_blendv_ps(cosPoly, sinPoly, polyMask);
+        __m256 cosValue = _mm256_blendv_ps(sinPoly, cosPoly, polyMask);
+        sinResult = _mm256_xor_ps(sinValue, sinSign);
+        cosResult = _mm256_xor_ps(cosValue, cosSign);
+    }
+
+    MK_TARGET_AVX2 static void TransformAVX2(const QuadKernelInput& input, uint32_t count, QuadVertex* output)
+    {
+        const __m256 half = _mm256_set1_ps(0.5f);
+        uint32_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 positionX = _mm256_loadu_ps(input.PositionX + i);
+            __m256 positionY = _mm256_loadu_ps(input.PositionY + i);
+            __m256 halfX = _mm256_mul_ps(_mm256_loadu_ps(input.SizeX + i), half);
+            __m256 halfY = _mm256_mul_ps(_mm256_loadu_ps(input.SizeY + i), half);
+            __m256 s, c;
+            SinCosAVX2(_mm256_loadu_ps(input.Rotation + i), s, c);
+
+            __m256 cosX = _mm256_mul_ps(c, halfX), sinY = _mm256_mul_ps(s, halfY);
+            __m256 sinX = _mm256_mul_ps(s, halfX), cosY = _mm256_mul_ps(c, halfY);
+
+            alignas(32) float x[4][8], y[4][8];
+            _mm256_store_ps(x[0], _mm256_add_ps(_mm256_sub_ps(positionX, cosX), sinY));
+            _mm256_store_ps(y[0], _mm256_sub_ps(_mm256_sub_ps(positionY, sinX), cosY));
+            _mm256_store_ps(x[1], _mm256_add_ps(_mm256_add_ps(positionX, cosX), sinY));
+            _mm256_store_ps(y[1], _mm256_sub_ps(_mm256_add_ps(positionY, sinX), cosY));
+            _mm256_store_ps(x[2], _mm256_sub_ps(_mm256_add_ps(positionX, cosX), sinY));
+            _mm256_store_ps(y[2], _mm256_add_ps(_mm256_add_ps(positionY, sinX), cosY));
+            _mm256_store_ps(x[3], _mm256_sub_ps(_mm256_sub_ps(positionX, cosX), sinY));
+            _mm256_store_ps(y[3], _mm256_add_ps(_mm256_sub_ps(positionY, sinX), cosY));
+
+            for (uint32_t quad = 0; quad < 8; quad++)
+            {
+                float quadX[4] = {x[0][quad], x[1][quad], x[2][quad], x[3][quad]};
+                float quadY[4] = {y[0][quad], y[1][quad], y[2][quad], y[3][quad]};
+                WriteQuad(input, i + quad, quadX, quadY, output);
+            }
+        }
+        // SSE2 takes the next 4 quads, the scalar kernel the rest
+        TransformSSE2(input, i, count, output);
+    }
+
+    static bool CPUSupportsAVX2()
+    {
+    #ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        // AVX needs the OS to save the YMM registers (OSXSAVE and XCR0)
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #else
+        return __builtin_cpu_supports("avx2");
+    #endif
+    }
+#endif
+
+    /*
+     * ==============================DISPATCH==============================
+     */
+    static QuadKernel::Implementation DetectImplementation()
+    {
+    #ifdef MK_QUAD_KERNEL_X86
+        // SSE2 is part of x64
+        return CPUSupportsAVX2() ? QuadKernel::Implementation::AVX2 : QuadKernel::Implementation::SSE2;
+    #else
+        return QuadKernel::Implementation::Scalar;
+    #endif
+    }
+
+    static QuadKernel::Implementation s_Implementation = DetectImplementation();
+
+    void QuadKernel::Transform(const QuadKernelInput& input, uint32_t count, QuadVertex* output)
+    {
+        Transform(s_Implementation, input, count, output);
+    }
+
+    void QuadKernel::Transform(Implementation implementation, const QuadKernelInput& input, uint32_t count,
+                               QuadVertex* output)
+    {
+        MK_CORE_ASSERT(IsSupported(implementation), "Quad kernel implementation is not supported by this CPU!");
+        switch (implementation)
+        {
+    #ifdef MK_QUAD_KERNEL_X86
+        case Implementation::AVX2: TransformAVX2(input, count, output);
+            return;
+        case Implementation::SSE2: TransformSSE2(input, 0, count, output);
+            return;
+    #endif
+        default: TransformScalar(input, 0, count, output);
+            return;
+        }
+    }
+
+    /*
+     * ==============================PACK==============================
+     */
+    static inline uint32_t PackColor(const glm::vec4& color)
+    {
+        auto channel = [](float value)
+        {
+            return static_cast<uint32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+        };
+        return channel(color.r) | channel(color.g) << 8 | channel(color.b) << 16 | channel(color.a) << 24;
+    }
+
+    // IEEE half float, truncated. Tiling factors are positive and small, so subnormals just become 0
+    static inline uint32_t ToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        uint32_t sign = (bits >> 16) & 0x8000u;
+        int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+        uint32_t mantissa = (bits >> 13) & 0x3FFu;
+        if (exponent <= 0)
+            return sign;
+        if (exponent >= 31)
+            return sign | 0x7BFFu; // the largest finite half
+        return sign | static_cast<uint32_t>(exponent) << 10 | mantissa;
+    }
+
+    static_assert(sizeof(QuadInstance) == 32, "QuadInstance must match the std430 layout of the pulled quad shader");
+
+    void QuadKernel::Pack(const QuadKernelInput& input, uint32_t count, QuadInstance* output)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            QuadInstance& instance = output[i];
+            instance.Position = {input.PositionX[i], input.PositionY[i], input.PositionZ[i]};
+            instance.Rotation = input.Rotation[i];
+            instance.Size = {input.SizeX[i], input.SizeY[i]};
+            instance.Color = PackColor(input.Color[i]);
+            instance.TexIndexTiling = static_cast<uint32_t>(input.TexIndex[i]) | ToHalf(input.TilingFactor[i]) << 16;
+        }
+    }
+
+    QuadKernel::Implementation QuadKernel::GetImplementation()
+    {
+        return s_Implementation;
+    }
+
+    void QuadKernel::SetImplementation(Implementation implementation)
+    {
+        if (!IsSupported(implementation))
+        {
+            MK_CORE_WARN("Quad kernel {0} is not supported by this CPU", GetImplementationName(implementation));
+            return;
+        }
+        s_Implementation = implementation;
+    }
+
+    bool QuadKernel::IsSupported(Implementation implementation)
+    {
+        switch (implementation)
+        {
+        case Implementation::Scalar: return true;
+    #ifdef MK_QUAD_KERNEL_X86
+        case Implementation::SSE2: return true;
+        case Implementation::AVX2: return CPUSupportsAVX2();
+    #endif
+        default: return false;
+        }
+    }
+
+    const char* QuadKernel::GetImplementationName(Implementation implementation)
+    {
+        switch (implementation)
+        {
+        case Implementation::Scalar: return "Scalar";
+        case Implementation::SSE2: return "SSE2";
+        case Implementation::AVX2: return "AVX2";
+        }
+        return "Unknown";
+    }
+}
@@ -0,0 +1,69 @@
+﻿#pragma once
+#include <glm/glm.hpp>
+
+namespace Mashenka
+{
+    // One vertex of the Renderer2D batch
+    struct QuadVertex
+    {
+        glm::vec3 Position;
+        glm::vec4 Color;
+        glm::vec2 TexCoord;
+        float TexIndex;
+        float TilingFactor;
+    };
+
+    // One quad of the Renderer2D batch when the vertex shader builds the corners, 32 bytes instead of 4 QuadVertex
+    struct QuadInstance
+    {
+        glm::vec3 Position;
+        float Rotation; // radians
+        glm::vec2 Size;
+        uint32_t Color; // RGBA8, red in the lowest byte
+        uint32_t TexIndexTiling; // texture index in the lowest byte, tiling factor as a half float in the upper 16 bits
+    };
+
+    // Quads to transform, one array per attribute (structure of arrays) so several quads fit in one SIMD register
+    struct QuadKernelInput
+    {
+        const float* PositionX = nullptr;
+        const float* PositionY = nullptr;
+        const float* PositionZ = nullptr;
+        const float* SizeX = nullptr;
+        const float* SizeY = nullptr;
+        const float* Rotation = nullptr; // radians
+        const glm::vec4* Color = nullptr;
+        const float* TexIndex = nullptr;
+        const float* TilingFactor = nullptr;
+    };
+
+    /*
+     * QuadKernel Class
+     * Writes the four corners of each quad straight into the batch buffer: corner = position + rotate(offset * size)
+     * This replaces the translate * rotate * scale matrix products that were done for every quad
+     * SSE2 transforms 4 quads per iteration and AVX2 8, the best implementation the CPU supports is used,
+     * the scalar implementation covers the remaining quads and other architectures
+     */
+    class QuadKernel
+    {
+    public:
+        enum class Implementation
+        {
+            Scalar = 0, SSE2, AVX2
+        };
+
+    public:
+        // Writes count * 4 vertices to output, in the corner order of the quad index buffer
+        static void Transform(const QuadKernelInput& input, uint32_t count, QuadVertex* output);
+        static void Transform(Implementation implementation, const QuadKernelInput& input, uint32_t count,
+                              QuadVertex* output);
+        // Writes count instances to output, the corners are left to the vertex shader
+        static void Pack(const QuadKernelInput& input, uint32_t count, QuadInstance* output);
+
+        static Implementation GetImplementation();
+        // Force an implementation, e.g. to compare them, unsupported implementations are ignored
+        static void SetImplementation(Implementation implementation);
+        static bool IsSupported(Implementation implementation);
+        static const char* GetImplementationName(Implementation implementation);
+    };
+}
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "Mashenka/Renderer/RendererAPI.h"
+#include "Mashenka/Renderer/RendererStats.h"
 #include "VertexArray.h"
 #include "glm/vec4.hpp"
 
@@ -21,7 +22,31 @@ namespace Mashenka
         // static functions to call RendererAPI functions
         inline static void SetClearColor(const glm::vec4& color) { s_RendererAPI->SetClearColor(color); }
         inline static void Clear() { s_RendererAPI->Clear(); }
-        inline static void DrawIndexed(const Ref<VertexArray>& vertexArray) { s_RendererAPI->DrawIndexed(vertexArray); }
+        inline static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0)
+        {
+            RendererStats::AddDrawCall(indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount());
+            s_RendererAPI->DrawIndexed(vertexArray, indexCount);
+        }
+        inline static void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount)
+        {
+            uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
+            RendererStats::AddDrawCall(count * instanceCount);
+            s_RendererAPI->DrawIndexedInstanced(vertexArray, indexCount, instanceCount);
+        }
+        inline static void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<StorageBuffer>& commands,
+                                               uint32_t offset = 0)
+        {
+            // the counts live on the GPU, only the draw call is counted
+            RendererStats::AddDrawCall(0);
+            s_RendererAPI->DrawIndexedIndirect(vertexArray, commands, offset);
+        }
+        inline static void MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray,
+                                                    const Ref<StorageBuffer>& commands, uint32_t drawCount,
+                                                    uint32_t offset = 0)
+        {
+            RendererStats::AddDrawCall(0);
+            s_RendererAPI->MultiDrawIndexedIndirect(vertexArray, commands, drawCount, offset);
+        }
 
         
 
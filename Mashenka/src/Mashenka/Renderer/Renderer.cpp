@@ -1,6 +1,10 @@
 ﻿#include "mkpch.h"
 #include "Mashenka/Renderer/Renderer.h"
 #include "Mashenka/Renderer/Renderer2D.h"
+#include "Mashenka/Renderer/TextureResidency.h"
+#include "Mashenka/Renderer/RendererStats.h"
+#include "Mashenka/Renderer/DynamicResolution.h"
+#include "Mashenka/Debug/GPUProfiler.h"
 
 
 namespace Mashenka
@@ -14,24 +18,51 @@ namespace Mashenka
         MK_PROFILE_FUNCTION(); // Profiling
         // Initialize the renderer API
         RenderCommand::Init();
+        GPUProfiler::Init();
+        TextureResidency::Init();
+        DynamicResolution::Init();
         Renderer2D::Init();
     }
 
     void Renderer::Shutdown()
     {
         Renderer2D::Shutdown();
+        DynamicResolution::Shutdown();
+        TextureResidency::Shutdown();
+        GPUProfiler::Shutdown();
+    }
+
+    void Renderer::BeginFrame()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // Keep the texture memory under the budget
+        TextureResidency::NewFrame();
+        RendererStats::BeginFrame();
+        // GPU spans of earlier frames that are done by now
+        GPUProfiler::BeginFrame();
+        // the scene goes into the scaled framebuffer when dynamic resolution is on
+        DynamicResolution::BeginFrame();
+    }
+
+    void Renderer::EndFrame()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // upscale the scene, ImGui is drawn on top at native resolution
+        DynamicResolution::EndFrame();
     }
 
     void Renderer::OnWindowResize(uint32_t width, uint32_t height)
     {
         // Set the viewport
         RenderCommand::SetViewport(0, 0, width, height);
+        DynamicResolution::OnWindowResize(width, height);
     }
 
     void Renderer::BeginScene(OrthographicCamera& camera)
     {
         // Set the view projection matrix of the scene
         s_SceneData->ViewProjectionMatrix = camera.GetViewProjectionMatrix();
+        RendererStats::BeginScene();
     }
 
     void Renderer::EndScene()
@@ -51,7 +82,18 @@ namespace Mashenka
         shader->SetMat4("u_Transform", transform);
         
         // Submit the vertex array to the RendererCommand
+        MK_PROFILE_GPU_SCOPE("Renderer::Submit");
         vertexArray->Bind();
         RenderCommand::DrawIndexed(vertexArray);
     }
+
+    void Renderer::Submit(const Ref<Shader>& shader, MeshPool& meshPool)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        shader->Bind();
+        shader->SetMat4("u_ViewProjection", s_SceneData->ViewProjectionMatrix);
+
+        MK_PROFILE_GPU_SCOPE("Renderer::Submit MeshPool");
+        meshPool.Draw();
+    }
 }
@@ -2,6 +2,7 @@
 #include "Mashenka/Renderer/OrthographicCamera.h"
 #include "Mashenka/Renderer/Shader.h"
 #include "Mashenka/Renderer/RenderCommand.h"
+#include "Mashenka/Renderer/MeshPool.h"
 
 namespace Mashenka
 {
@@ -13,6 +14,10 @@ namespace Mashenka
     public:
         static void Init();
         static void Shutdown(); // clean up the renderer
+        // called once per frame by the application, before any layer updates
+        static void BeginFrame();
+        // called once per frame by the application, after the layer updates and before ImGui
+        static void EndFrame();
         // on window resize
         static void OnWindowResize(uint32_t width, uint32_t height);
         static void BeginScene(OrthographicCamera& camera); //Prepare the scene 
@@ -24,6 +29,8 @@ namespace Mashenka
         // using const reference to make sure that the object is not modified when the function is called, transform matrix is model matrix in rendering
         // Model matrix = Translation * Rotation * Scale
         static void Submit(const Ref<Shader>& shader, const Ref<VertexArray>& vertexArray, const glm::mat4& transform = glm::mat4(1.0f));
+        // Draw everything submitted to the mesh pool in one call, transforms come from its instance buffers
+        static void Submit(const Ref<Shader>& shader, MeshPool& meshPool);
 
         // Get API
         inline static RendererAPI::API GetAPI() { return RendererAPI::GetAPI(); }
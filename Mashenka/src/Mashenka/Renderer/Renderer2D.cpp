@@ -4,22 +4,142 @@
 #include "Mashenka/Renderer/VertexArray.h"
 #include "Mashenka/Renderer/Shader.h"
 #include "Mashenka/Renderer/RenderCommand.h"
+#include "Mashenka/Renderer/QuadKernel.h"
+#include "Mashenka/Renderer/Culling.h"
+#include "Mashenka/Debug/GPUProfiler.h"
+#include "Mashenka/Core/JobSystem.h"
 // #include "Platform/OpenGL/OpenGLShader.h", but we can't include it here because it will cause a circular dependency
-#include <glm/gtc/matrix_transform.hpp> // for glm::mat4
 
 namespace Mashenka
 {
+    // A quad drawn from a JobSystem thread, staged into the batch when the threads are merged
+    struct RecordedQuad
+    {
+        glm::vec3 Position;
+        glm::vec2 Size;
+        float Rotation;
+        glm::vec4 Color;
+        uint32_t Texture; // into ThreadQuadBuffer::Textures
+        float TilingFactor;
+    };
+
+    // Quads of one thread recorded under one sort key, [Begin, End) of ThreadQuadBuffer::Quads
+    struct RecordedRun
+    {
+        uint64_t SortKey;
+        uint32_t Begin, End;
+    };
+
+    // Only the owning thread writes it while recording, the main thread reads it when merging
+    struct ThreadQuadBuffer
+    {
+        std::vector<RecordedQuad> Quads;
+        std::vector<RecordedRun> Runs;
+        // the textures are kept alive per thread instead of per quad, refcounting one texture from every thread
+        // would bounce its counter between the cores. Entry 0 is null, the flat colored quads
+        std::vector<Ref<Texture2D>> Textures{nullptr};
+        std::unordered_map<const Texture2D*, uint32_t> TextureIndices;
+        // direct mapped cache in front of TextureIndices, most quads hit it without hashing into the map
+        std::array<std::pair<const Texture2D*, uint32_t>, 64> TextureCache{};
+        // merge only, the batch slot of each entry of Textures and the batch it is valid for
+        std::vector<uint32_t> MergeSlots, MergeBatches;
+        // the sort keys of nested submissions, a thread waiting on a job may pick up another submitting job
+        std::vector<uint64_t> SortKeys;
+    };
+
     // Initialize the scene data
     struct Render2DStorage
     {
+        static const uint32_t MaxQuads = 10000; // quads per draw call
+        static const uint32_t MaxVertices = MaxQuads * 4;
+        static const uint32_t MaxIndices = MaxQuads * 6;
+        static const uint32_t MaxTextureSlots = 16; // the minimum GL_MAX_TEXTURE_IMAGE_UNITS, must match the shader
+
         Ref<VertexArray> QuadVertexArray;
-        Ref<Shader> TextureShader;
+        Ref<VertexBuffer> QuadVertexBuffer;
+        BufferLayout QuadVertexLayout;
+        ShaderLibrary Shaders;
+        Ref<Shader> QuadShader;
+        Ref<Shader> PulledQuadShader;
+        Ref<Shader> ParticleShader;
+        Ref<Shader> GPUParticleShader;
         Ref<Texture2D> WhiteTexture;
+
+        // Quads of the current batch, one array per attribute so the quad kernel can load them with SIMD
+        uint32_t QuadCount = 0;
+        std::vector<float> PositionX, PositionY, PositionZ;
+        std::vector<float> SizeX, SizeY, Rotation;
+        std::vector<glm::vec4> Color;
+        std::vector<float> TexIndex, TilingFactor;
+
+        // Quads outside the camera bounds are dropped before the kernel runs
+        bool CullingEnabled = true;
+        Bounds2D CameraBounds;
+        std::vector<uint8_t> Visible;
+
+        // written by the quad kernel, then uploaded
+        std::vector<QuadVertex> QuadVertices;
+
+        // Vertex pulling, the pulled quad shader reads the instances by gl_VertexID, the vertex array only has indices
+        bool VertexPulling = false;
+        std::vector<QuadInstance> QuadInstances;
+        Ref<StorageBuffer> QuadInstanceBuffer;
+        Ref<VertexArray> PulledQuadVertexArray;
+
+        // slot 0 is the white texture used by flat colored quads
+        std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
+        uint32_t TextureSlotIndex = 1;
+        uint32_t BatchIndex = 0; // counts the batches, tells the merge which texture slots are still valid
+
+        // one per JobSystem thread, indexed by JobSystem::GetThreadIndex
+        std::vector<Scope<ThreadQuadBuffer>> ThreadBuffers;
     };
 
+    // quads per job of the culling and the quad kernel
+    static constexpr uint32_t s_QuadsPerJob = 2048;
+
     // Initialize the scene data
     static Render2DStorage* s_Data;
 
+    // Batches of flat colored quads use the base program, which skips the texture fetch entirely
+    static const char* s_TexturedVariant = "TEXTURED";
+
+    static void UseShader(const Ref<Shader>& shader, bool textured)
+    {
+        shader->SetVariant(textured ? s_TexturedVariant : "");
+        shader->Bind(); // uniforms go to the bound program
+    }
+
+    static void UseQuadShader(bool textured)
+    {
+        UseShader(s_Data->QuadShader, textured);
+    }
+
+    static void StartBatch()
+    {
+        s_Data->QuadCount = 0;
+        s_Data->TextureSlotIndex = 1;
+        s_Data->BatchIndex++;
+    }
+
+    static void FlushBatch(RendererStats::FlushReason reason);
+
+    static void NextBatch(RendererStats::FlushReason reason)
+    {
+        FlushBatch(reason);
+        StartBatch();
+    }
+
+    static void SetTextureSamplers(const Ref<Shader>& shader)
+    {
+        int samplers[Render2DStorage::MaxTextureSlots];
+        for (uint32_t i = 0; i < Render2DStorage::MaxTextureSlots; i++)
+            samplers[i] = static_cast<int>(i);
+
+        UseShader(shader, true);
+        shader->SetIntArray("u_Textures", samplers, Render2DStorage::MaxTextureSlots);
+    }
+
     void Renderer2D::Init()
     {
         MK_PROFILE_FUNCTION(); // Profiling
@@ -28,36 +148,69 @@ namespace Mashenka
 
         s_Data->QuadVertexArray = VertexArray::Create();
 
-        float squareVertices[5 * 4] = {
-            -0.5f, -0.5f, 0.0f, 0.0f, 0.0f, // 0
-            0.5f, -0.5f, 0.0f, 1.0f, 0.0f, // 1
-            0.5f, 0.5f, 0.0f, 1.0f, 1.0f, // 2
-            -0.5f, 0.5f, 0.0f, 0.0f, 1.0f // 3
-        };
-
-        // Create the vertex buffer
-        Ref<VertexBuffer> squareVB = VertexBuffer::Create(squareVertices, sizeof(squareVertices));
-        BufferLayout layout = {
+        // Create the vertex buffer, refilled for every batch
+        s_Data->QuadVertexBuffer = VertexBuffer::Create(Render2DStorage::MaxVertices * sizeof(QuadVertex));
+        s_Data->QuadVertexLayout = {
             {ShaderDataType::Float3, "a_Position"},
-            {ShaderDataType::Float2, "a_TexCoord"}
+            {ShaderDataType::Float4, "a_Color"},
+            {ShaderDataType::Float2, "a_TexCoord"},
+            {ShaderDataType::Float, "a_TexIndex"},
+            {ShaderDataType::Float, "a_TilingFactor"}
         };
-        squareVB->SetLayout(layout);
-        s_Data->QuadVertexArray->AddVertexBuffer(squareVB);
+        s_Data->QuadVertexBuffer->SetLayout(s_Data->QuadVertexLayout);
+        s_Data->QuadVertexArray->AddVertexBuffer(s_Data->QuadVertexBuffer);
 
-        // Create the index buffer
-        uint32_t squareIndices[6] = {0, 1, 2, 2, 3, 0};
-        Ref<IndexBuffer> squareIB = IndexBuffer::Create(squareIndices, sizeof(squareIndices) / sizeof(uint32_t));
-        s_Data->QuadVertexArray->SetIndexBuffer(squareIB);
+        // Create the index buffer, the same two triangles for every quad
+        std::vector<uint32_t> quadIndices(Render2DStorage::MaxIndices);
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < Render2DStorage::MaxIndices; i += 6, offset += 4)
+        {
+            quadIndices[i + 0] = offset + 0;
+            quadIndices[i + 1] = offset + 1;
+            quadIndices[i + 2] = offset + 2;
+            quadIndices[i + 3] = offset + 2;
+            quadIndices[i + 4] = offset + 3;
+            quadIndices[i + 5] = offset + 0;
+        }
+        Ref<IndexBuffer> quadIB = IndexBuffer::Create(quadIndices.data(), Render2DStorage::MaxIndices);
+        s_Data->QuadVertexArray->SetIndexBuffer(quadIB);
 
-        // Create the shaders
+        // Vertex pulling shares the index buffer, gl_VertexID / 4 is the quad and gl_VertexID % 4 the corner
+        s_Data->QuadInstanceBuffer = StorageBuffer::Create(Render2DStorage::MaxQuads * sizeof(QuadInstance));
+        s_Data->PulledQuadVertexArray = VertexArray::Create();
+        s_Data->PulledQuadVertexArray->SetIndexBuffer(quadIB);
+
+        // Staging for the batch
+        for (auto* attribute : {&s_Data->PositionX, &s_Data->PositionY, &s_Data->PositionZ, &s_Data->SizeX,
+                                &s_Data->SizeY, &s_Data->Rotation, &s_Data->TexIndex, &s_Data->TilingFactor})
+            attribute->resize(Render2DStorage::MaxQuads);
+        s_Data->Color.resize(Render2DStorage::MaxQuads);
+        s_Data->Visible.resize(Render2DStorage::MaxQuads);
+        s_Data->QuadVertices.resize(Render2DStorage::MaxVertices);
+        s_Data->QuadInstances.resize(Render2DStorage::MaxQuads);
+        for (uint32_t i = 0; i <= JobSystem::GetWorkerCount(); i++)
+            s_Data->ThreadBuffers.push_back(CreateScope<ThreadQuadBuffer>());
+
+        // Create the white texture
         s_Data->WhiteTexture = Texture2D::Create(1, 1);
         uint32_t whiteTextureData = 0xffffffff; // white
         s_Data->WhiteTexture->SetData(&whiteTextureData, sizeof(uint32_t));
+        s_Data->TextureSlots[0] = s_Data->WhiteTexture;
 
-        s_Data->TextureShader = Shader::Create("assets/shaders/Texture.glsl");
-        s_Data->TextureShader->Bind();
-        s_Data->TextureShader->SetInt("u_Texture", 0);
-        // set the texture slot to 0, because we will always use slot 0 for textures
+        // Create the shaders
+        s_Data->QuadShader = s_Data->Shaders.Load("assets/shaders/Renderer2D_Quad.glsl");
+        s_Data->PulledQuadShader = s_Data->Shaders.Load("assets/shaders/Renderer2D_QuadPulled.glsl");
+        s_Data->ParticleShader = s_Data->Shaders.Load("assets/shaders/Renderer2D_Particle.glsl");
+        s_Data->GPUParticleShader = s_Data->Shaders.Load("assets/shaders/Renderer2D_GPUParticle.glsl");
+#ifdef MK_DEBUG
+        // pick up shader edits while the application runs
+        s_Data->Shaders.EnableHotReload("assets/shaders");
+#endif
+        MK_CORE_ASSERT(s_Data->QuadShader->HasVariant(s_TexturedVariant), "Quad shader has no TEXTURED variant!");
+        MK_CORE_ASSERT(s_Data->PulledQuadShader->HasVariant(s_TexturedVariant),
+                       "Pulled quad shader has no TEXTURED variant!");
+        SetTextureSamplers(s_Data->QuadShader);
+        SetTextureSamplers(s_Data->PulledQuadShader);
     }
 
     void Renderer2D::Shutdown()
@@ -69,13 +222,524 @@ namespace Mashenka
     void Renderer2D::BeginScene(const OrthographicCamera& camera)
     {
         MK_PROFILE_FUNCTION(); // Profiling
-        s_Data->TextureShader->Bind();
-        s_Data->TextureShader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+        // a reloaded shader comes with fresh programs, the sampler slots have to be set again
+        for (const auto& shader : s_Data->Shaders.Update())
+        {
+            if (shader == s_Data->QuadShader || shader == s_Data->PulledQuadShader)
+                SetTextureSamplers(shader);
+        }
+
+        // every variant is its own program with its own uniforms
+        for (const Ref<Shader>& shader : {s_Data->QuadShader, s_Data->PulledQuadShader})
+        {
+            for (bool textured : {false, true})
+            {
+                UseShader(shader, textured);
+                shader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+            }
+        }
+        s_Data->ParticleShader->Bind();
+        s_Data->ParticleShader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+        s_Data->GPUParticleShader->Bind();
+        s_Data->GPUParticleShader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+
+        s_Data->CameraBounds = Bounds2D::FromViewProjection(camera.GetViewProjectionMatrix());
+        RendererStats::BeginScene();
+        StartBatch();
     }
 
+    static void MergeThreadQuads();
+
     void Renderer2D::EndScene()
     {
         MK_PROFILE_FUNCTION(); // Profiling
+        MergeThreadQuads();
+        FlushBatch(RendererStats::FlushReason::EndScene);
+    }
+
+    // The quads of the batch from first on
+    static QuadKernelInput GetBatchInput(uint32_t first = 0)
+    {
+        QuadKernelInput input;
+        input.PositionX = s_Data->PositionX.data() + first;
+        input.PositionY = s_Data->PositionY.data() + first;
+        input.PositionZ = s_Data->PositionZ.data() + first;
+        input.SizeX = s_Data->SizeX.data() + first;
+        input.SizeY = s_Data->SizeY.data() + first;
+        input.Rotation = s_Data->Rotation.data() + first;
+        input.Color = s_Data->Color.data() + first;
+        input.TexIndex = s_Data->TexIndex.data() + first;
+        input.TilingFactor = s_Data->TilingFactor.data() + first;
+        return input;
+    }
+
+    // Test the whole batch against the camera bounds and move the visible quads to the front
+    static void CullBatch()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        uint32_t count = s_Data->QuadCount;
+        uint8_t* visible = s_Data->Visible.data();
+        std::atomic<uint32_t> visibleQuads{0};
+        JobSystem::ParallelFor(count, s_QuadsPerJob, [&](uint32_t begin, uint32_t end)
+        {
+            visibleQuads += Culling::TestQuads(s_Data->CameraBounds, GetBatchInput(begin), end - begin,
+                                               visible + begin);
+        });
+        uint32_t visibleCount = visibleQuads;
+        RendererStats::AddQuads(0, count - visibleCount);
+        if (visibleCount == count)
+            return;
+
+        uint32_t write = 0;
+        for (uint32_t read = 0; read < count; read++)
+        {
+            if (!visible[read])
+                continue;
+            if (write != read)
+            {
+                s_Data->PositionX[write] = s_Data->PositionX[read];
+                s_Data->PositionY[write] = s_Data->PositionY[read];
+                s_Data->PositionZ[write] = s_Data->PositionZ[read];
+                s_Data->SizeX[write] = s_Data->SizeX[read];
+                s_Data->SizeY[write] = s_Data->SizeY[read];
+                s_Data->Rotation[write] = s_Data->Rotation[read];
+                s_Data->Color[write] = s_Data->Color[read];
+                s_Data->TexIndex[write] = s_Data->TexIndex[read];
+                s_Data->TilingFactor[write] = s_Data->TilingFactor[read];
+            }
+            write++;
+        }
+        s_Data->QuadCount = visibleCount;
+    }
+
+    // Generate, upload and draw the staged quads
+    static void FlushBatch(RendererStats::FlushReason reason)
+    {
+        if (s_Data->QuadCount == 0)
+            return;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (s_Data->CullingEnabled)
+        {
+            CullBatch();
+            if (s_Data->QuadCount == 0)
+                return;
+        }
+
+        RendererStats::AddQuads(s_Data->QuadCount, 0);
+        RendererStats::AddBatchFlush(reason);
+
+        Ref<VertexArray> vertexArray;
+        if (s_Data->VertexPulling)
+        {
+            // One instance per quad, the vertex shader builds the corners
+            JobSystem::ParallelFor(s_Data->QuadCount, s_QuadsPerJob, [](uint32_t begin, uint32_t end)
+            {
+                MK_PROFILE_SCOPE("QuadKernel::Pack");
+                QuadKernel::Pack(GetBatchInput(begin), end - begin, s_Data->QuadInstances.data() + begin);
+            });
+            s_Data->QuadInstanceBuffer->SetData(s_Data->QuadInstances.data(),
+                                                s_Data->QuadCount * sizeof(QuadInstance));
+            s_Data->QuadInstanceBuffer->Bind(0);
+            vertexArray = s_Data->PulledQuadVertexArray;
+        }
+        else
+        {
+            // Generate the vertices of the whole batch at once, split over the cores
+            JobSystem::ParallelFor(s_Data->QuadCount, s_QuadsPerJob, [](uint32_t begin, uint32_t end)
+            {
+                MK_PROFILE_SCOPE("QuadKernel::Transform");
+                QuadKernel::Transform(GetBatchInput(begin), end - begin, s_Data->QuadVertices.data() + begin * 4);
+            });
+            s_Data->QuadVertexBuffer->SetData(s_Data->QuadVertices.data(),
+                                              s_Data->QuadCount * 4 * sizeof(QuadVertex));
+            vertexArray = s_Data->QuadVertexArray;
+        }
+
+        // A batch that only uses the white texture is drawn with the cheaper flat color program
+        bool textured = s_Data->TextureSlotIndex > 1;
+        UseShader(s_Data->VertexPulling ? s_Data->PulledQuadShader : s_Data->QuadShader, textured);
+        if (textured)
+        {
+            for (uint32_t i = 0; i < s_Data->TextureSlotIndex; i++)
+                s_Data->TextureSlots[i]->Bind(i);
+        }
+
+        MK_PROFILE_GPU_SCOPE("Renderer2D Batch");
+        vertexArray->Bind();
+        RenderCommand::DrawIndexed(vertexArray, s_Data->QuadCount * 6);
+    }
+
+    void Renderer2D::Flush()
+    {
+        MergeThreadQuads();
+        // start over, the flushed quads must not be drawn again by the next flush
+        NextBatch(RendererStats::FlushReason::Manual);
+    }
+
+    void Renderer2D::DrawTileMap(TileMap& tileMap)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // keep the draw order, the quads submitted before go first
+        MergeThreadQuads();
+        NextBatch(RendererStats::FlushReason::RetainedDraw);
+
+        const Ref<Texture2D>& tileset = tileMap.GetTileset();
+        UseQuadShader(tileset != nullptr);
+        if (tileset)
+            tileset->Bind(0);
+
+        MK_PROFILE_GPU_SCOPE("Renderer2D TileMap");
+        tileMap.Draw(s_Data->CameraBounds);
+    }
+
+    void Renderer2D::DrawSpriteBatch(SpriteBatch& spriteBatch)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        MergeThreadQuads();
+        NextBatch(RendererStats::FlushReason::RetainedDraw);
+
+        UseQuadShader(spriteBatch.HasTextures());
+        if (spriteBatch.HasTextures())
+            s_Data->WhiteTexture->Bind(0);
+
+        MK_PROFILE_GPU_SCOPE("Renderer2D SpriteBatch");
+        spriteBatch.Draw();
+    }
+
+    void Renderer2D::DrawParticles(ParticleSystem& particleSystem)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        MergeThreadQuads();
+        NextBatch(RendererStats::FlushReason::RetainedDraw);
+
+        s_Data->ParticleShader->Bind();
+        s_Data->ParticleShader->SetFloat("u_Depth", particleSystem.GetDepth());
+
+        MK_PROFILE_GPU_SCOPE("Renderer2D Particles");
+        particleSystem.Draw();
+    }
+
+    void Renderer2D::DrawParticles(GPUParticleSystem& particleSystem)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        MergeThreadQuads();
+        NextBatch(RendererStats::FlushReason::RetainedDraw);
+
+        s_Data->GPUParticleShader->Bind();
+        s_Data->GPUParticleShader->SetFloat("u_Depth", particleSystem.GetDepth());
+
+        MK_PROFILE_GPU_SCOPE("Renderer2D GPU Particles");
+        particleSystem.Draw();
+    }
+
+    const BufferLayout& Renderer2D::GetQuadVertexLayout()
+    {
+        return s_Data->QuadVertexLayout;
+    }
+
+    const Ref<IndexBuffer>& Renderer2D::GetQuadIndexBuffer()
+    {
+        return s_Data->QuadVertexArray->GetIndexBuffer();
+    }
+
+    void Renderer2D::SetCullingEnabled(bool enabled)
+    {
+        s_Data->CullingEnabled = enabled;
+    }
+
+    bool Renderer2D::IsCullingEnabled()
+    {
+        return s_Data->CullingEnabled;
+    }
+
+    void Renderer2D::SetVertexPullingEnabled(bool enabled)
+    {
+        // applies from the next flush on, the staged quads don't depend on it
+        s_Data->VertexPulling = enabled;
+    }
+
+    bool Renderer2D::IsVertexPullingEnabled()
+    {
+        return s_Data->VertexPulling;
+    }
+
+    const Bounds2D& Renderer2D::GetCameraBounds()
+    {
+        return s_Data->CameraBounds;
+    }
+
+    // Slot of the texture in the current batch, MaxTextureSlots when it is not in the batch and all the slots are taken
+    static uint32_t AssignTextureSlot(const Ref<Texture2D>& texture)
+    {
+        for (uint32_t i = 1; i < s_Data->TextureSlotIndex; i++)
+        {
+            if (s_Data->TextureSlots[i].get() == texture.get())
+                return i;
+        }
+
+        if (s_Data->TextureSlotIndex == Render2DStorage::MaxTextureSlots)
+            return Render2DStorage::MaxTextureSlots;
+
+        uint32_t slot = s_Data->TextureSlotIndex++;
+        s_Data->TextureSlots[slot] = texture;
+        return slot;
+    }
+
+    // Slot of the texture in the current batch, starts a new batch when all the slots are taken
+    static float GetTextureSlot(const Ref<Texture2D>& texture)
+    {
+        uint32_t slot = AssignTextureSlot(texture);
+        if (slot == Render2DStorage::MaxTextureSlots)
+        {
+            NextBatch(RendererStats::FlushReason::TextureSlots);
+            slot = AssignTextureSlot(texture);
+        }
+        return static_cast<float>(slot);
+    }
+
+    // Stage a quad for the kernel, a null texture draws a flat colored quad
+    static void StageQuad(const glm::vec3& position, const glm::vec2& size, float rotation, const glm::vec4& color,
+                          const Ref<Texture2D>& texture, float tilingFactor)
+    {
+        if (s_Data->QuadCount == Render2DStorage::MaxQuads)
+            NextBatch(RendererStats::FlushReason::QuadLimit);
+        // slot 0 is the white texture
+        float texIndex = texture ? GetTextureSlot(texture) : 0.0f;
+
+        uint32_t i = s_Data->QuadCount++;
+        s_Data->PositionX[i] = position.x;
+        s_Data->PositionY[i] = position.y;
+        s_Data->PositionZ[i] = position.z;
+        s_Data->SizeX[i] = size.x;
+        s_Data->SizeY[i] = size.y;
+        s_Data->Rotation[i] = rotation;
+        s_Data->Color[i] = color;
+        s_Data->TexIndex[i] = texIndex;
+        s_Data->TilingFactor[i] = tilingFactor;
+    }
+
+    // The buffer the calling thread records into, null when it is not between Begin/EndThreadSubmission
+    static ThreadQuadBuffer* GetRecordingBuffer()
+    {
+        uint32_t thread = JobSystem::GetThreadIndex();
+        if (thread >= s_Data->ThreadBuffers.size())
+            return nullptr;
+        ThreadQuadBuffer* buffer = s_Data->ThreadBuffers[thread].get();
+        return buffer->SortKeys.empty() ? nullptr : buffer;
+    }
+
+    static void RecordQuad(ThreadQuadBuffer& buffer, const glm::vec3& position, const glm::vec2& size, float rotation,
+                           const glm::vec4& color, const Ref<Texture2D>& texture, float tilingFactor)
+    {
+        uint32_t textureIndex = 0;
+        if (texture)
+        {
+            // Fibonacci hashing, the top 6 bits of the product pick the cache entry
+            auto hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(texture.get())) * 0x9E3779B97F4A7C15ull;
+            auto& cached = buffer.TextureCache[hash >> 58];
+            if (cached.first != texture.get())
+            {
+                auto next = static_cast<uint32_t>(buffer.Textures.size());
+                auto [entry, inserted] = buffer.TextureIndices.try_emplace(texture.get(), next);
+                if (inserted)
+                    buffer.Textures.push_back(texture);
+                cached = {texture.get(), entry->second};
+            }
+            textureIndex = cached.second;
+        }
+        buffer.Quads.push_back({position, size, rotation, color, textureIndex, tilingFactor});
+    }
+
+    static void SubmitQuad(const glm::vec3& position, const glm::vec2& size, float rotation, const glm::vec4& color,
+                           const Ref<Texture2D>& texture, float tilingFactor)
+    {
+        if (ThreadQuadBuffer* buffer = GetRecordingBuffer())
+            RecordQuad(*buffer, position, size, rotation, color, texture, tilingFactor);
+        else
+            StageQuad(position, size, rotation, color, texture, tilingFactor);
+    }
+
+    static void OpenRun(ThreadQuadBuffer& buffer, uint64_t sortKey)
+    {
+        auto first = static_cast<uint32_t>(buffer.Quads.size());
+        buffer.Runs.push_back({sortKey, first, first});
+    }
+
+    static void CloseRun(ThreadQuadBuffer& buffer)
+    {
+        buffer.Runs.back().End = static_cast<uint32_t>(buffer.Quads.size());
+        if (buffer.Runs.back().Begin == buffer.Runs.back().End)
+            buffer.Runs.pop_back();
+    }
+
+    void Renderer2D::BeginThreadSubmission(uint64_t sortKey)
+    {
+        uint32_t thread = JobSystem::GetThreadIndex();
+        MK_CORE_ASSERT(thread < s_Data->ThreadBuffers.size(), "Thread submission from a thread outside of the JobSystem!");
+        ThreadQuadBuffer& buffer = *s_Data->ThreadBuffers[thread];
+        // a nested submission interrupts the outer run, it goes on under its key afterwards
+        if (!buffer.SortKeys.empty())
+            CloseRun(buffer);
+        buffer.SortKeys.push_back(sortKey);
+        OpenRun(buffer, sortKey);
+    }
+
+    void Renderer2D::EndThreadSubmission()
+    {
+        ThreadQuadBuffer* buffer = GetRecordingBuffer();
+        MK_CORE_ASSERT(buffer, "EndThreadSubmission without BeginThreadSubmission!");
+        CloseRun(*buffer);
+        buffer->SortKeys.pop_back();
+        if (!buffer->SortKeys.empty())
+            OpenRun(*buffer, buffer->SortKeys.back());
+    }
+
+    void Renderer2D::ParallelSubmit(uint32_t count, uint32_t grainSize,
+                                    const std::function<void(uint32_t, uint32_t)>& body)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (count <= grainSize || JobSystem::GetWorkerCount() == 0)
+        {
+            body(0, count); // one range, straight into the batch
+            return;
+        }
+        MK_CORE_ASSERT(JobSystem::GetThreadIndex() == 0, "ParallelSubmit must be called from the main thread!");
+
+        // the first element of a range is its key, so merging gives the order of one loop over [0, count)
+        JobSystem::ParallelFor(count, grainSize, [&body](uint32_t begin, uint32_t end)
+        {
+            BeginThreadSubmission(begin);
+            body(begin, end);
+            EndThreadSubmission();
+        });
+        MergeThreadQuads();
+    }
+
+    // Recorded quads [Source, Source + Count) of one buffer, staged at [Target, Target + Count) of the batch
+    struct MergePiece
+    {
+        const ThreadQuadBuffer* Buffer;
+        uint32_t Source, Target, Count;
+    };
+
+    // Copy the planned pieces into the batch, split over the cores. Their texture slots are already staged
+    static void StagePieces(std::vector<MergePiece>& pieces)
+    {
+        if (pieces.empty())
+            return;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        uint32_t first = pieces.front().Target;
+        uint32_t count = pieces.back().Target + pieces.back().Count - first;
+        JobSystem::ParallelFor(count, s_QuadsPerJob, [&pieces, first](uint32_t begin, uint32_t end)
+        {
+            begin += first;
+            end += first;
+            // the pieces are in batch order, start at the last one that begins before this range
+            auto piece = std::upper_bound(pieces.begin(), pieces.end(), begin,
+                                          [](uint32_t target, const MergePiece& p) { return target < p.Target; }) - 1;
+            for (; piece != pieces.end() && piece->Target < end; ++piece)
+            {
+                uint32_t from = std::max(begin, piece->Target), to = std::min(end, piece->Target + piece->Count);
+                const RecordedQuad* quads = piece->Buffer->Quads.data() + piece->Source;
+                for (uint32_t i = from; i < to; i++)
+                {
+                    const RecordedQuad& quad = quads[i - piece->Target];
+                    s_Data->PositionX[i] = quad.Position.x;
+                    s_Data->PositionY[i] = quad.Position.y;
+                    s_Data->PositionZ[i] = quad.Position.z;
+                    s_Data->SizeX[i] = quad.Size.x;
+                    s_Data->SizeY[i] = quad.Size.y;
+                    s_Data->Rotation[i] = quad.Rotation;
+                    s_Data->Color[i] = quad.Color;
+                    s_Data->TilingFactor[i] = quad.TilingFactor;
+                }
+            }
+        });
+        pieces.clear();
+    }
+
+    // Stage the quads the threads recorded, by sort key. Runs of the same key keep the order of their thread
+    // Only the batch breaks and texture slots are worked out quad by quad here, from the texture indices alone,
+    // the other attributes are copied by StagePieces on every core
+    static void MergeThreadQuads()
+    {
+        std::vector<std::pair<const RecordedRun*, ThreadQuadBuffer*>> runs;
+        for (auto& buffer : s_Data->ThreadBuffers)
+        {
+            MK_CORE_ASSERT(buffer->SortKeys.empty(), "A thread is still submitting quads, wait for its jobs first!");
+            for (const RecordedRun& run : buffer->Runs)
+                runs.emplace_back(&run, buffer.get());
+        }
+        if (runs.empty())
+            return;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        std::stable_sort(runs.begin(), runs.end(), [](const auto& a, const auto& b)
+        {
+            return a.first->SortKey < b.first->SortKey;
+        });
+        for (auto& buffer : s_Data->ThreadBuffers)
+        {
+            // no entry has a slot in the current batch yet
+            buffer->MergeSlots.resize(buffer->Textures.size());
+            buffer->MergeBatches.assign(buffer->Textures.size(), s_Data->BatchIndex - 1);
+        }
+
+        std::vector<MergePiece> pieces;
+        for (auto [run, buffer] : runs)
+        {
+            uint32_t pieceBegin = run->Begin;
+            // a new batch ends the piece, its quads have to be staged before the batch is flushed
+            auto startBatch = [&, buffer = buffer](uint32_t i, RendererStats::FlushReason reason)
+            {
+                uint32_t count = i - pieceBegin;
+                if (count > 0)
+                    pieces.push_back({buffer, pieceBegin, s_Data->QuadCount - count, count});
+                StagePieces(pieces);
+                NextBatch(reason);
+                pieceBegin = i;
+            };
+
+            for (uint32_t i = run->Begin; i < run->End; i++)
+            {
+                if (s_Data->QuadCount == Render2DStorage::MaxQuads)
+                    startBatch(i, RendererStats::FlushReason::QuadLimit);
+
+                uint32_t texture = buffer->Quads[i].Texture;
+                uint32_t slot = 0; // the white texture
+                if (texture != 0)
+                {
+                    if (buffer->MergeBatches[texture] != s_Data->BatchIndex)
+                    {
+                        slot = AssignTextureSlot(buffer->Textures[texture]);
+                        if (slot == Render2DStorage::MaxTextureSlots)
+                        {
+                            startBatch(i, RendererStats::FlushReason::TextureSlots);
+                            slot = AssignTextureSlot(buffer->Textures[texture]);
+                        }
+                        buffer->MergeSlots[texture] = slot;
+                        buffer->MergeBatches[texture] = s_Data->BatchIndex;
+                    }
+                    slot = buffer->MergeSlots[texture];
+                }
+                s_Data->TexIndex[s_Data->QuadCount++] = static_cast<float>(slot);
+            }
+            uint32_t rest = run->End - pieceBegin;
+            if (rest > 0)
+                pieces.push_back({buffer, pieceBegin, s_Data->QuadCount - rest, rest});
+        }
+        StagePieces(pieces);
+
+        for (auto& buffer : s_Data->ThreadBuffers)
+        {
+            buffer->Quads.clear();
+            buffer->Runs.clear();
+            buffer->Textures.resize(1);
+            buffer->TextureIndices.clear();
+            buffer->TextureCache.fill({nullptr, 0});
+        }
     }
 
     void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
@@ -86,18 +750,7 @@ namespace Mashenka
     void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color)
     {
         MK_PROFILE_FUNCTION(); // Profiling
-        s_Data->TextureShader->SetFloat4("u_Color", color); // set the color
-        s_Data->TextureShader->SetFloat("u_TilingFactor", 1.0f);
-        s_Data->WhiteTexture->Bind(); // bind the texture
-
-        // Create the transformation matrix
-        glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(
-            glm::mat4(1.0f), {size.x, size.y, 1.0f});
-        s_Data->TextureShader->SetMat4("u_Transform", transform); // set the transformation matrix
-
-        // Draw the quad
-        s_Data->QuadVertexArray->Bind();
-        RenderCommand::DrawIndexed(s_Data->QuadVertexArray);
+        SubmitQuad(position, size, 0.0f, color, nullptr, 1.0f);
     }
 
     void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const Ref<Texture2D>& texture,
@@ -110,16 +763,7 @@ namespace Mashenka
                               float tilingFactor, const glm::vec4& tintColor)
     {
         MK_PROFILE_FUNCTION(); // Profiling
-        s_Data->TextureShader->SetFloat4("u_Color", tintColor);
-        s_Data->TextureShader->SetFloat("u_TilingFactor", tilingFactor);
-        texture->Bind(); // bind the texture
-
-        glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(
-            glm::mat4(1.0f), glm::vec3(size.x, size.y, 1.0f));
-        s_Data->TextureShader->SetMat4("u_Transform", transform);
-
-        s_Data->QuadVertexArray->Bind();
-        RenderCommand::DrawIndexed(s_Data->QuadVertexArray);
+        SubmitQuad(position, size, 0.0f, tintColor, texture, tilingFactor);
     }
 
     void Renderer2D::DrawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation,
@@ -132,18 +776,7 @@ namespace Mashenka
                                      const glm::vec4& color)
     {
         MK_PROFILE_FUNCTION();
-
-        s_Data->TextureShader->SetFloat("u_TilingFactor", 1.0f);
-        s_Data->TextureShader->SetFloat4("u_Color", color);
-        s_Data->WhiteTexture->Bind();
-
-        glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
-            * glm::rotate(glm::mat4(1.0f), rotation, {0.0f, 0.0f, 1.0f}) * glm::scale(
-                glm::mat4(1.0f), {size.x, size.y, 1.0f});
-
-        s_Data->TextureShader->SetMat4("u_Transform", transform);
-        s_Data->QuadVertexArray->Bind();
-        RenderCommand::DrawIndexed(s_Data->QuadVertexArray);
+        SubmitQuad(position, size, rotation, color, nullptr, 1.0f);
     }
 
     void Renderer2D::DrawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation,
@@ -156,16 +789,6 @@ namespace Mashenka
                                      const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor)
     {
         MK_PROFILE_FUNCTION();
-
-        s_Data->TextureShader->SetFloat("u_TilingFactor", tilingFactor);
-        s_Data->TextureShader->SetFloat4("u_Color", tintColor);
-        texture->Bind(); // bind the texture
-
-        glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
-            * glm::rotate(glm::mat4(1.0f), rotation, {0.0f, 0.0f, 1.0f}) * glm::scale(
-                glm::mat4(1.0f), {size.x, size.y, 1.0f});
-        s_Data->TextureShader->SetMat4("u_Transform", transform);
-        s_Data->QuadVertexArray->Bind();
-        RenderCommand::DrawIndexed(s_Data->QuadVertexArray);
+        SubmitQuad(position, size, rotation, tintColor, texture, tilingFactor);
     }
 }
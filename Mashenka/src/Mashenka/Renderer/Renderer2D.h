@@ -1,6 +1,12 @@
 ﻿#pragma once
 #include "Mashenka/Renderer/OrthographicCamera.h"
 #include "Mashenka/Renderer/Texture.h"
+#include "Mashenka/Renderer/Culling.h"
+#include "Mashenka/Renderer/RendererStats.h"
+#include "Mashenka/Renderer/TileMap.h"
+#include "Mashenka/Renderer/SpriteBatch.h"
+#include "Mashenka/Renderer/ParticleSystem.h"
+#include "Mashenka/Renderer/GPUParticleSystem.h"
 
 namespace Mashenka
 {
@@ -13,6 +19,19 @@ namespace Mashenka
         static void Shutdown();
         static void BeginScene(const OrthographicCamera& camera);
         static void EndScene();
+        // Draw the quads submitted so far, EndScene flushes the last batch
+        static void Flush();
+
+        // Quads whose bounds miss the camera are dropped before their vertices are generated, on by default
+        static void SetCullingEnabled(bool enabled);
+        static bool IsCullingEnabled();
+        // World space bounds of the camera given to BeginScene, user code can cull against them as well
+        static const Bounds2D& GetCameraBounds();
+
+        // Upload one 32 byte instance per quad and build the corners in the vertex shader, instead of 4 full
+        // vertices per quad. Off by default, it needs storage buffers (OpenGL 4.3)
+        static void SetVertexPullingEnabled(bool enabled);
+        static bool IsVertexPullingEnabled();
 
         //primitive rendering functions:
         static void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
@@ -40,5 +59,31 @@ namespace Mashenka
         static void DrawRotatedQuad(const glm::vec3& position, const glm::vec2& size, float rotation,
                                     const Ref<Texture2D>& texture, float tilingFactor = 1.0f,
                                     const glm::vec4& tintColor = glm::vec4(1.0f));
+
+        // Multithreaded submission:
+        // Between BeginThreadSubmission and EndThreadSubmission the draw functions above, called on a thread of the
+        // JobSystem, record into a buffer of that thread without any locking. The buffers are merged by sort key at
+        // the next EndScene, Flush or retained draw, after the quads the main thread drew directly in the meantime
+        // Quads of the same key keep their order, so the draw order is deterministic as long as every key is used by
+        // one thread only. The jobs must be done before the merge
+        static void BeginThreadSubmission(uint64_t sortKey);
+        static void EndThreadSubmission();
+        // Calls body(begin, end) for ranges of [0, count) on the JobSystem, see JobSystem::ParallelFor. The quads the
+        // ranges draw come out in the same order as from one loop over [0, count), right after the quads drawn before
+        static void ParallelSubmit(uint32_t count, uint32_t grainSize,
+                                   const std::function<void(uint32_t, uint32_t)>& body);
+
+        // Draws the chunks of the tile map that intersect the camera bounds, after the quads submitted so far
+        static void DrawTileMap(TileMap& tileMap);
+        // Draws the retained sprites, after the quads submitted so far
+        static void DrawSpriteBatch(SpriteBatch& spriteBatch);
+        // Draws every live particle in one instanced draw call, after the quads submitted so far
+        static void DrawParticles(ParticleSystem& particleSystem);
+        // Draws the particles simulated on the GPU with one indirect draw call, after the quads submitted so far
+        static void DrawParticles(GPUParticleSystem& particleSystem);
+
+        // For retained geometry drawn with the quad shader, vertices are QuadVertex and every quad uses 6 indices
+        static const BufferLayout& GetQuadVertexLayout();
+        static const Ref<IndexBuffer>& GetQuadIndexBuffer();
     };
 }
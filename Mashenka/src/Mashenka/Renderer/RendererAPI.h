@@ -28,7 +28,17 @@ namespace Mashenka
         virtual void SetClearColor(const glm::vec4& color) = 0;
         virtual void Clear() = 0;
 
-        virtual void DrawIndexed(const Ref<VertexArray>& vertexArray) = 0;
+        // indexCount 0 draws the whole index buffer
+        virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) = 0;
+        // draws the indices instanceCount times, per instance attributes advance for every instance
+        virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount,
+                                          uint32_t instanceCount) = 0;
+        // the draw parameters come from a DrawElementsIndirectCommand in the buffer, written by the GPU
+        virtual void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<StorageBuffer>& commands,
+                                         uint32_t offset = 0) = 0;
+        // drawCount consecutive DrawIndexedIndirectCommand from the buffer in one call, offset is in bytes
+        virtual void MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<StorageBuffer>& commands,
+                                              uint32_t drawCount, uint32_t offset = 0) = 0;
 
         inline static API GetAPI() { return s_API; }
         static Scope<RendererAPI> Create();
@@ -0,0 +1,83 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/RendererStats.h"
+
+namespace Mashenka
+{
+    static RendererStats::Statistics s_Stats;
+    // the stats of the previous frame stay readable until the first scene of the next frame begins
+    static bool s_FirstScene = true;
+
+    void RendererStats::BeginFrame()
+    {
+        s_FirstScene = true;
+    }
+
+    void RendererStats::BeginScene()
+    {
+        if (!s_FirstScene)
+            return;
+
+        ResetStats();
+        s_FirstScene = false;
+    }
+
+    void RendererStats::AddDrawCall(uint32_t indexCount)
+    {
+        s_Stats.DrawCalls++;
+        s_Stats.IndexCount += indexCount;
+    }
+
+    void RendererStats::AddQuads(uint32_t drawn, uint32_t culled)
+    {
+        s_Stats.QuadCount += drawn;
+        s_Stats.VertexCount += drawn * 4;
+        s_Stats.CulledQuadCount += culled;
+    }
+
+    void RendererStats::AddTextureBind()
+    {
+        s_Stats.TextureBinds++;
+    }
+
+    void RendererStats::AddShaderBind()
+    {
+        s_Stats.ShaderBinds++;
+    }
+
+    void RendererStats::AddBufferUpload(uint64_t bytes)
+    {
+        s_Stats.BufferBytesUploaded += bytes;
+    }
+
+    void RendererStats::AddBatchFlush(FlushReason reason)
+    {
+        s_Stats.BatchesFlushed++;
+        s_Stats.FlushReasons[static_cast<size_t>(reason)]++;
+    }
+
+    const RendererStats::Statistics& RendererStats::GetStats()
+    {
+        return s_Stats;
+    }
+
+    void RendererStats::ResetStats()
+    {
+        s_Stats = Statistics();
+    }
+
+    const char* RendererStats::GetFlushReasonName(FlushReason reason)
+    {
+        switch (reason)
+        {
+        case FlushReason::EndScene: return "EndScene";
+        case FlushReason::QuadLimit: return "Quad limit";
+        case FlushReason::TextureSlots: return "Texture slots";
+        case FlushReason::Manual: return "Manual";
+        case FlushReason::RetainedDraw: return "Retained draw";
+        default: break;
+        }
+
+        MK_CORE_ASSERT(false, "Unknown flush reason!");
+        return "";
+    }
+}
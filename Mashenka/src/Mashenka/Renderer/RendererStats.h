@@ -0,0 +1,56 @@
+﻿#pragma once
+
+namespace Mashenka
+{
+    /*
+     * RendererStats Class
+     * Counters of what Renderer, Renderer2D and the graphics API did, reset by the first BeginScene of a frame
+     * so every scene of the frame is included. Read them from any Layer::OnImGuiRender, after the layers updated
+     */
+    class RendererStats
+    {
+    public:
+        // Why Renderer2D drew a batch
+        enum class FlushReason
+        {
+            EndScene = 0,
+            QuadLimit, // the vertex buffer was full
+            TextureSlots, // every texture slot was taken
+            Manual, // Renderer2D::Flush was called by the user
+            RetainedDraw, // a TileMap, SpriteBatch or ParticleSystem is drawn in between
+            Count
+        };
+
+        struct Statistics
+        {
+            uint32_t DrawCalls = 0;
+            uint32_t VertexCount = 0; // vertices generated by Renderer2D
+            uint32_t IndexCount = 0; // indices drawn by every draw call
+            uint32_t QuadCount = 0; // quads drawn by Renderer2D
+            uint32_t CulledQuadCount = 0; // quads outside the camera bounds
+            uint32_t TextureBinds = 0;
+            uint32_t ShaderBinds = 0;
+            uint64_t BufferBytesUploaded = 0;
+            uint32_t BatchesFlushed = 0;
+            std::array<uint32_t, static_cast<size_t>(FlushReason::Count)> FlushReasons = {};
+        };
+
+    public:
+        // called by the renderer
+        static void BeginFrame();
+        static void BeginScene();
+
+        // called where the work happens
+        static void AddDrawCall(uint32_t indexCount);
+        static void AddQuads(uint32_t drawn, uint32_t culled);
+        static void AddTextureBind();
+        static void AddShaderBind();
+        static void AddBufferUpload(uint64_t bytes);
+        static void AddBatchFlush(FlushReason reason);
+
+        static const Statistics& GetStats();
+        static void ResetStats();
+
+        static const char* GetFlushReasonName(FlushReason reason);
+    };
+}
@@ -0,0 +1,39 @@
+﻿#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace Mashenka
+{
+    // Mean and nearest rank percentiles of a run of samples, frame times or any per frame counter
+    template<typename T>
+    struct SampleSummary
+    {
+        uint32_t Count = 0;
+        T Mean = T(0), P50 = T(0), P95 = T(0), P99 = T(0);
+    };
+
+    // Takes the samples by value, they are sorted in place. An empty run gives an all zero summary
+    template<typename T>
+    SampleSummary<T> Summarize(std::vector<T> samples)
+    {
+        SampleSummary<T> summary;
+        if (samples.empty())
+            return summary;
+
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&samples](double p)
+        {
+            size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+            return samples[std::min(samples.size(), std::max<size_t>(rank, 1)) - 1];
+        };
+        summary.Count = static_cast<uint32_t>(samples.size());
+        summary.Mean = static_cast<T>(std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size());
+        summary.P50 = percentile(0.50);
+        summary.P95 = percentile(0.95);
+        summary.P99 = percentile(0.99);
+        return summary;
+    }
+}
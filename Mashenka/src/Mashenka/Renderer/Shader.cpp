@@ -2,6 +2,9 @@
 #include "Mashenka/Renderer/Shader.h"
 #include "Mashenka/Renderer/Renderer.h"
 #include "Platform/OpenGL/OpenGLShader.h"
+#include "Platform/OpenGL/OpenGLCapabilities.h"
+
+#include <filesystem>
 
 namespace Mashenka
 {
@@ -63,6 +66,70 @@ namespace Mashenka
         return shader;
     }
 
+    std::vector<Ref<Shader>> ShaderLibrary::Load(const std::vector<std::string>& filepaths)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // creating a shader only submits the compile, nothing waits until a shader is bound
+        std::vector<Ref<Shader>> shaders;
+        shaders.reserve(filepaths.size());
+        for (const auto& filepath : filepaths)
+            shaders.push_back(Load(filepath));
+        return shaders;
+    }
+
+    bool ShaderLibrary::IsReady() const
+    {
+        for (const auto& [name, shader] : m_Shaders)
+        {
+            if (!shader->IsReady())
+                return false;
+        }
+        return true;
+    }
+
+    void ShaderLibrary::EnableHotReload(const std::string& directory)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        m_Watcher = FileWatcher::Create(directory);
+
+        // without the extension the driver compiles a reload when it is swapped in, that frame waits for it
+        static bool s_WarnedBlockingReload = false;
+        if (RendererAPI::GetAPI() == RendererAPI::API::OpenGL && !OpenGLCapabilities::SupportsParallelShaderCompile() &&
+            !s_WarnedBlockingReload)
+        {
+            MK_CORE_WARN("No KHR_parallel_shader_compile, a shader hot reload stalls the frame that swaps it in");
+            s_WarnedBlockingReload = true;
+        }
+    }
+
+    std::vector<Ref<Shader>> ShaderLibrary::Update()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // Start a reload for every shader whose file changed
+        if (m_Watcher)
+        {
+            for (const auto& changedPath : m_Watcher->PollChanges())
+            {
+                std::filesystem::path changed = std::filesystem::path(changedPath).lexically_normal();
+                for (const auto& [name, shader] : m_Shaders)
+                {
+                    const std::string& filepath = shader->GetFilepath();
+                    if (!filepath.empty() && std::filesystem::path(filepath).lexically_normal() == changed)
+                        shader->Reload();
+                }
+            }
+        }
+
+        // Swap in the programs that have finished linking
+        std::vector<Ref<Shader>> reloaded;
+        for (const auto& [name, shader] : m_Shaders)
+        {
+            if (shader->UpdateReload())
+                reloaded.push_back(shader);
+        }
+        return reloaded;
+    }
+
     Ref<Shader> ShaderLibrary::Get(const std::string& name)
     {
         // get shader from the map
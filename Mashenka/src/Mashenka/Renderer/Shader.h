@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <string>
 #include "glm/glm.hpp"
+#include "Mashenka/Core/FileWatcher.h"
 
 
 namespace Mashenka
@@ -26,6 +27,24 @@ namespace Mashenka
         virtual void SetMat4(const std::string& name, const glm::mat4& value) = 0;
 
         virtual const std::string& GetName() const = 0; // get the name of the shader
+
+        // Shaders are compiled in the background where the driver supports it, the first Bind or uniform upload
+        // waits for the compile to finish. IsReady never blocks, it can be polled e.g. by a loading screen
+        virtual bool IsReady() const = 0;
+
+        // Variants are declared in a shader file with "#variant NAME", each one is compiled into its own program
+        // with NAME defined, so cheaper versions of a shader can skip work they don't need
+        // The selected variant is used by Bind and the uniform setters, "" selects the base program
+        virtual bool HasVariant(const std::string& variant) const = 0;
+        virtual void SetVariant(const std::string& variant) = 0;
+
+        // Hot reload: Reload reads and preprocesses the file on a worker thread, UpdateReload submits the compile
+        // once that is done and swaps the new programs in after they have linked, so a reload never stalls a frame.
+        // The old programs stay in use until then, and are kept if the new source fails to compile
+        // Uniform values live in the programs, they have to be set again after a swap
+        virtual const std::string& GetFilepath() const = 0; // empty for shaders created from sources
+        virtual void Reload() = 0;
+        virtual bool UpdateReload() = 0; // returns true when the new programs have been swapped in
         
         // create a shader
         // the type is the type of the shader
@@ -55,12 +74,25 @@ namespace Mashenka
 
         // load the shader from the file path. the name reference is the name of the shader
         Ref<Shader> Load(const std::string& name, const std::string& filepath);
+
+        // load several shaders, all compiles are submitted before any shader is used so they can overlap
+        std::vector<Ref<Shader>> Load(const std::vector<std::string>& filepaths);
+
+        // true when every shader in the library has finished compiling, never blocks
+        bool IsReady() const;
+
+        // Watch a directory and reload the shaders whose file changed in it
+        void EnableHotReload(const std::string& directory);
+        // Called once per frame, starts the reloads and swaps the reloaded programs in
+        // Returns the shaders swapped in this frame, so their uniforms can be set again
+        std::vector<Ref<Shader>> Update();
             
         Ref<Shader> Get(const std::string& name);
         bool Exists(const std::string& name) const;
             
     private:
         std::unordered_map<std::string, Ref<Shader>> m_Shaders;
+        Scope<FileWatcher> m_Watcher;
     };
 }
 
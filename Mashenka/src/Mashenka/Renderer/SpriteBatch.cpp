@@ -0,0 +1,220 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/SpriteBatch.h"
+#include "Mashenka/Renderer/Renderer2D.h"
+#include "Mashenka/Renderer/RenderCommand.h"
+
+namespace Mashenka
+{
+    // dirty slots closer than this are uploaded together, one larger upload beats many tiny ones
+    static const uint32_t s_MergeGap = 16;
+
+    SpriteBatch::SpriteBatch(uint32_t capacity)
+        : m_Capacity(capacity)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        for (auto* attribute : {&m_PositionX, &m_PositionY, &m_PositionZ, &m_SizeX, &m_SizeY, &m_Rotation,
+                                &m_TexIndex, &m_TilingFactor})
+            attribute->resize(capacity);
+        m_Color.resize(capacity);
+        m_Generations.resize(capacity);
+        m_Dirty.resize(capacity);
+        m_Vertices.resize(static_cast<size_t>(capacity) * 4);
+
+        m_VertexArray = VertexArray::Create();
+        m_VertexBuffer = VertexBuffer::Create(capacity * 4 * sizeof(QuadVertex));
+        m_VertexBuffer->SetLayout(Renderer2D::GetQuadVertexLayout());
+        m_VertexArray->AddVertexBuffer(m_VertexBuffer);
+
+        // the batch can be larger than the Renderer2D batch, so it has its own indices
+        std::vector<uint32_t> indices(static_cast<size_t>(capacity) * 6);
+        for (uint32_t quad = 0; quad < capacity; quad++)
+        {
+            uint32_t offset = quad * 4;
+            uint32_t* index = &indices[quad * 6];
+            index[0] = offset + 0;
+            index[1] = offset + 1;
+            index[2] = offset + 2;
+            index[3] = offset + 2;
+            index[4] = offset + 3;
+            index[5] = offset + 0;
+        }
+        m_VertexArray->SetIndexBuffer(IndexBuffer::Create(indices.data(), static_cast<uint32_t>(indices.size())));
+    }
+
+    SpriteHandle SpriteBatch::Add(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color,
+                                  float rotation)
+    {
+        return AddSprite(position, size, rotation, color, 0.0f, 1.0f);
+    }
+
+    SpriteHandle SpriteBatch::Add(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture,
+                                  float tilingFactor, const glm::vec4& tintColor, float rotation)
+    {
+        return AddSprite(position, size, rotation, tintColor, GetTextureSlot(texture), tilingFactor);
+    }
+
+    SpriteHandle SpriteBatch::AddSprite(const glm::vec3& position, const glm::vec2& size, float rotation,
+                                        const glm::vec4& color, float texIndex, float tilingFactor)
+    {
+        uint32_t index;
+        if (!m_FreeSlots.empty())
+        {
+            index = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        }
+        else
+        {
+            MK_CORE_ASSERT(m_SlotCount < m_Capacity, "SpriteBatch is full!");
+            if (m_SlotCount == m_Capacity)
+                return {};
+            index = m_SlotCount++;
+        }
+
+        m_PositionX[index] = position.x;
+        m_PositionY[index] = position.y;
+        m_PositionZ[index] = position.z;
+        m_SizeX[index] = size.x;
+        m_SizeY[index] = size.y;
+        m_Rotation[index] = rotation;
+        m_Color[index] = color;
+        m_TexIndex[index] = texIndex;
+        m_TilingFactor[index] = tilingFactor;
+        MarkDirty(index);
+
+        m_SpriteCount++;
+        return {index, m_Generations[index]};
+    }
+
+    void SpriteBatch::Remove(SpriteHandle sprite)
+    {
+        if (!IsValid(sprite))
+            return;
+
+        // a quad without area stays in the buffer until the slot is reused
+        m_SizeX[sprite.Index] = 0.0f;
+        m_SizeY[sprite.Index] = 0.0f;
+        MarkDirty(sprite.Index);
+
+        m_Generations[sprite.Index]++;
+        m_FreeSlots.push_back(sprite.Index);
+        m_SpriteCount--;
+    }
+
+    bool SpriteBatch::IsValid(SpriteHandle sprite) const
+    {
+        return sprite.Index < m_SlotCount && m_Generations[sprite.Index] == sprite.Generation;
+    }
+
+    void SpriteBatch::SetPosition(SpriteHandle sprite, const glm::vec3& position)
+    {
+        MK_CORE_ASSERT(IsValid(sprite), "Invalid sprite handle!");
+        m_PositionX[sprite.Index] = position.x;
+        m_PositionY[sprite.Index] = position.y;
+        m_PositionZ[sprite.Index] = position.z;
+        MarkDirty(sprite.Index);
+    }
+
+    void SpriteBatch::SetSize(SpriteHandle sprite, const glm::vec2& size)
+    {
+        MK_CORE_ASSERT(IsValid(sprite), "Invalid sprite handle!");
+        m_SizeX[sprite.Index] = size.x;
+        m_SizeY[sprite.Index] = size.y;
+        MarkDirty(sprite.Index);
+    }
+
+    void SpriteBatch::SetRotation(SpriteHandle sprite, float rotation)
+    {
+        MK_CORE_ASSERT(IsValid(sprite), "Invalid sprite handle!");
+        m_Rotation[sprite.Index] = rotation;
+        MarkDirty(sprite.Index);
+    }
+
+    void SpriteBatch::SetColor(SpriteHandle sprite, const glm::vec4& color)
+    {
+        MK_CORE_ASSERT(IsValid(sprite), "Invalid sprite handle!");
+        m_Color[sprite.Index] = color;
+        MarkDirty(sprite.Index);
+    }
+
+    float SpriteBatch::GetTextureSlot(const Ref<Texture2D>& texture)
+    {
+        for (uint32_t i = 1; i < m_TextureCount; i++)
+        {
+            if (m_Textures[i].get() == texture.get())
+                return static_cast<float>(i);
+        }
+
+        if (m_TextureCount == MaxTextureSlots)
+        {
+            MK_CORE_ERROR("SpriteBatch: all {0} texture slots are taken, the sprite is drawn untextured",
+                          MaxTextureSlots);
+            return 0.0f;
+        }
+
+        uint32_t slot = m_TextureCount++;
+        m_Textures[slot] = texture;
+        return static_cast<float>(slot);
+    }
+
+    void SpriteBatch::MarkDirty(uint32_t index)
+    {
+        if (m_Dirty[index])
+            return;
+        m_Dirty[index] = 1;
+        m_DirtySlots.push_back(index);
+    }
+
+    void SpriteBatch::UploadDirtyRanges()
+    {
+        if (m_DirtySlots.empty())
+            return;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        std::sort(m_DirtySlots.begin(), m_DirtySlots.end());
+
+        size_t i = 0;
+        while (i < m_DirtySlots.size())
+        {
+            // grow the range while the next dirty slot is close
+            uint32_t first = m_DirtySlots[i];
+            uint32_t last = first;
+            for (i++; i < m_DirtySlots.size() && m_DirtySlots[i] - last <= s_MergeGap; i++)
+                last = m_DirtySlots[i];
+
+            uint32_t count = last - first + 1;
+            QuadKernelInput input;
+            input.PositionX = m_PositionX.data() + first;
+            input.PositionY = m_PositionY.data() + first;
+            input.PositionZ = m_PositionZ.data() + first;
+            input.SizeX = m_SizeX.data() + first;
+            input.SizeY = m_SizeY.data() + first;
+            input.Rotation = m_Rotation.data() + first;
+            input.Color = m_Color.data() + first;
+            input.TexIndex = m_TexIndex.data() + first;
+            input.TilingFactor = m_TilingFactor.data() + first;
+            QuadVertex* vertices = &m_Vertices[static_cast<size_t>(first) * 4];
+            QuadKernel::Transform(input, count, vertices);
+
+            m_VertexBuffer->SetData(vertices, count * 4 * sizeof(QuadVertex), first * 4 * sizeof(QuadVertex));
+        }
+
+        for (uint32_t index : m_DirtySlots)
+            m_Dirty[index] = 0;
+        m_DirtySlots.clear();
+    }
+
+    void SpriteBatch::Draw()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        UploadDirtyRanges();
+        if (m_SpriteCount == 0)
+            return;
+
+        for (uint32_t i = 1; i < m_TextureCount; i++)
+            m_Textures[i]->Bind(i);
+
+        m_VertexArray->Bind();
+        RenderCommand::DrawIndexed(m_VertexArray, m_SlotCount * 6);
+        RendererStats::AddQuads(m_SpriteCount, 0);
+    }
+}
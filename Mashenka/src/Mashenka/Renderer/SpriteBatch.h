@@ -0,0 +1,81 @@
+﻿#pragma once
+#include "Mashenka/Renderer/VertexArray.h"
+#include "Mashenka/Renderer/Texture.h"
+#include "Mashenka/Renderer/QuadKernel.h"
+
+#include <glm/glm.hpp>
+
+namespace Mashenka
+{
+    // Stays valid until the sprite is removed, a handle of a removed sprite is rejected even if its slot is reused
+    struct SpriteHandle
+    {
+        uint32_t Index = ~0u;
+        uint32_t Generation = 0;
+    };
+
+    /*
+     * SpriteBatch Class
+     * Retained sprites, they keep their vertices on the GPU between frames
+     * Changing a sprite regenerates its 4 vertices on the next draw, only the dirty ranges of the vertex buffer
+     * are uploaded, so a scene that does not change costs one draw call
+     * Draw it with Renderer2D::DrawSpriteBatch
+     */
+    class SpriteBatch
+    {
+    public:
+        static const uint32_t MaxTextureSlots = 16; // must match the quad shader, slot 0 is the white texture
+
+        SpriteBatch(uint32_t capacity = 10000);
+
+        SpriteHandle Add(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color,
+                         float rotation = 0.0f);
+        SpriteHandle Add(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture,
+                         float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f),
+                         float rotation = 0.0f);
+        void Remove(SpriteHandle sprite);
+        bool IsValid(SpriteHandle sprite) const;
+
+        void SetPosition(SpriteHandle sprite, const glm::vec3& position);
+        void SetSize(SpriteHandle sprite, const glm::vec2& size);
+        void SetRotation(SpriteHandle sprite, float rotation);
+        void SetColor(SpriteHandle sprite, const glm::vec4& color);
+
+        uint32_t GetSpriteCount() const { return m_SpriteCount; }
+        uint32_t GetCapacity() const { return m_Capacity; }
+        bool HasTextures() const { return m_TextureCount > 1; }
+
+        // Uploads the dirty ranges and draws every sprite with the bound quad shader, slot 0 must hold the white texture
+        void Draw();
+
+    private:
+        SpriteHandle AddSprite(const glm::vec3& position, const glm::vec2& size, float rotation,
+                               const glm::vec4& color, float texIndex, float tilingFactor);
+        float GetTextureSlot(const Ref<Texture2D>& texture);
+        void MarkDirty(uint32_t index);
+        void UploadDirtyRanges();
+
+    private:
+        uint32_t m_Capacity;
+        uint32_t m_SpriteCount = 0;
+        uint32_t m_SlotCount = 0; // slots ever used, removed sprites leave empty quads behind
+        std::vector<uint32_t> m_Generations;
+        std::vector<uint32_t> m_FreeSlots;
+
+        // one array per attribute so the quad kernel can regenerate ranges with SIMD
+        std::vector<float> m_PositionX, m_PositionY, m_PositionZ;
+        std::vector<float> m_SizeX, m_SizeY, m_Rotation;
+        std::vector<glm::vec4> m_Color;
+        std::vector<float> m_TexIndex, m_TilingFactor;
+
+        std::vector<QuadVertex> m_Vertices;
+        std::vector<uint8_t> m_Dirty;
+        std::vector<uint32_t> m_DirtySlots;
+
+        std::array<Ref<Texture2D>, MaxTextureSlots> m_Textures;
+        uint32_t m_TextureCount = 1;
+
+        Ref<VertexArray> m_VertexArray;
+        Ref<VertexBuffer> m_VertexBuffer;
+    };
+}
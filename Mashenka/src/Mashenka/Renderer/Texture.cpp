@@ -1,6 +1,7 @@
 ﻿#include "mkpch.h"
 #include "Mashenka/Renderer/Renderer.h"
 #include "Mashenka/Renderer/Texture.h"
+#include "Mashenka/Renderer/TextureResidency.h"
 #include "Platform/OpenGL/OpenGLTexture.h"
 
 namespace Mashenka
@@ -13,7 +14,12 @@ namespace Mashenka
         {
         case RendererAPI::API::None: MK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!")
             return nullptr;
-        case RendererAPI::API::OpenGL: return std::make_shared<OpenGLTexture2D>(path);
+        case RendererAPI::API::OpenGL:
+            {
+                Ref<Texture2D> texture = std::make_shared<OpenGLTexture2D>(path);
+                TextureResidency::Register(texture); // file textures can be evicted and reloaded
+                return texture;
+            }
         }
 
         //if the api is not supported
@@ -28,7 +34,12 @@ namespace Mashenka
         {
         case RendererAPI::API::None: MK_CORE_ASSERT(false, "RendererAPI::None is currently not supported!")
             return nullptr;
-        case RendererAPI::API::OpenGL: return CreateRef<OpenGLTexture2D>(width, height);
+        case RendererAPI::API::OpenGL:
+            {
+                Ref<Texture2D> texture = CreateRef<OpenGLTexture2D>(width, height);
+                TextureResidency::Register(texture); // tracked for memory, never evicted
+                return texture;
+            }
         }
 
         MK_CORE_ASSERT(false, "Unknown RendererAPI!")
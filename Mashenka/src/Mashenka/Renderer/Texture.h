@@ -21,7 +21,19 @@ namespace Mashenka
         // Then we can use the color texture in the shader by using the sampler2D with slot 0
         // And we can use the normal texture in the shader by using the sampler2D with slot 1
         virtual void Bind(uint32_t slot = 0) const = 0;
-    
+
+        // Residency, driven by the TextureResidency manager
+        // Textures loaded from a file can drop their most detailed mips or leave the GPU entirely,
+        // they are loaded again from the file when needed. Textures created at runtime are always resident
+        virtual uint64_t GetMemorySize() const = 0; // bytes currently used on the GPU, 0 when evicted
+        virtual uint32_t GetMipLevelCount() const = 0; // mip levels of the full resolution texture
+        virtual uint32_t GetResidentMip() const = 0; // most detailed mip kept on the GPU, 0 is full resolution
+        virtual bool IsResident() const = 0;
+        virtual bool IsReloadable() const = 0; // whether the texture can be evicted and loaded again
+
+        virtual void SetResidentMip(uint32_t mip) = 0; // drop (or bring back) the most detailed mips
+        virtual void Evict() = 0; // release all GPU memory, the texture is reloaded on the next MakeResident
+        virtual void MakeResident() = 0; // bring the texture back at full resolution
     };
 
     class Texture2D : public Texture
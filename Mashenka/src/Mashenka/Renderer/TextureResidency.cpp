@@ -0,0 +1,255 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/TextureResidency.h"
+
+namespace Mashenka
+{
+    // A registered texture, weak so the manager does not keep textures alive
+    struct ResidencyEntry
+    {
+        std::weak_ptr<Texture2D> Texture;
+        uint64_t LastBoundFrame = 0;
+    };
+
+    // A demoted texture comes back only if the budget keeps this much free afterwards (1/8 of it)
+    static constexpr uint32_t s_RestoreHeadroomShift = 3;
+
+    struct TextureResidencyStorage
+    {
+        // keyed by the raw pointer, so a bind can find its entry
+        std::unordered_map<const Texture*, ResidencyEntry> Entries;
+        uint64_t Budget = 0;
+        uint32_t MaxDroppedMips = 2;
+        uint32_t ProtectedFrames = 2;
+        uint64_t FrameIndex = 0;
+
+        uint32_t Reloads = 0;
+        uint32_t Demotions = 0;
+        uint32_t Evictions = 0;
+    };
+
+    static TextureResidencyStorage* s_Data;
+
+    void TextureResidency::Init()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        s_Data = new TextureResidencyStorage();
+    }
+
+    void TextureResidency::Shutdown()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        delete s_Data;
+        s_Data = nullptr;
+    }
+
+    void TextureResidency::SetBudget(uint64_t bytes)
+    {
+        s_Data->Budget = bytes;
+    }
+
+    uint64_t TextureResidency::GetBudget()
+    {
+        return s_Data->Budget;
+    }
+
+    void TextureResidency::SetMaxDroppedMips(uint32_t mips)
+    {
+        s_Data->MaxDroppedMips = mips;
+    }
+
+    void TextureResidency::SetProtectedFrames(uint32_t frames)
+    {
+        s_Data->ProtectedFrames = frames;
+    }
+
+    void TextureResidency::Register(const Ref<Texture2D>& texture)
+    {
+        // textures created before Init (or after Shutdown) are simply not managed
+        if (!s_Data || !texture)
+            return;
+
+        ResidencyEntry& entry = s_Data->Entries[texture.get()];
+        entry.Texture = texture;
+        entry.LastBoundFrame = s_Data->FrameIndex;
+    }
+
+    void TextureResidency::OnBind(const Texture* texture)
+    {
+        if (!s_Data)
+            return;
+
+        auto it = s_Data->Entries.find(texture);
+        if (it == s_Data->Entries.end())
+            return;
+
+        ResidencyEntry& entry = it->second;
+        entry.LastBoundFrame = s_Data->FrameIndex;
+
+        // An evicted texture has nothing to draw with, it has to come back now. A demoted one still draws with its
+        // smaller mips, NewFrame restores it when there is room
+        if (auto ref = entry.Texture.lock())
+        {
+            if (!ref->IsResident())
+            {
+                MK_PROFILE_SCOPE("TextureResidency Reload");
+                ref->MakeResident();
+                s_Data->Reloads++;
+            }
+        }
+    }
+
+    void TextureResidency::NewFrame()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (!s_Data)
+            return;
+
+        s_Data->FrameIndex++;
+
+        // forget the textures that have been destroyed
+        for (auto it = s_Data->Entries.begin(); it != s_Data->Entries.end();)
+        {
+            if (it->second.Texture.expired())
+                it = s_Data->Entries.erase(it);
+            else
+                ++it;
+        }
+
+        if (s_Data->Budget)
+            EnforceBudget();
+        RestoreDemoted();
+    }
+
+    void TextureResidency::EnforceBudget()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // Collect the textures that may lose memory, least recently bound first
+        std::vector<std::pair<uint64_t, Ref<Texture2D>>> candidates;
+        uint64_t residentBytes = 0;
+        for (auto& [key, entry] : s_Data->Entries)
+        {
+            Ref<Texture2D> texture = entry.Texture.lock();
+            if (!texture)
+                continue;
+
+            residentBytes += texture->GetMemorySize();
+            bool isProtected = entry.LastBoundFrame + s_Data->ProtectedFrames >= s_Data->FrameIndex;
+            if (texture->IsReloadable() && texture->IsResident() && !isProtected)
+                candidates.emplace_back(entry.LastBoundFrame, texture);
+        }
+
+        if (residentBytes <= s_Data->Budget)
+            return;
+
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        // First pass drops mips, which keeps something drawable around, second pass evicts entirely
+        for (int pass = 0; pass < 2 && residentBytes > s_Data->Budget; pass++)
+        {
+            for (auto& [lastBound, texture] : candidates)
+            {
+                if (residentBytes <= s_Data->Budget)
+                    break;
+                if (!texture->IsResident())
+                    continue;
+
+                uint64_t before = texture->GetMemorySize();
+                uint32_t maxMip = std::min(s_Data->MaxDroppedMips, texture->GetMipLevelCount() - 1);
+                if (pass == 0)
+                {
+                    if (texture->GetResidentMip() >= maxMip)
+                        continue;
+                    texture->SetResidentMip(maxMip);
+                    s_Data->Demotions++;
+                }
+                else
+                {
+                    texture->Evict();
+                    s_Data->Evictions++;
+                }
+
+                residentBytes -= before - texture->GetMemorySize();
+            }
+        }
+
+        if (residentBytes > s_Data->Budget)
+        {
+            MK_CORE_WARN("Texture budget exceeded: {0} bytes resident, budget is {1} bytes", residentBytes,
+                         s_Data->Budget);
+        }
+    }
+
+    void TextureResidency::RestoreDemoted()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // the most recently bound demoted texture, it is the one most likely on screen
+        Ref<Texture2D> candidate;
+        uint64_t candidateFrame = 0;
+        uint64_t residentBytes = 0;
+        for (auto& [key, entry] : s_Data->Entries)
+        {
+            Ref<Texture2D> texture = entry.Texture.lock();
+            if (!texture)
+                continue;
+
+            residentBytes += texture->GetMemorySize();
+            bool recentlyBound = entry.LastBoundFrame + s_Data->ProtectedFrames >= s_Data->FrameIndex;
+            if (texture->IsResident() && texture->GetResidentMip() > 0 && recentlyBound &&
+                (!candidate || entry.LastBoundFrame > candidateFrame))
+            {
+                candidate = texture;
+                candidateFrame = entry.LastBoundFrame;
+            }
+        }
+        if (!candidate)
+            return;
+
+        // every mip is a quarter of the one before, the full chain is about 4^mip times what is resident now
+        uint64_t restoredBytes = candidate->GetMemorySize() << (2 * candidate->GetResidentMip());
+        if (s_Data->Budget)
+        {
+            uint64_t limit = s_Data->Budget - (s_Data->Budget >> s_RestoreHeadroomShift);
+            if (residentBytes - candidate->GetMemorySize() + restoredBytes > limit)
+                return;
+        }
+
+        {
+            MK_PROFILE_SCOPE("TextureResidency Reload");
+            candidate->MakeResident();
+        }
+        s_Data->Reloads++;
+    }
+
+    TextureResidency::Statistics TextureResidency::GetStats()
+    {
+        Statistics stats;
+        if (!s_Data)
+            return stats;
+
+        for (auto& [key, entry] : s_Data->Entries)
+        {
+            Ref<Texture2D> texture = entry.Texture.lock();
+            if (!texture)
+                continue;
+
+            stats.TextureCount++;
+            stats.ResidentBytes += texture->GetMemorySize();
+            if (!texture->IsResident())
+                stats.EvictedCount++;
+            else if (texture->GetResidentMip() > 0)
+                stats.DemotedCount++;
+        }
+        stats.Reloads = s_Data->Reloads;
+        stats.Demotions = s_Data->Demotions;
+        stats.Evictions = s_Data->Evictions;
+        return stats;
+    }
+
+    void TextureResidency::ResetStats()
+    {
+        s_Data->Reloads = 0;
+        s_Data->Demotions = 0;
+        s_Data->Evictions = 0;
+    }
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+#include "Mashenka/Renderer/Texture.h"
+
+namespace Mashenka
+{
+    /*
+     * TextureResidency Class
+     * Keeps track of the GPU memory used by all Texture2D objects and keeps it under a budget
+     * Every texture created with Texture2D::Create is registered, binding a texture marks it as used
+     * When the budget is exceeded, the least recently bound textures first drop their most detailed mips,
+     * then leave the GPU entirely. Evicted textures are loaded again from their file on the next bind
+     * Demoted textures stay drawable, NewFrame brings at most one recently bound texture back per frame, and only
+     * when it fits under the budget with some headroom left, so it is not trimmed again right away
+     * Textures created at runtime (no file to reload from) are never evicted
+     */
+    class TextureResidency
+    {
+    public:
+        struct Statistics
+        {
+            uint64_t ResidentBytes = 0; // GPU memory used by all textures
+            uint32_t TextureCount = 0;
+            uint32_t EvictedCount = 0; // textures that are currently not on the GPU
+            uint32_t DemotedCount = 0; // textures that currently miss some of their mips
+            uint32_t Reloads = 0; // textures loaded again from their file, since the last ResetStats
+            uint32_t Demotions = 0; // mip drops, since the last ResetStats
+            uint32_t Evictions = 0; // full evictions, since the last ResetStats
+        };
+
+    public:
+        static void Init();
+        static void Shutdown();
+
+        // Budget in bytes, 0 disables the budget
+        static void SetBudget(uint64_t bytes);
+        static uint64_t GetBudget();
+
+        // Mips that may be dropped before a texture is evicted entirely
+        static void SetMaxDroppedMips(uint32_t mips);
+
+        // Textures bound within this many frames are not evicted, to avoid reloading the working set every frame
+        static void SetProtectedFrames(uint32_t frames);
+
+        // called by Texture2D::Create and the texture implementations
+        static void Register(const Ref<Texture2D>& texture);
+        static void OnBind(const Texture* texture);
+
+        // Advance the frame counter and bring the memory back under the budget, called once per frame
+        static void NewFrame();
+
+        static Statistics GetStats();
+        static void ResetStats();
+
+    private:
+        static void EnforceBudget();
+        static void RestoreDemoted();
+    };
+}
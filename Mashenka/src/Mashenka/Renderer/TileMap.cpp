@@ -0,0 +1,137 @@
+﻿#include "mkpch.h"
+#include "Mashenka/Renderer/TileMap.h"
+#include "Mashenka/Renderer/Renderer2D.h"
+#include "Mashenka/Renderer/RenderCommand.h"
+#include "Mashenka/Renderer/QuadKernel.h"
+
+namespace Mashenka
+{
+    TileMap::TileMap(uint32_t width, uint32_t height, float tileSize, const glm::vec3& origin)
+        : m_Width(width), m_Height(height), m_TileSize(tileSize), m_Origin(origin)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        m_Tiles.resize(static_cast<size_t>(width) * height);
+
+        // the GPU buffers are created the first time a chunk is drawn
+        m_ChunkColumns = (width + ChunkSize - 1) / ChunkSize;
+        m_ChunkRows = (height + ChunkSize - 1) / ChunkSize;
+        m_Chunks.resize(static_cast<size_t>(m_ChunkColumns) * m_ChunkRows);
+        for (uint32_t chunkY = 0; chunkY < m_ChunkRows; chunkY++)
+        {
+            for (uint32_t chunkX = 0; chunkX < m_ChunkColumns; chunkX++)
+            {
+                Chunk& chunk = m_Chunks[chunkY * m_ChunkColumns + chunkX];
+                uint32_t tilesX = std::min(ChunkSize, width - chunkX * ChunkSize);
+                uint32_t tilesY = std::min(ChunkSize, height - chunkY * ChunkSize);
+                chunk.Bounds.Min = glm::vec2(origin) + glm::vec2(chunkX, chunkY) * (ChunkSize * tileSize);
+                chunk.Bounds.Max = chunk.Bounds.Min + glm::vec2(tilesX, tilesY) * tileSize;
+            }
+        }
+    }
+
+    void TileMap::SetTileset(const Ref<Texture2D>& tileset, uint32_t columns, uint32_t rows)
+    {
+        MK_CORE_ASSERT(columns > 0 && rows > 0, "A tileset needs at least one cell!");
+        m_Tileset = tileset;
+        m_TilesetColumns = columns;
+        m_TilesetRows = rows;
+
+        // every texture coordinate changes
+        for (Chunk& chunk : m_Chunks)
+            chunk.Dirty = true;
+    }
+
+    void TileMap::SetTile(uint32_t x, uint32_t y, int32_t index, const glm::vec4& color)
+    {
+        MK_CORE_ASSERT(x < m_Width && y < m_Height, "Tile is outside of the map!");
+        Tile& tile = m_Tiles[y * m_Width + x];
+        tile.Index = index;
+        tile.Color = color;
+        m_Chunks[(y / ChunkSize) * m_ChunkColumns + x / ChunkSize].Dirty = true;
+    }
+
+    void TileMap::RebuildChunk(uint32_t chunkX, uint32_t chunkY, Chunk& chunk)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (!chunk.TileVertexArray)
+        {
+            chunk.TileVertexArray = VertexArray::Create();
+            chunk.TileVertexBuffer = VertexBuffer::Create(ChunkSize * ChunkSize * 4 * sizeof(QuadVertex));
+            chunk.TileVertexBuffer->SetLayout(Renderer2D::GetQuadVertexLayout());
+            chunk.TileVertexArray->AddVertexBuffer(chunk.TileVertexBuffer);
+            // every chunk shares the index buffer of the quad batch
+            chunk.TileVertexArray->SetIndexBuffer(Renderer2D::GetQuadIndexBuffer());
+        }
+
+        static const glm::vec2 corners[4] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+        std::vector<QuadVertex> vertices;
+        vertices.reserve(ChunkSize * ChunkSize * 4);
+
+        uint32_t endX = std::min(m_Width, (chunkX + 1) * ChunkSize);
+        uint32_t endY = std::min(m_Height, (chunkY + 1) * ChunkSize);
+        for (uint32_t y = chunkY * ChunkSize; y < endY; y++)
+        {
+            for (uint32_t x = chunkX * ChunkSize; x < endX; x++)
+            {
+                const Tile& tile = m_Tiles[y * m_Width + x];
+                if (tile.Index < 0)
+                    continue;
+
+                // the cell of the tileset, textures are flipped on load so the top row is at v = 1
+                glm::vec2 cellMin(0.0f), cellSize(1.0f);
+                if (m_Tileset)
+                {
+                    uint32_t column = static_cast<uint32_t>(tile.Index) % m_TilesetColumns;
+                    uint32_t row = static_cast<uint32_t>(tile.Index) / m_TilesetColumns;
+                    cellSize = glm::vec2(1.0f / m_TilesetColumns, 1.0f / m_TilesetRows);
+                    cellMin = glm::vec2(column * cellSize.x, 1.0f - (row + 1) * cellSize.y);
+                }
+
+                glm::vec3 position = m_Origin + glm::vec3(x * m_TileSize, y * m_TileSize, 0.0f);
+                for (const glm::vec2& corner : corners)
+                {
+                    QuadVertex vertex;
+                    vertex.Position = position + glm::vec3(corner * m_TileSize, 0.0f);
+                    vertex.Color = tile.Color;
+                    vertex.TexCoord = cellMin + corner * cellSize;
+                    vertex.TexIndex = 0.0f; // the tileset is bound to slot 0
+                    vertex.TilingFactor = 1.0f;
+                    vertices.push_back(vertex);
+                }
+            }
+        }
+
+        chunk.QuadCount = static_cast<uint32_t>(vertices.size() / 4);
+        if (!vertices.empty())
+            chunk.TileVertexBuffer->SetData(vertices.data(), static_cast<uint32_t>(vertices.size() * sizeof(QuadVertex)));
+        chunk.Dirty = false;
+    }
+
+    void TileMap::Draw(const Bounds2D& bounds)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        for (uint32_t chunkY = 0; chunkY < m_ChunkRows; chunkY++)
+        {
+            for (uint32_t chunkX = 0; chunkX < m_ChunkColumns; chunkX++)
+            {
+                Chunk& chunk = m_Chunks[chunkY * m_ChunkColumns + chunkX];
+                // chunks out of view keep their changes until they come into view
+                if (!chunk.Bounds.Intersects(bounds))
+                {
+                    if (!chunk.Dirty)
+                        RendererStats::AddQuads(0, chunk.QuadCount);
+                    continue;
+                }
+
+                if (chunk.Dirty)
+                    RebuildChunk(chunkX, chunkY, chunk);
+                if (chunk.QuadCount == 0)
+                    continue;
+
+                chunk.TileVertexArray->Bind();
+                RenderCommand::DrawIndexed(chunk.TileVertexArray, chunk.QuadCount * 6);
+                RendererStats::AddQuads(chunk.QuadCount, 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,70 @@
+﻿#pragma once
+#include "Mashenka/Renderer/VertexArray.h"
+#include "Mashenka/Renderer/Texture.h"
+#include "Mashenka/Renderer/Culling.h"
+
+#include <glm/glm.hpp>
+
+namespace Mashenka
+{
+    /*
+     * TileMap Class
+     * A grid of tiles drawn from one tileset texture, split into chunks of ChunkSize x ChunkSize tiles
+     * Every chunk keeps its vertices on the GPU, changing a tile only rebuilds and uploads its chunk
+     * Draw it with Renderer2D::DrawTileMap, only the chunks intersecting the camera bounds are drawn
+     */
+    class TileMap
+    {
+    public:
+        static const uint32_t ChunkSize = 32;
+
+        struct Tile
+        {
+            int32_t Index = -1; // cell of the tileset, counted row by row from the top left, -1 is an empty tile
+            glm::vec4 Color = glm::vec4(1.0f); // tint, or the color of the tile when there is no tileset
+        };
+
+    public:
+        // origin is the bottom left corner of tile (0, 0)
+        TileMap(uint32_t width, uint32_t height, float tileSize = 1.0f, const glm::vec3& origin = glm::vec3(0.0f));
+
+        // A texture split into columns x rows cells, without a tileset the tiles are flat colored
+        void SetTileset(const Ref<Texture2D>& tileset, uint32_t columns, uint32_t rows);
+        const Ref<Texture2D>& GetTileset() const { return m_Tileset; }
+
+        void SetTile(uint32_t x, uint32_t y, int32_t index, const glm::vec4& color = glm::vec4(1.0f));
+        void ClearTile(uint32_t x, uint32_t y) { SetTile(x, y, -1); }
+        const Tile& GetTile(uint32_t x, uint32_t y) const { return m_Tiles[y * m_Width + x]; }
+
+        uint32_t GetWidth() const { return m_Width; }
+        uint32_t GetHeight() const { return m_Height; }
+        float GetTileSize() const { return m_TileSize; }
+
+        // Rebuilds the dirty visible chunks and draws the visible ones, the quad shader must be bound
+        void Draw(const Bounds2D& bounds);
+
+    private:
+        struct Chunk
+        {
+            Ref<VertexArray> TileVertexArray;
+            Ref<VertexBuffer> TileVertexBuffer;
+            Bounds2D Bounds;
+            uint32_t QuadCount = 0; // empty tiles are left out
+            bool Dirty = true;
+        };
+
+        void RebuildChunk(uint32_t chunkX, uint32_t chunkY, Chunk& chunk);
+
+    private:
+        uint32_t m_Width, m_Height;
+        float m_TileSize;
+        glm::vec3 m_Origin;
+        std::vector<Tile> m_Tiles;
+
+        Ref<Texture2D> m_Tileset;
+        uint32_t m_TilesetColumns = 1, m_TilesetRows = 1;
+
+        uint32_t m_ChunkColumns, m_ChunkRows;
+        std::vector<Chunk> m_Chunks;
+    };
+}
@@ -0,0 +1,68 @@
+﻿#include "mkpch.h"
+
+#ifdef MK_PLATFORM_LINUX
+#include "Platform/Linux/LinuxFileWatcher.h"
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace Mashenka
+{
+    LinuxFileWatcher::LinuxFileWatcher(const std::string& directory)
+        : FileWatcher(directory)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        m_InotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_InotifyFD == -1)
+        {
+            MK_CORE_ERROR("Could not create a file watcher for '{0}'", directory);
+            return;
+        }
+
+        // Editors either write the file in place (close after write) or write a copy and rename it over the file
+        if (inotify_add_watch(m_InotifyFD, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1)
+        {
+            MK_CORE_ERROR("Could not watch directory '{0}'", directory);
+            close(m_InotifyFD);
+            m_InotifyFD = -1;
+            return;
+        }
+
+        m_Running = true;
+        m_Thread = std::thread(&LinuxFileWatcher::Watch, this);
+    }
+
+    LinuxFileWatcher::~LinuxFileWatcher()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        m_Running = false;
+        if (m_Thread.joinable())
+            m_Thread.join();
+        if (m_InotifyFD != -1)
+            close(m_InotifyFD);
+    }
+
+    void LinuxFileWatcher::Watch()
+    {
+        // Explanation: https://man7.org/linux/man-pages/man7/inotify.7.html
+        alignas(inotify_event) char buffer[4096];
+        while (m_Running)
+        {
+            // wake up regularly so the destructor does not wait for the next change
+            pollfd descriptor = {m_InotifyFD, POLLIN, 0};
+            if (poll(&descriptor, 1, 100) <= 0)
+                continue;
+
+            ssize_t length = read(m_InotifyFD, buffer, sizeof(buffer));
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                if (event->len > 0 && !(event->mask & IN_ISDIR))
+                    PushChange(GetDirectory() + "/" + event->name);
+                offset += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+}
+#endif
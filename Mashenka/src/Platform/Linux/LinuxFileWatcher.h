@@ -0,0 +1,24 @@
+﻿#pragma once
+#include "Mashenka/Core/FileWatcher.h"
+
+#include <atomic>
+#include <thread>
+
+namespace Mashenka
+{
+    // inotify implementation of the FileWatcher
+    class LinuxFileWatcher : public FileWatcher
+    {
+    public:
+        LinuxFileWatcher(const std::string& directory);
+        ~LinuxFileWatcher() override;
+
+    private:
+        void Watch();
+
+    private:
+        int m_InotifyFD = -1;
+        std::atomic<bool> m_Running = false;
+        std::thread m_Thread;
+    };
+}
@@ -1,5 +1,6 @@
 ﻿#include "mkpch.h"
 #include "Platform/OpenGL/OpenGLBuffer.h"
+#include "Mashenka/Renderer/RendererStats.h"
 #include "glad/glad.h"
 
 namespace Mashenka
@@ -16,6 +17,18 @@ namespace Mashenka
         glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
         // allocate memory for the buffer
         glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+        RendererStats::AddBufferUpload(size);
+    }
+
+    OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // create a buffer
+        glGenBuffers(1, &m_RendererID);
+        // bind the buffer
+        glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+        // allocate memory only, the data is uploaded every frame with SetData
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
     }
 
     OpenGLVertexBuffer::~OpenGLVertexBuffer()
@@ -39,6 +52,14 @@ namespace Mashenka
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
+    void OpenGLVertexBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // direct state access, no need to disturb the bound buffer
+        glNamedBufferSubData(m_RendererID, offset, size, data);
+        RendererStats::AddBufferUpload(size);
+    }
+
 
     /*
      * Index buffer
@@ -54,6 +75,16 @@ namespace Mashenka
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
         // allocate memory for the buffer
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * count, indices, GL_STATIC_DRAW);  // NOLINT(bugprone-narrowing-conversions)
+        RendererStats::AddBufferUpload(sizeof(uint32_t) * count);
+    }
+
+    OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t count)
+        : m_Count(count)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // direct state access, binding GL_ELEMENT_ARRAY_BUFFER here would attach it to the bound vertex array
+        glCreateBuffers(1, &m_RendererID);
+        glNamedBufferData(m_RendererID, sizeof(uint32_t) * count, nullptr, GL_DYNAMIC_DRAW);
     }
 
     OpenGLIndexBuffer::~OpenGLIndexBuffer()
@@ -76,5 +107,48 @@ namespace Mashenka
         // unbind the buffer
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
+
+    void OpenGLIndexBuffer::SetData(const uint32_t* indices, uint32_t count, uint32_t offset)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        MK_CORE_ASSERT(offset + count <= m_Count, "Indices do not fit into the index buffer!");
+        glNamedBufferSubData(m_RendererID, sizeof(uint32_t) * offset, sizeof(uint32_t) * count, indices);
+        RendererStats::AddBufferUpload(sizeof(uint32_t) * count);
+    }
+
+
+    /*
+     * Storage buffer
+     */
+    OpenGLStorageBuffer::OpenGLStorageBuffer(uint32_t size, const void* data)
+        : m_Size(size)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        glCreateBuffers(1, &m_RendererID);
+        // written and read by the GPU, the CPU only uploads now and then
+        glNamedBufferData(m_RendererID, size, data, GL_DYNAMIC_COPY);
+        if (data)
+            RendererStats::AddBufferUpload(size);
+    }
+
+    OpenGLStorageBuffer::~OpenGLStorageBuffer()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        glDeleteBuffers(1, &m_RendererID);
+    }
+
+    void OpenGLStorageBuffer::Bind(uint32_t binding) const
+    {
+        // Explanation: https://www.khronos.org/opengl/wiki/Shader_Storage_Buffer_Object
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, m_RendererID);
+    }
+
+    void OpenGLStorageBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        MK_CORE_ASSERT(offset + size <= m_Size, "Data does not fit into the storage buffer!");
+        glNamedBufferSubData(m_RendererID, offset, size, data);
+        RendererStats::AddBufferUpload(size);
+    }
 }
 
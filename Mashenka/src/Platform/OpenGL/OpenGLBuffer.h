@@ -19,6 +19,7 @@ namespace Mashenka
         // why we want to create them at the same time?
         // because we want to use the same function to create different vertex buffers
         OpenGLVertexBuffer(float* vertices, uint32_t size);
+        OpenGLVertexBuffer(uint32_t size);
         ~OpenGLVertexBuffer() override;
 
         // Bind & Unbind
@@ -29,6 +30,8 @@ namespace Mashenka
         virtual const BufferLayout& GetLayout() const override {return m_Layout; }
         virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
 
+        void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+
     private:
         // the id of the vertex buffer
         // what is the id used for?
@@ -43,6 +46,7 @@ namespace Mashenka
     {
     public:
         OpenGLIndexBuffer(uint32_t* indices, uint32_t count);
+        OpenGLIndexBuffer(uint32_t count);
         ~OpenGLIndexBuffer() override;
 
         // bind and unbind
@@ -52,10 +56,31 @@ namespace Mashenka
         // get the count of indices
         virtual uint32_t GetCount() const override { return m_Count; }
 
+        void SetData(const uint32_t* indices, uint32_t count, uint32_t offset = 0) override;
+
     private:
         // the number of indices
         uint32_t m_Count;
         // the id of the index buffer
         uint32_t m_RendererID;
     };
+
+    // OpenGL Shader Storage Buffer Class
+    class OpenGLStorageBuffer : public StorageBuffer
+    {
+    public:
+        OpenGLStorageBuffer(uint32_t size, const void* data);
+        ~OpenGLStorageBuffer() override;
+
+        void Bind(uint32_t binding) const override;
+
+        void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+        uint32_t GetSize() const override { return m_Size; }
+
+        uint32_t GetRendererID() const { return m_RendererID; }
+
+    private:
+        uint32_t m_Size;
+        uint32_t m_RendererID;
+    };
 }
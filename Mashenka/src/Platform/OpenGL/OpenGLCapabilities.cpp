@@ -0,0 +1,53 @@
+﻿#include "mkpch.h"
+#include "Platform/OpenGL/OpenGLCapabilities.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+namespace Mashenka
+{
+    // glMaxShaderCompilerThreadsKHR / glMaxShaderCompilerThreadsARB
+    typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSPROC)(GLuint count);
+
+    bool OpenGLCapabilities::s_ParallelShaderCompile = false;
+    std::string OpenGLCapabilities::s_RendererName;
+
+    void OpenGLCapabilities::Init()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+        s_RendererName = renderer ? renderer : "";
+
+        // Parallel shader compile, let the driver pick the number of compiler threads
+        const char* maxThreadsName = nullptr;
+        if (HasExtension("GL_KHR_parallel_shader_compile"))
+            maxThreadsName = "glMaxShaderCompilerThreadsKHR";
+        else if (HasExtension("GL_ARB_parallel_shader_compile"))
+            maxThreadsName = "glMaxShaderCompilerThreadsARB";
+
+        if (maxThreadsName)
+        {
+            auto maxShaderCompilerThreads = reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSPROC>(
+                glfwGetProcAddress(maxThreadsName));
+            if (maxShaderCompilerThreads)
+            {
+                maxShaderCompilerThreads(0xFFFFFFFF);
+                s_ParallelShaderCompile = true;
+            }
+        }
+        MK_CORE_INFO(" Parallel shader compile: {0}", s_ParallelShaderCompile ? "yes" : "no");
+    }
+
+    bool OpenGLCapabilities::HasExtension(const std::string& name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++)
+        {
+            const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (extension && name == extension)
+                return true;
+        }
+        return false;
+    }
+}
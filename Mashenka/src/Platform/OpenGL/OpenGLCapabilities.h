@@ -0,0 +1,26 @@
+﻿#pragma once
+#include <string>
+
+namespace Mashenka
+{
+    // Optional OpenGL features, queried once the context is current
+    // Glad is generated for core 4.6 without extensions, extension entry points are loaded here
+    class OpenGLCapabilities
+    {
+    public:
+        static void Init();
+
+        static bool HasExtension(const std::string& name);
+
+        // GL_KHR_parallel_shader_compile (or the ARB version): the driver compiles on its own threads
+        // and GL_COMPLETION_STATUS_KHR can be queried without blocking
+        static bool SupportsParallelShaderCompile() { return s_ParallelShaderCompile; }
+
+        // GL_RENDERER, e.g. to tell a software rasterizer (llvmpipe) from a GPU
+        static const std::string& GetRendererName() { return s_RendererName; }
+
+    private:
+        static bool s_ParallelShaderCompile;
+        static std::string s_RendererName;
+    };
+}
@@ -0,0 +1,131 @@
+﻿#include "mkpch.h"
+#include "Platform/OpenGL/OpenGLComputeShader.h"
+#include "Mashenka/Renderer/RendererStats.h"
+#include <glad/glad.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <filesystem>
+
+namespace Mashenka
+{
+    OpenGLComputeShader::OpenGLComputeShader(const std::string& filepath)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        m_Name = std::filesystem::path(filepath).stem().string();
+
+        std::ifstream in(filepath, std::ios::in | std::ios::binary);
+        if (!in)
+        {
+            MK_CORE_ERROR("Could not open file '{0}'", filepath);
+            return;
+        }
+        std::stringstream source;
+        source << in.rdbuf();
+        std::string sourceString = source.str();
+        // the whole file goes to the compiler, a UTF-8 BOM in front of #version would not compile
+        if (sourceString.compare(0, 3, "\xEF\xBB\xBF") == 0)
+            sourceString.erase(0, 3);
+        Compile(sourceString);
+    }
+
+    OpenGLComputeShader::~OpenGLComputeShader()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        glDeleteProgram(m_RendererID);
+    }
+
+    void OpenGLComputeShader::Compile(const std::string& source)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+        const GLchar* sourceCStr = source.c_str();
+        glShaderSource(shader, 1, &sourceCStr, nullptr);
+        glCompileShader(shader);
+
+        GLint isCompiled = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+        if (isCompiled == GL_FALSE)
+        {
+            GLint maxLength = 0;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
+            // The maxLength includes the NULL character
+            std::vector<GLchar> infoLog(maxLength);
+            glGetShaderInfoLog(shader, maxLength, &maxLength, &infoLog[0]);
+            glDeleteShader(shader);
+
+            MK_CORE_ERROR("{0}: {1}", m_Name, infoLog.data());
+            MK_CORE_ASSERT(false, "Compute shader compilation failure!");
+            return;
+        }
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, shader);
+        glLinkProgram(program);
+        // The program keeps what it needs, don't leak the shader
+        glDetachShader(program, shader);
+        glDeleteShader(shader);
+
+        GLint isLinked = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+        if (isLinked == GL_FALSE)
+        {
+            GLint maxLength = 0;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
+            std::vector<GLchar> infoLog(maxLength);
+            glGetProgramInfoLog(program, maxLength, &maxLength, &infoLog[0]);
+            glDeleteProgram(program);
+
+            MK_CORE_ERROR("{0}: {1}", m_Name, infoLog.data());
+            MK_CORE_ASSERT(false, "Compute shader link failure!");
+            return;
+        }
+
+        m_RendererID = program;
+    }
+
+    void OpenGLComputeShader::Bind() const
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        RendererStats::AddShaderBind();
+        glUseProgram(m_RendererID);
+    }
+
+    int OpenGLComputeShader::GetUniformLocation(const std::string& name) const
+    {
+        const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+        if (location == -1)
+        {
+            MK_CORE_ERROR("Uniform {0} not found!", name);
+        }
+        return location;
+    }
+
+    // glProgramUniform* writes to the program directly, no need to bind it first
+    void OpenGLComputeShader::SetInt(const std::string& name, int value)
+    {
+        glProgramUniform1i(m_RendererID, GetUniformLocation(name), value);
+    }
+
+    void OpenGLComputeShader::SetFloat(const std::string& name, float value)
+    {
+        glProgramUniform1f(m_RendererID, GetUniformLocation(name), value);
+    }
+
+    void OpenGLComputeShader::SetFloat2(const std::string& name, const glm::vec2& value)
+    {
+        glProgramUniform2f(m_RendererID, GetUniformLocation(name), value.x, value.y);
+    }
+
+    void OpenGLComputeShader::SetFloat4(const std::string& name, const glm::vec4& value)
+    {
+        glProgramUniform4f(m_RendererID, GetUniformLocation(name), value.x, value.y, value.z, value.w);
+    }
+
+    void OpenGLComputeShader::Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        Bind();
+        glDispatchCompute(groupsX, groupsY, groupsZ);
+        // Explanation: https://www.khronos.org/opengl/wiki/Memory_Model#Ensuring_visibility
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    }
+}
@@ -0,0 +1,31 @@
+﻿#pragma once
+#include "Mashenka/Renderer/ComputeShader.h"
+
+namespace Mashenka
+{
+    class OpenGLComputeShader : public ComputeShader
+    {
+    public:
+        OpenGLComputeShader(const std::string& filepath);
+        ~OpenGLComputeShader() override;
+
+        void Bind() const override;
+
+        void SetInt(const std::string& name, int value) override;
+        void SetFloat(const std::string& name, float value) override;
+        void SetFloat2(const std::string& name, const glm::vec2& value) override;
+        void SetFloat4(const std::string& name, const glm::vec4& value) override;
+
+        void Dispatch(uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1) override;
+
+        const std::string& GetName() const override { return m_Name; }
+
+    private:
+        void Compile(const std::string& source);
+        int GetUniformLocation(const std::string& name) const;
+
+    private:
+        uint32_t m_RendererID = 0;
+        std::string m_Name;
+    };
+}
@@ -1,5 +1,6 @@
 ﻿#include "mkpch.h"
 #include "Platform/OpenGl/OpenGLContext.h"
+#include "Platform/OpenGL/OpenGLCapabilities.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -45,6 +46,9 @@ namespace Mashenka
         MK_CORE_ASSERT(versionMajor > 4 || (versionMajor == 4 && versionMinor >= 5),
                        "Mashenka requires at least OpenGL version 4.5!");
 #endif
+
+        // Optional features and extensions
+        OpenGLCapabilities::Init();
     }
 
     void OpenGLContext::SwapBuffers()
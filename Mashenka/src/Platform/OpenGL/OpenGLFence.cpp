@@ -0,0 +1,31 @@
+﻿#include "mkpch.h"
+#include "Platform/OpenGL/OpenGLFence.h"
+#include <glad/glad.h>
+
+namespace Mashenka
+{
+    OpenGLFence::OpenGLFence()
+    {
+        // Explanation: https://www.khronos.org/opengl/wiki/Sync_Object
+        m_Sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    OpenGLFence::~OpenGLFence()
+    {
+        glDeleteSync(m_Sync);
+    }
+
+    bool OpenGLFence::IsSignaled() const
+    {
+        GLint status = GL_UNSIGNALED;
+        glGetSynciv(m_Sync, GL_SYNC_STATUS, 1, nullptr, &status);
+        return status == GL_SIGNALED;
+    }
+
+    bool OpenGLFence::Wait(uint64_t timeoutNanoseconds) const
+    {
+        // flush, or the fence may never reach the GPU and the wait runs into the timeout
+        GLenum result = glClientWaitSync(m_Sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNanoseconds);
+        return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+    }
+}
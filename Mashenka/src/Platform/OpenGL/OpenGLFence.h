@@ -0,0 +1,21 @@
+﻿#pragma once
+#include "Mashenka/Renderer/GPUFence.h"
+
+typedef struct __GLsync* GLsync;
+
+namespace Mashenka
+{
+    // A sync object from glFenceSync
+    class OpenGLFence : public GPUFence
+    {
+    public:
+        OpenGLFence();
+        ~OpenGLFence() override;
+
+        bool IsSignaled() const override;
+        bool Wait(uint64_t timeoutNanoseconds) const override;
+
+    private:
+        GLsync m_Sync;
+    };
+}
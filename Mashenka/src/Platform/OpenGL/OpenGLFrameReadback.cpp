@@ -0,0 +1,87 @@
+﻿#include "mkpch.h"
+#include "Platform/OpenGL/OpenGLFrameReadback.h"
+#include <glad/glad.h>
+#include <cstring>
+
+namespace Mashenka
+{
+    OpenGLFrameReadback::OpenGLFrameReadback(uint32_t bufferCount)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        MK_CORE_ASSERT(bufferCount > 0, "FrameReadback needs at least one buffer!");
+        m_Buffers.resize(bufferCount);
+        for (auto& buffer : m_Buffers)
+            glCreateBuffers(1, &buffer.RendererID);
+    }
+
+    OpenGLFrameReadback::~OpenGLFrameReadback()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        for (auto& buffer : m_Buffers)
+            glDeleteBuffers(1, &buffer.RendererID);
+    }
+
+    bool OpenGLFrameReadback::Request(uint32_t width, uint32_t height)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        const auto bufferCount = static_cast<uint32_t>(m_Buffers.size());
+        if (m_PendingCount == bufferCount)
+            return false;
+
+        PixelBuffer& buffer = m_Buffers[(m_Oldest + m_PendingCount) % bufferCount];
+        const uint32_t size = width * height * 4;
+        if (buffer.Capacity < size)
+        {
+            // Explanation: https://www.khronos.org/opengl/wiki/Pixel_Buffer_Object
+            glNamedBufferData(buffer.RendererID, size, nullptr, GL_STREAM_READ);
+            buffer.Capacity = size;
+        }
+        buffer.Width = width;
+        buffer.Height = height;
+
+        // with a pack buffer bound, the last argument is an offset into it and the call doesn't wait for the GPU
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.RendererID);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_BGRA, GL_UNSIGNED_BYTE,
+                     nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        buffer.Fence = GPUFence::Create();
+
+        m_PendingCount++;
+        return true;
+    }
+
+    FrameReadback::PollResult OpenGLFrameReadback::Poll(std::vector<uint8_t>& pixels, uint32_t& width,
+                                                        uint32_t& height)
+    {
+        if (m_PendingCount == 0)
+            return PollResult::NotReady;
+
+        PixelBuffer& buffer = m_Buffers[m_Oldest];
+        if (!buffer.Fence->IsSignaled())
+            return PollResult::NotReady;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        width = buffer.Width;
+        height = buffer.Height;
+        const size_t size = static_cast<size_t>(width) * height * 4;
+        pixels.resize(size);
+
+        // the copy is done, mapping doesn't wait
+        const void* data = glMapNamedBufferRange(buffer.RendererID, 0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT);
+        if (data)
+        {
+            std::memcpy(pixels.data(), data, size);
+            glUnmapNamedBuffer(buffer.RendererID);
+        }
+        else
+        {
+            MK_CORE_ERROR("FrameReadback: failed to map the pixel buffer");
+        }
+
+        buffer.Fence.reset();
+        m_Oldest = (m_Oldest + 1) % static_cast<uint32_t>(m_Buffers.size());
+        m_PendingCount--;
+        return data ? PollResult::Ready : PollResult::Failed;
+    }
+}
@@ -0,0 +1,31 @@
+﻿#pragma once
+#include "Mashenka/Renderer/FrameReadback.h"
+#include "Mashenka/Renderer/GPUFence.h"
+
+namespace Mashenka
+{
+    // A ring of pixel pack buffers, glReadPixels into a bound GL_PIXEL_PACK_BUFFER returns right away
+    class OpenGLFrameReadback : public FrameReadback
+    {
+    public:
+        OpenGLFrameReadback(uint32_t bufferCount);
+        ~OpenGLFrameReadback() override;
+
+        bool Request(uint32_t width, uint32_t height) override;
+        PollResult Poll(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) override;
+        uint32_t GetPendingCount() const override { return m_PendingCount; }
+
+    private:
+        struct PixelBuffer
+        {
+            uint32_t RendererID = 0;
+            uint32_t Capacity = 0; // bytes
+            uint32_t Width = 0, Height = 0;
+            Scope<GPUFence> Fence;
+        };
+
+        std::vector<PixelBuffer> m_Buffers;
+        uint32_t m_Oldest = 0; // next buffer Poll looks at
+        uint32_t m_PendingCount = 0;
+    };
+}
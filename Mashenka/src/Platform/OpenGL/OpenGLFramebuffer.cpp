@@ -0,0 +1,123 @@
+﻿#include "mkpch.h"
+#include "Platform/OpenGL/OpenGLFramebuffer.h"
+#include <glad/glad.h>
+
+namespace Mashenka
+{
+    static const uint32_t s_MaxFramebufferSize = 8192;
+
+    OpenGLFramebuffer::OpenGLFramebuffer(const FramebufferSpecification& specification)
+        : m_Specification(specification)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        Invalidate();
+    }
+
+    OpenGLFramebuffer::~OpenGLFramebuffer()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        Release();
+    }
+
+    void OpenGLFramebuffer::Release()
+    {
+        glDeleteFramebuffers(1, &m_RendererID);
+        glDeleteTextures(1, &m_ColorAttachment);
+        glDeleteTextures(1, &m_DepthAttachment);
+        m_RendererID = m_ColorAttachment = m_DepthAttachment = 0;
+    }
+
+    void OpenGLFramebuffer::Invalidate()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (m_RendererID)
+            Release();
+
+        // Explanation: https://www.khronos.org/opengl/wiki/Framebuffer_Object
+        glCreateFramebuffers(1, &m_RendererID);
+        const uint32_t width = m_Specification.Width;
+        const uint32_t height = m_Specification.Height;
+        const bool multisampled = m_Specification.Samples > 1;
+        const GLenum target = multisampled ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+
+        glCreateTextures(target, 1, &m_ColorAttachment);
+        if (multisampled)
+        {
+            glTextureStorage2DMultisample(m_ColorAttachment, m_Specification.Samples, GL_RGBA8, width, height, GL_FALSE);
+        }
+        else
+        {
+            glTextureStorage2D(m_ColorAttachment, 1, GL_RGBA8, width, height);
+            glTextureParameteri(m_ColorAttachment, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTextureParameteri(m_ColorAttachment, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTextureParameteri(m_ColorAttachment, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTextureParameteri(m_ColorAttachment, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+        glNamedFramebufferTexture(m_RendererID, GL_COLOR_ATTACHMENT0, m_ColorAttachment, 0);
+
+        if (m_Specification.Depth)
+        {
+            glCreateTextures(target, 1, &m_DepthAttachment);
+            if (multisampled)
+                glTextureStorage2DMultisample(m_DepthAttachment, m_Specification.Samples, GL_DEPTH24_STENCIL8,
+                                              width, height, GL_FALSE);
+            else
+                glTextureStorage2D(m_DepthAttachment, 1, GL_DEPTH24_STENCIL8, width, height);
+            glNamedFramebufferTexture(m_RendererID, GL_DEPTH_STENCIL_ATTACHMENT, m_DepthAttachment, 0);
+        }
+
+        MK_CORE_ASSERT(glCheckNamedFramebufferStatus(m_RendererID, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE,
+                       "Framebuffer is incomplete!");
+    }
+
+    void OpenGLFramebuffer::Bind()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+        glViewport(0, 0, m_Specification.Width, m_Specification.Height);
+    }
+
+    void OpenGLFramebuffer::Unbind()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    void OpenGLFramebuffer::Resize(uint32_t width, uint32_t height)
+    {
+        if (width == 0 || height == 0 || width > s_MaxFramebufferSize || height > s_MaxFramebufferSize)
+        {
+            MK_CORE_WARN("Attempted to resize framebuffer to {0}, {1}", width, height);
+            return;
+        }
+        if (width == m_Specification.Width && height == m_Specification.Height)
+            return;
+
+        m_Specification.Width = width;
+        m_Specification.Height = height;
+        Invalidate();
+    }
+
+    void OpenGLFramebuffer::Resolve(const Ref<Framebuffer>& target) const
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        const auto& destination = static_cast<const OpenGLFramebuffer&>(*target);
+        MK_CORE_ASSERT(destination.m_Specification.Width == m_Specification.Width &&
+                       destination.m_Specification.Height == m_Specification.Height,
+                       "Resolve needs framebuffers of the same size!");
+        // multisampled sources can only be blit 1:1, the samples are averaged on the way
+        glBlitNamedFramebuffer(m_RendererID, destination.m_RendererID,
+                               0, 0, m_Specification.Width, m_Specification.Height,
+                               0, 0, m_Specification.Width, m_Specification.Height,
+                               GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+
+    void OpenGLFramebuffer::BlitToScreen(uint32_t width, uint32_t height, bool linearFilter) const
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        MK_CORE_ASSERT(m_Specification.Samples == 1 || (width == m_Specification.Width && height == m_Specification.Height),
+                       "A multisampled framebuffer has to be resolved before it is scaled!");
+        glBlitNamedFramebuffer(m_RendererID, 0,
+                               0, 0, m_Specification.Width, m_Specification.Height,
+                               0, 0, width, height,
+                               GL_COLOR_BUFFER_BIT, linearFilter ? GL_LINEAR : GL_NEAREST);
+    }
+}
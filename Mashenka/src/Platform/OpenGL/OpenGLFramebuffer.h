@@ -0,0 +1,36 @@
+﻿#pragma once
+#include "Mashenka/Renderer/Framebuffer.h"
+
+namespace Mashenka
+{
+    class OpenGLFramebuffer : public Framebuffer
+    {
+    public:
+        OpenGLFramebuffer(const FramebufferSpecification& specification);
+        ~OpenGLFramebuffer() override;
+
+        void Bind() override;
+        void Unbind() override;
+
+        void Resize(uint32_t width, uint32_t height) override;
+
+        void Resolve(const Ref<Framebuffer>& target) const override;
+        void BlitToScreen(uint32_t width, uint32_t height, bool linearFilter = true) const override;
+
+        uint32_t GetColorAttachmentRendererID() const override { return m_ColorAttachment; }
+        const FramebufferSpecification& GetSpecification() const override { return m_Specification; }
+
+        uint32_t GetRendererID() const { return m_RendererID; }
+
+    private:
+        // (re)creates the framebuffer and its attachments for the current specification
+        void Invalidate();
+        void Release();
+
+    private:
+        uint32_t m_RendererID = 0;
+        uint32_t m_ColorAttachment = 0;
+        uint32_t m_DepthAttachment = 0;
+        FramebufferSpecification m_Specification;
+    };
+}
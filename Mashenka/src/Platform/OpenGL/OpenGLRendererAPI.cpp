@@ -1,5 +1,6 @@
 ﻿#include "mkpch.h"
 #include "Platform/OpenGL/OpenGLRendererAPI.h"
+#include "Platform/OpenGL/OpenGLBuffer.h"
 
 #include "glad/glad.h"
 
@@ -76,11 +77,43 @@ namespace Mashenka
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
 
-    void OpenGLRendererAPI::DrawIndexed(const Ref<Mashenka::VertexArray>& vertexArray)
+    void OpenGLRendererAPI::DrawIndexed(const Ref<Mashenka::VertexArray>& vertexArray, uint32_t indexCount)
     {
         // Opengl function
-        glDrawElements(GL_TRIANGLES, vertexArray->GetIndexBuffer()->GetCount(), GL_UNSIGNED_INT, nullptr);
+        uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
+        glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
 
         glBindTexture(GL_TEXTURE_2D, 0); // unbind the texture, so that we can use the texture slot for other textures
     }
+
+    void OpenGLRendererAPI::DrawIndexedInstanced(const Ref<Mashenka::VertexArray>& vertexArray, uint32_t indexCount,
+                                                 uint32_t instanceCount)
+    {
+        // Opengl function
+        uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
+        glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, instanceCount);
+    }
+
+    void OpenGLRendererAPI::DrawIndexedIndirect(const Ref<Mashenka::VertexArray>& vertexArray,
+                                                const Ref<StorageBuffer>& commands, uint32_t offset)
+    {
+        // Explanation: https://www.khronos.org/opengl/wiki/Vertex_Rendering#Indirect_rendering
+        const auto& buffer = static_cast<const OpenGLStorageBuffer&>(*commands);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer.GetRendererID());
+        glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(static_cast<uintptr_t>(offset)));
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void OpenGLRendererAPI::MultiDrawIndexedIndirect(const Ref<Mashenka::VertexArray>& vertexArray,
+                                                     const Ref<StorageBuffer>& commands, uint32_t drawCount,
+                                                     uint32_t offset)
+    {
+        // Explanation: https://www.khronos.org/opengl/wiki/GLAPI/glMultiDrawElementsIndirect
+        const auto& buffer = static_cast<const OpenGLStorageBuffer&>(*commands);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer.GetRendererID());
+        // stride 0, the commands are tightly packed
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                    reinterpret_cast<const void*>(static_cast<uintptr_t>(offset)), drawCount, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
 }
@@ -13,7 +13,14 @@ namespace Mashenka
         // override the virtual functions from RendererAPI
         virtual void SetClearColor(const glm::vec4& color) override;
         virtual void Clear() override;
-        virtual void DrawIndexed(const Ref<Mashenka::VertexArray>& vertexArray) override;
+        virtual void DrawIndexed(const Ref<Mashenka::VertexArray>& vertexArray, uint32_t indexCount = 0) override;
+        virtual void DrawIndexedInstanced(const Ref<Mashenka::VertexArray>& vertexArray, uint32_t indexCount,
+                                          uint32_t instanceCount) override;
+        virtual void DrawIndexedIndirect(const Ref<Mashenka::VertexArray>& vertexArray,
+                                         const Ref<StorageBuffer>& commands, uint32_t offset = 0) override;
+        virtual void MultiDrawIndexedIndirect(const Ref<Mashenka::VertexArray>& vertexArray,
+                                              const Ref<StorageBuffer>& commands, uint32_t drawCount,
+                                              uint32_t offset = 0) override;
     
     
     };
@@ -1,7 +1,15 @@
 ﻿#include "mkpch.h"
 #include "Platform/OpenGL/OpenGLShader.h"
+#include "Platform/OpenGL/OpenGLCapabilities.h"
+#include "Mashenka/Renderer/RendererStats.h"
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
+#include <filesystem>
+
+// KHR_parallel_shader_compile is not part of the generated glad
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
 
 namespace Mashenka
@@ -27,22 +35,99 @@ Draw Call: OpenGL uses the active program when performing draw calls.
         return 0;
     }
 
+    /*
+     * Program binary cache
+     * Linked programs are written to disk with glGetProgramBinary and loaded back with glProgramBinary on the
+     * next launch. The key is a hash of the preprocessed sources and the driver strings, so editing a shader or
+     * updating the driver falls back to a full compile, which then refreshes the cache
+     */
+    static const char* s_ShaderCacheDirectory = "assets/cache/shader/opengl";
+    static constexpr uint32_t s_ShaderCacheMagic = 0x42534B4D; // "MKSB"
+
+    struct ShaderCacheHeader
+    {
+        uint32_t Magic;
+        uint64_t Hash;
+        GLenum BinaryFormat;
+        uint32_t BinaryLength;
+    };
+
+    // FNV-1a, good enough to detect changes, not meant to be secure
+    static uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static uint64_t HashShaderSources(const std::unordered_map<GLenum, std::string>& shaderSources)
+    {
+        uint64_t hash = 14695981039346656037ull;
+
+        // The binary is only valid for the driver that created it
+        for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+        {
+            const char* driverString = reinterpret_cast<const char*>(glGetString(name));
+            if (driverString)
+                hash = HashBytes(hash, driverString, strlen(driverString));
+        }
+
+        // unordered_map has no fixed order, so hash the stages sorted by type
+        std::vector<GLenum> stages;
+        for (auto& kv : shaderSources)
+            stages.push_back(kv.first);
+        std::sort(stages.begin(), stages.end());
+        for (GLenum stage : stages)
+        {
+            const std::string& source = shaderSources.at(stage);
+            hash = HashBytes(hash, &stage, sizeof(stage));
+            hash = HashBytes(hash, source.data(), source.size());
+        }
+        return hash;
+    }
+
+    static bool IsProgramBinarySupported()
+    {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }
+
+    // Add "#define <variant>" right after the #version line, which has to stay the first statement
+    static std::string InjectVariantDefine(const std::string& source, const std::string& variant)
+    {
+        std::string define = "#define " + variant + "\n";
+        size_t versionPos = source.find("#version");
+        if (versionPos == std::string::npos)
+            return define + source;
+
+        size_t eol = source.find('\n', versionPos);
+        if (eol == std::string::npos)
+            return source + "\n" + define;
+        return source.substr(0, eol + 1) + define + source.substr(eol + 1);
+    }
+
     OpenGLShader::OpenGLShader(const std::string& filepath)
+        : m_Filepath(filepath)
     {
         MK_PROFILE_FUNCTION(); // Profiling
-        // Read the file
-        std::string source = Readfile(filepath);
-        // Preprocess the file
-        auto shaderSources = PreProcess(source);
-        // Compile the shader
-        Compile(shaderSources);
-
-        // Extract name from filepath
+        // Extract name from filepath, the name is also used for the cache file
         auto lastSlash = filepath.find_last_of("/\\");
         lastSlash = lastSlash == std::string::npos ? 0 : lastSlash + 1;
         auto lastDot = filepath.rfind('.');
         auto count = lastDot == std::string::npos ? filepath.size() - lastSlash : lastDot - lastSlash;
         m_Name = filepath.substr(lastSlash, count);
+
+        // Read the file
+        std::string source = Readfile(filepath);
+        // Preprocess the file
+        auto shaderSource = PreProcess(source);
+        // Compile the base program and the variants, using the program binary cache where possible
+        m_Programs = CreatePrograms(shaderSource, IsProgramBinarySupported());
     }
 
     std::string OpenGLShader::Readfile(const std::string& filepath)
@@ -76,11 +161,33 @@ Draw Call: OpenGL uses the active program when performing draw calls.
         return result;
     }
 
-    std::unordered_map<GLenum, std::string> OpenGLShader::PreProcess(const std::string& source)
+    OpenGLShaderSource OpenGLShader::PreProcess(const std::string& fileSource)
     {
         MK_PROFILE_FUNCTION(); // Profiling
+        OpenGLShaderSource result;
+
+        // Collect the variant declarations ("#variant NAME") and remove them, they are not GLSL
+        std::string source = fileSource;
+        const char* variantToken = "#variant";
+        size_t variantTokenLength = strlen(variantToken);
+        size_t variantPos = source.find(variantToken, 0);
+        while (variantPos != std::string::npos)
+        {
+            size_t eol = source.find_first_of("\r\n", variantPos); // End of variant declaration line
+            if (eol == std::string::npos)
+                eol = source.size();
+            size_t begin = variantPos + variantTokenLength + 1; // Start of variant name (after "#variant " keyword)
+            MK_CORE_ASSERT(begin < eol, "Syntax error");
+            std::string variant = source.substr(begin, eol - begin);
+            variant.erase(variant.find_last_not_of(" \t") + 1);
+            result.Variants.push_back(variant);
+
+            source.erase(variantPos, eol - variantPos);
+            variantPos = source.find(variantToken, variantPos);
+        }
+
         // create a map of the shader sources
-        std::unordered_map<GLenum, std::string> shaderSources;
+        std::unordered_map<GLenum, std::string>& shaderSources = result.Stages;
         const char* typeToken = "#type";
         size_t typeTokenLength = strlen(typeToken);
         size_t pos = source.find(typeToken, 0); // Start of shader type declaration line
@@ -101,17 +208,53 @@ Draw Call: OpenGL uses the active program when performing draw calls.
                 (pos == std::string::npos) ? source.substr(nextLinePos) : source.substr(nextLinePos, pos - nextLinePos);
         }
         // return the shader sources
-        return shaderSources;
+        return result;
+    }
+
+    std::vector<OpenGLShader::Program> OpenGLShader::CreatePrograms(const OpenGLShaderSource& source, bool useCache)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // The base program has no variant defined, then one program per declared variant
+        std::vector<std::string> variants = {""};
+        variants.insert(variants.end(), source.Variants.begin(), source.Variants.end());
+
+        std::vector<Program> programs;
+        programs.reserve(variants.size());
+        for (const auto& variant : variants)
+        {
+            Program program;
+            program.Variant = variant;
+
+            std::unordered_map<GLenum, std::string> stages = source.Stages;
+            if (!variant.empty())
+            {
+                for (auto& kv : stages)
+                    kv.second = InjectVariantDefine(kv.second, variant);
+            }
+
+            // Use the cached program binary when it matches the sources and the driver, compile otherwise
+            uint64_t hash = useCache ? HashShaderSources(stages) : 0;
+            if (!useCache || !LoadProgramBinary(program, hash))
+            {
+                // Compile the shader, the binary is saved once the link has finished
+                Compile(program, stages);
+                program.SaveToCache = useCache;
+                program.CacheHash = hash;
+            }
+            programs.push_back(std::move(program));
+        }
+        return programs;
     }
 
-    void OpenGLShader::Compile(const std::unordered_map<GLenum, std::string>& shaderSources)
+    void OpenGLShader::Compile(Program& program, const std::unordered_map<GLenum, std::string>& shaderSources)
     {
         MK_PROFILE_FUNCTION(); // Profiling
+        // Compile and link are only submitted here, asking for the status would wait for the compiler.
+        // With KHR_parallel_shader_compile the driver compiles on its own threads, so shaders created one after
+        // the other (e.g. by a ShaderLibrary) compile at the same time. The status is checked on first use
         // Get a program object.
-        GLuint program = glCreateProgram();
+        GLuint rendererID = glCreateProgram();
         MK_CORE_ASSERT(shaderSources.size() <= 2, "We only support 2 shaders for now");
-        std::array<GLenum, 2> glShaderIDs;
-        int glShaderIDIndex = 0;
         for (auto& kv : shaderSources)
         {
             GLenum type = kv.first;
@@ -127,7 +270,58 @@ Draw Call: OpenGL uses the active program when performing draw calls.
             // Compile the shader object.
             glCompileShader(shader);
 
-            // Check the shader object compile status
+            // Attach a shader object to a program object, linking waits for the compile on the driver side
+            glAttachShader(rendererID, shader);
+            program.PendingShaders.push_back(shader);
+        }
+
+        program.RendererID = rendererID;
+
+        // let the driver know we want to read the binary back for the cache
+        glProgramParameteri(rendererID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+        // link the program object
+        glLinkProgram(rendererID);
+        program.CompilePending = true;
+    }
+
+    bool OpenGLShader::IsReady() const
+    {
+        for (const Program& program : m_Programs)
+        {
+            if (!IsProgramReady(program))
+                return false;
+        }
+        return true;
+    }
+
+    bool OpenGLShader::IsProgramReady(const Program& program) const
+    {
+        if (!program.CompilePending)
+            return true;
+
+        // Without the extension there is no way to ask without blocking, report ready and let the first use wait
+        // A hot reload then finalizes on the main thread and stalls that frame, ShaderLibrary warns about it
+        if (!OpenGLCapabilities::SupportsParallelShaderCompile())
+            return true;
+
+        GLint isCompleted = GL_FALSE;
+        glGetProgramiv(program.RendererID, GL_COMPLETION_STATUS_KHR, &isCompleted);
+        return isCompleted != GL_FALSE;
+    }
+
+    bool OpenGLShader::FinalizeCompile(Program& program, std::string& error) const
+    {
+        if (!program.CompilePending)
+            return true;
+
+        MK_PROFILE_FUNCTION(); // Profiling
+        program.CompilePending = false;
+
+        // Check the shader objects compile status, this blocks if the driver is still compiling
+        bool failed = false;
+        for (GLuint shader : program.PendingShaders)
+        {
             GLint isCompiled = 0;
             glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
             if (isCompiled == GL_FALSE)
@@ -139,48 +333,149 @@ Draw Call: OpenGL uses the active program when performing draw calls.
                 std::vector<GLchar> infoLog(maxLength);
                 glGetShaderInfoLog(shader, maxLength, &maxLength, &infoLog[0]);
 
-                // We don't need the shader anymore.
-                glDeleteShader(shader);
-
-                // Use the infoLog as you see fit.
-                MK_CORE_ERROR("{0}", infoLog.data());
-                MK_CORE_ASSERT(false, "Shader compilation failure!");
-                break;
+                error += fmt::format("{0}{1} [{2}] failed to compile: {3}", error.empty() ? "" : "\n", m_Name,
+                                     program.Variant, infoLog.data());
+                failed = true;
             }
-
-            // Attach a shader object to a program object.
-            glAttachShader(program, shader);
-            glShaderIDs[glShaderIDIndex++] = shader;
         }
 
-        m_RendererID = program;
-
-        // link the program object
-        glLinkProgram(program);
-
         // Note the different functions here: glGetProgram* instead of glGetShader*.
         GLint isLinked = 0;
-        glGetProgramiv(program, GL_LINK_STATUS, (int*)&isLinked);
-        if (isLinked == GL_FALSE)
+        glGetProgramiv(program.RendererID, GL_LINK_STATUS, (int*)&isLinked);
+        if (!failed && isLinked == GL_FALSE)
         {
             GLint maxLength = 0;
-            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
+            glGetProgramiv(program.RendererID, GL_INFO_LOG_LENGTH, &maxLength);
 
             // The maxLength includes the NULL character
             std::vector<GLchar> infoLog(maxLength);
-            glGetProgramInfoLog(program, maxLength, &maxLength, &infoLog[0]);
+            glGetProgramInfoLog(program.RendererID, maxLength, &maxLength, &infoLog[0]);
 
-            // We don't need the program anymore.
-            glDeleteProgram(program);
-            // Don't leak shaders either.
-            for (auto id : glShaderIDs)
-                glDeleteShader(id);
+            error = fmt::format("{0} [{1}] failed to link: {2}", m_Name, program.Variant, infoLog.data());
+            failed = true;
+        }
 
-            // Use the infoLog as you see fit.
-            MK_CORE_ERROR("{0}", infoLog.data());
-            MK_CORE_ASSERT(false, "Shader link failure!");
+        // The program keeps what it needs, don't leak the shaders
+        for (GLuint shader : program.PendingShaders)
+        {
+            glDetachShader(program.RendererID, shader);
+            glDeleteShader(shader);
+        }
+        program.PendingShaders.clear();
+
+        if (!failed && program.SaveToCache)
+            SaveProgramBinary(program);
+        return !failed;
+    }
+
+    uint32_t OpenGLShader::GetRendererID() const
+    {
+        // first use waits for the compile to finish
+        Program& program = m_Programs[m_ActiveProgram];
+        std::string error;
+        if (program.CompilePending && !FinalizeCompile(program, error))
+        {
+            // unlike a failed reload there is no previous version to keep, a broken program must not be used
+            MK_CORE_ERROR("{0}", error);
+            glDeleteProgram(program.RendererID);
+            program.RendererID = 0;
+            MK_CORE_ASSERT(false, "Shader compilation failure!");
+        }
+        return program.RendererID;
+    }
+
+    bool OpenGLShader::HasVariant(const std::string& variant) const
+    {
+        for (const Program& program : m_Programs)
+        {
+            if (program.Variant == variant)
+                return true;
+        }
+        return false;
+    }
+
+    void OpenGLShader::SetVariant(const std::string& variant)
+    {
+        for (uint32_t i = 0; i < m_Programs.size(); i++)
+        {
+            if (m_Programs[i].Variant == variant)
+            {
+                m_ActiveProgram = i;
+                return;
+            }
+        }
+        MK_CORE_ASSERT(false, "Unknown shader variant!");
+    }
+
+    std::string OpenGLShader::GetCachePath(const std::string& variant) const
+    {
+        std::string path = std::string(s_ShaderCacheDirectory) + "/" + m_Name;
+        if (!variant.empty())
+            path += "." + variant;
+        return path + ".bin";
+    }
+
+    bool OpenGLShader::LoadProgramBinary(Program& program, uint64_t hash)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        std::ifstream in(GetCachePath(program.Variant), std::ios::in | std::ios::binary);
+        if (!in)
+            return false;
+
+        // a stale cache is not an error, the caller compiles and overwrites it
+        ShaderCacheHeader header{};
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || header.Magic != s_ShaderCacheMagic || header.Hash != hash || header.BinaryLength == 0)
+            return false;
+
+        std::vector<char> binary(header.BinaryLength);
+        in.read(binary.data(), header.BinaryLength);
+        if (!in)
+            return false;
+
+        GLuint rendererID = glCreateProgram();
+        glProgramBinary(rendererID, header.BinaryFormat, binary.data(), static_cast<GLsizei>(header.BinaryLength));
+
+        // The driver may still reject a binary, e.g. after a driver update that kept the version string
+        GLint isLinked = 0;
+        glGetProgramiv(rendererID, GL_LINK_STATUS, &isLinked);
+        if (isLinked == GL_FALSE)
+        {
+            MK_CORE_WARN("Cached program binary for shader '{0}' was rejected, recompiling", m_Name);
+            glDeleteProgram(rendererID);
+            return false;
+        }
+
+        program.RendererID = rendererID;
+        return true;
+    }
+
+    void OpenGLShader::SaveProgramBinary(const Program& program) const
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        GLint length = 0;
+        glGetProgramiv(program.RendererID, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+
+        ShaderCacheHeader header{};
+        header.Magic = s_ShaderCacheMagic;
+        header.Hash = program.CacheHash;
+        std::vector<char> binary(length);
+        glGetProgramBinary(program.RendererID, length, nullptr, &header.BinaryFormat, binary.data());
+        header.BinaryLength = static_cast<uint32_t>(length);
+
+        std::string path = GetCachePath(program.Variant);
+        std::error_code error;
+        std::filesystem::create_directories(s_ShaderCacheDirectory, error);
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            MK_CORE_WARN("Could not write shader cache file '{0}'", path);
             return;
         }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(binary.data(), length);
     }
 
     // Constructor
@@ -188,23 +483,138 @@ Draw Call: OpenGL uses the active program when performing draw calls.
         : m_Name(name)
     {
         MK_PROFILE_FUNCTION(); // Profiling
-        std::unordered_map<GLenum, std::string> shaderSources;
-        shaderSources[GL_VERTEX_SHADER] = vertexSrc;
-        shaderSources[GL_FRAGMENT_SHADER] = fragmentSrc;
-        Compile(shaderSources);
+        OpenGLShaderSource source;
+        source.Stages[GL_VERTEX_SHADER] = vertexSrc;
+        source.Stages[GL_FRAGMENT_SHADER] = fragmentSrc;
+        m_Programs = CreatePrograms(source, false);
     }
 
     OpenGLShader::~OpenGLShader()
     {
         MK_PROFILE_FUNCTION(); // Profiling
-        glDeleteProgram(m_RendererID);
+        // the future of a running reload waits for the worker here, it only reads the file
+        DeletePrograms(m_Programs);
+        DeletePrograms(m_ReloadPrograms);
+    }
+
+    void OpenGLShader::DeletePrograms(const std::vector<Program>& programs)
+    {
+        for (const Program& program : programs)
+        {
+            for (GLuint shader : program.PendingShaders)
+                glDeleteShader(shader);
+            glDeleteProgram(program.RendererID);
+        }
+    }
+
+    /*
+     * ==============================HOT RELOAD==============================
+     */
+    void OpenGLShader::Reload()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (m_Filepath.empty())
+        {
+            MK_CORE_WARN("Shader {0} was not loaded from a file and can't be reloaded", m_Name);
+            return;
+        }
+
+        // one reload at a time, the file is read again once the running one is done
+        if (m_ReloadSource.valid() || !m_ReloadPrograms.empty())
+        {
+            m_ReloadQueued = true;
+            return;
+        }
+
+        // Reading and preprocessing don't touch the GL context, so they run on a worker thread
+        m_ReloadSource = std::async(std::launch::async, [filepath = m_Filepath]()
+        {
+            return PreProcess(Readfile(filepath));
+        });
+    }
+
+    bool OpenGLShader::UpdateReload()
+    {
+        // Submit the compile of every variant once the worker is done, it runs on the driver threads
+        if (m_ReloadSource.valid() &&
+            m_ReloadSource.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            MK_PROFILE_SCOPE("OpenGLShader::UpdateReload Submit");
+            OpenGLShaderSource source = m_ReloadSource.get();
+            if (source.Stages.empty())
+                MK_CORE_ERROR("Reloading shader {0} failed, '{1}' has no shader stages", m_Name, m_Filepath);
+            else
+                m_ReloadPrograms = CreatePrograms(source, IsProgramBinarySupported());
+        }
+
+        if (m_ReloadPrograms.empty())
+        {
+            if (m_ReloadQueued && !m_ReloadSource.valid())
+            {
+                m_ReloadQueued = false;
+                Reload();
+            }
+            return false;
+        }
+
+        // Keep drawing with the old programs until the driver has linked all the new ones
+        for (const Program& program : m_ReloadPrograms)
+        {
+            if (!IsProgramReady(program))
+                return false;
+        }
+
+        MK_PROFILE_SCOPE("OpenGLShader::UpdateReload Swap");
+        bool compiled = true;
+        std::string error;
+        for (Program& program : m_ReloadPrograms)
+        {
+            std::string programError;
+            if (!FinalizeCompile(program, programError))
+            {
+                error += (error.empty() ? "" : "\n") + programError;
+                compiled = false;
+            }
+        }
+
+        if (compiled)
+        {
+            // Swap between two frames, so every draw uses either the old or the new programs
+            std::string activeVariant = m_Programs[m_ActiveProgram].Variant;
+            std::swap(m_Programs, m_ReloadPrograms);
+            m_ActiveProgram = 0;
+            for (uint32_t i = 0; i < m_Programs.size(); i++)
+            {
+                if (m_Programs[i].Variant == activeVariant)
+                    m_ActiveProgram = i;
+            }
+            MK_CORE_INFO("Reloaded shader {0}", m_Name);
+        }
+        else
+        {
+            MK_CORE_ERROR("Reloading shader {0} failed, keeping the previous version\n{1}", m_Name, error);
+        }
+
+        // the old programs after a swap, the broken ones otherwise
+        DeletePrograms(m_ReloadPrograms);
+        m_ReloadPrograms.clear();
+
+        if (m_ReloadQueued)
+        {
+            m_ReloadQueued = false;
+            Reload();
+        }
+        return compiled;
     }
 
     void OpenGLShader::Bind() const
     {
         MK_PROFILE_FUNCTION(); // Profiling
-        glUseProgram(
-            m_RendererID); // Install the program object specified by program as part of current rendering state.
+        uint32_t rendererID = GetRendererID();
+        if (rendererID == 0)
+            return; // the program failed to build, see GetRendererID
+        RendererStats::AddShaderBind();
+        glUseProgram(rendererID); // Install the program object specified by program as part of current rendering state.
     }
 
     void OpenGLShader::Unbind() const
@@ -222,7 +632,7 @@ Draw Call: OpenGL uses the active program when performing draw calls.
     void OpenGLShader::SetIntArray(const std::string& name, int* values, uint32_t count)
     {
         MK_PROFILE_FUNCTION(); // Profiling
-        // TODO: UploadUniformIntArray
+        UploadUniformIntArray(name, values, count);
     }
 
     void OpenGLShader::SetFloat(const std::string& name, float value)
@@ -260,7 +670,7 @@ Draw Call: OpenGL uses the active program when performing draw calls.
      */
     void OpenGLShader::UploadUniformInt(const std::string& name, int value) const
     {
-        const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+        const GLint location = glGetUniformLocation(GetRendererID(), name.c_str());
         if (location == -1)
         {
             MK_CORE_ERROR("Uniform {0} not found!", name);
@@ -268,9 +678,19 @@ Draw Call: OpenGL uses the active program when performing draw calls.
         glUniform1i(location, value);
     }
 
+    void OpenGLShader::UploadUniformIntArray(const std::string& name, const int* values, uint32_t count) const
+    {
+        const GLint location = glGetUniformLocation(GetRendererID(), name.c_str());
+        if (location == -1)
+        {
+            MK_CORE_ERROR("Uniform {0} not found!", name);
+        }
+        glUniform1iv(location, count, values);
+    }
+
     void OpenGLShader::UploadUniformFloat(const std::string& name, float value) const
     {
-        const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+        const GLint location = glGetUniformLocation(GetRendererID(), name.c_str());
         if (location == -1)
         {
             MK_CORE_ERROR("Uniform {0} not found!", name);
@@ -280,7 +700,7 @@ Draw Call: OpenGL uses the active program when performing draw calls.
 
     void OpenGLShader::UploadUniformFloat2(const std::string& name, const glm::vec2& value) const
     {
-        const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+        const GLint location = glGetUniformLocation(GetRendererID(), name.c_str());
         if (location == -1)
         {
             MK_CORE_ERROR("Uniform {0} not found!", name);
@@ -290,7 +710,7 @@ Draw Call: OpenGL uses the active program when performing draw calls.
 
     void OpenGLShader::UploadUniformFloat4(const std::string& name, const glm::vec4& value) const
     {
-        const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+        const GLint location = glGetUniformLocation(GetRendererID(), name.c_str());
         if (location == -1)
         {
             MK_CORE_ERROR("Uniform {0} not found!", name);
@@ -300,7 +720,7 @@ Draw Call: OpenGL uses the active program when performing draw calls.
 
     void OpenGLShader::UploadUniformMat3(const std::string& name, const glm::mat3& matrix) const
     {
-        const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+        const GLint location = glGetUniformLocation(GetRendererID(), name.c_str());
         if (location == -1)
         {
             MK_CORE_ERROR("Uniform {0} not found!", name);
@@ -313,7 +733,7 @@ Draw Call: OpenGL uses the active program when performing draw calls.
     // Set uniforms for screen space transformation
     void OpenGLShader::UploadUniformMat4(const std::string& name, const glm::mat4& matrix) const
     {
-        const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+        const GLint location = glGetUniformLocation(GetRendererID(), name.c_str());
         if (location == -1)
         {
             MK_CORE_ERROR("Uniform {0} not found!", name);
@@ -326,7 +746,7 @@ Draw Call: OpenGL uses the active program when performing draw calls.
     // upload uniform for vec3
     void OpenGLShader::UploadUniformFloat3(const std::string& name, const glm::vec3& vector) const
     {
-        const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+        const GLint location = glGetUniformLocation(GetRendererID(), name.c_str());
         if (location == -1)
         {
             MK_CORE_ERROR("Uniform {0} not found!", name);
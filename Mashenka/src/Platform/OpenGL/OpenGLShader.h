@@ -1,11 +1,20 @@
 ﻿#pragma once
 #include "Mashenka/Renderer/Shader.h"
 
+#include <future>
+
 // TODO: Remove!
 typedef unsigned int GLenum;
 
 namespace Mashenka
 {
+    // A preprocessed shader file: the source of each stage and the variants declared with "#variant NAME"
+    struct OpenGLShaderSource
+    {
+        std::unordered_map<GLenum, std::string> Stages;
+        std::vector<std::string> Variants;
+    };
+
     class OpenGLShader : public Shader
     {
     public:
@@ -31,23 +40,72 @@ namespace Mashenka
         void SetMat4(const std::string& name, const glm::mat4& value) override;
 
         virtual const std::string& GetName() const override {return m_Name; }
+        virtual bool IsReady() const override;
+
+        // Variants
+        virtual bool HasVariant(const std::string& variant) const override;
+        virtual void SetVariant(const std::string& variant) override;
+
+        // Hot reload
+        virtual const std::string& GetFilepath() const override { return m_Filepath; }
+        virtual void Reload() override;
+        virtual bool UpdateReload() override;
 
         // Upload uniform functions for different types
         void UploadUniformInt(const std::string& name, int value) const;
+        void UploadUniformIntArray(const std::string& name, const int* values, uint32_t count) const;
         void UploadUniformFloat(const std::string& name, float value) const;
         void UploadUniformFloat2(const std::string& name, const glm::vec2& value) const;
         void UploadUniformFloat3(const std::string& name, const glm::vec3& value) const;
         void UploadUniformFloat4(const std::string& name, const glm::vec4& value) const;
         void UploadUniformMat3(const std::string& name, const glm::mat3& matrix) const;
         void UploadUniformMat4(const std::string& name, const glm::mat4& matrix) const;
+
+        // Splits a shader file into its stages and variants, no GL calls
+        static OpenGLShaderSource PreProcess(const std::string& source);
     private:
-        std::string Readfile (const std::string& filepath);
-        std::unordered_map<GLenum, std::string> PreProcess(const std::string& source);
-        void Compile(const std::unordered_map<GLenum, std::string>& shaderSources);
+        // One linked program per variant
+        struct Program
+        {
+            std::string Variant; // empty for the base program
+            uint32_t RendererID = 0; // Shader program id
+
+            // Compile is only submitted, the status is checked on first use
+            bool CompilePending = false;
+            std::vector<uint32_t> PendingShaders;
+            bool SaveToCache = false;
+            uint64_t CacheHash = 0;
+        };
+
+        static std::string Readfile (const std::string& filepath);
+        // Create the base program and one program per variant, from the cache where possible
+        std::vector<Program> CreatePrograms(const OpenGLShaderSource& source, bool useCache);
+        void Compile(Program& program, const std::unordered_map<GLenum, std::string>& shaderSources);
+        // true when the program can be used without waiting for the driver
+        bool IsProgramReady(const Program& program) const;
+        // Check the compile and link status of the last Compile, blocks until the driver is done
+        // returns false and puts the info log into error when the compile or the link failed, the caller logs it
+        bool FinalizeCompile(Program& program, std::string& error) const;
+        static void DeletePrograms(const std::vector<Program>& programs);
+        // Program of the selected variant, waits for its compile
+        uint32_t GetRendererID() const;
+
+        // Program binary cache, see OpenGLShader.cpp
+        std::string GetCachePath(const std::string& variant) const;
+        bool LoadProgramBinary(Program& program, uint64_t hash);
+        void SaveProgramBinary(const Program& program) const;
     private:
-        // Shader program id
-        uint32_t m_RendererID;
         std::string m_Name;
+        std::string m_Filepath;
+
+        // index 0 is the base program, programs are finalized on first use, which can be from const functions
+        mutable std::vector<Program> m_Programs;
+        uint32_t m_ActiveProgram = 0;
+
+        // Hot reload, the file is preprocessed on a worker thread, the new programs replace m_Programs once linked
+        std::future<OpenGLShaderSource> m_ReloadSource;
+        std::vector<Program> m_ReloadPrograms;
+        bool m_ReloadQueued = false; // the file changed again while a reload was running
     };
 }
 
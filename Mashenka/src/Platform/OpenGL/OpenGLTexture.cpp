@@ -1,10 +1,39 @@
 ﻿#include "mkpch.h"
 #include "Platform/OpenGL/OpenGLTexture.h"
+#include "Mashenka/Renderer/TextureResidency.h"
+#include "Mashenka/Renderer/RendererStats.h"
 #include <stb_image.h>
 #include <glad/glad.h>
 
 namespace Mashenka
 {
+    // bytes per pixel of the internal formats we create
+    static uint32_t BytesPerPixel(GLenum internalFormat)
+    {
+        switch (internalFormat)
+        {
+        case GL_RGBA8: return 4;
+        case GL_RGB8: return 3;
+        default: break;
+        }
+
+        MK_CORE_ASSERT(false, "Unknown internal format!")
+        return 0;
+    }
+
+    // number of mips for a full chain down to 1x1
+    static uint32_t CalculateMipLevels(uint32_t width, uint32_t height)
+    {
+        uint32_t levels = 1;
+        uint32_t size = std::max(width, height);
+        while (size > 1)
+        {
+            size >>= 1;
+            levels++;
+        }
+        return levels;
+    }
+
     // Constructor
     OpenGLTexture2D::OpenGLTexture2D(uint32_t width, uint32_t height)
         : m_Width(width), m_Height(height)
@@ -27,6 +56,12 @@ namespace Mashenka
     // Constructor
     OpenGLTexture2D::OpenGLTexture2D(const std::string& path)
         : m_Path(path)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        LoadFromFile();
+    }
+
+    void OpenGLTexture2D::LoadFromFile()
     {
         MK_PROFILE_FUNCTION(); // Profiling
         // load the image
@@ -35,7 +70,7 @@ namespace Mashenka
         stbi_uc* data = nullptr;
         {
             // Explanation: https://www.khronos.org/opengl/wiki/Common_Mistakes#Creating_a_complete_texture
-            data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+            data = stbi_load(m_Path.c_str(), &width, &height, &channels, 0);
         }
         MK_CORE_ASSERT(data, "Failed to load image!")
 
@@ -63,27 +98,38 @@ namespace Mashenka
         // Explanation: https://www.khronos.org/opengl/wiki/Texture_Storage
         // Explanation: https://www.khronos.org/opengl/wiki/Common_Mistakes#Creating_a_complete_texture
 
+        // Release the old storage when reloading
+        if (m_RendererID)
+            glDeleteTextures(1, &m_RendererID);
+
         // Generate the texture, renderID is generated by OpenGL with glGenTextures
         glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
-        // Storage for the texture, we only need 1 level, so we use 1
-        glTextureStorage2D(m_RendererID, 1, internalFormat, m_Width, m_Height);
-
-        // Set the texture parameters, for min filter we use GL_LINEAR, for mag filter we use GL_NEAREST
-        // Explanation: https://www.khronos.org/opengl/wiki/Sampler_Object
-        glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-        // Set the texture parameters for wrap, we use GL_REPEAT
-        glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        
+        // Storage for the texture with the full mip chain, so the residency manager can drop the detailed mips
+        m_Levels = CalculateMipLevels(m_Width, m_Height);
+        m_ResidentMip = 0;
+        glTextureStorage2D(m_RendererID, m_Levels, internalFormat, m_Width, m_Height);
+        SetParameters(m_RendererID);
 
         // Set the texture parameters
         // SubImage2D: https://www.khronos.org/opengl/wiki/GLAPI/glTexSubImage2D
         glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, dataFormat, GL_UNSIGNED_BYTE, data);
+        glGenerateTextureMipmap(m_RendererID);
         stbi_image_free(data);
     }
 
+    void OpenGLTexture2D::SetParameters(uint32_t rendererID) const
+    {
+        // Set the texture parameters, for min filter we use GL_LINEAR_MIPMAP_LINEAR as file textures have mips,
+        // for mag filter we use GL_NEAREST
+        // Explanation: https://www.khronos.org/opengl/wiki/Sampler_Object
+        glTextureParameteri(rendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTextureParameteri(rendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        // Set the texture parameters for wrap, we use GL_REPEAT
+        glTextureParameteri(rendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTextureParameteri(rendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    }
+
     OpenGLTexture2D::~OpenGLTexture2D()
     {
         MK_PROFILE_FUNCTION(); // Profiling
@@ -104,8 +150,86 @@ namespace Mashenka
     void OpenGLTexture2D::Bind(uint32_t slot) const
     {
         MK_PROFILE_FUNCTION(); // Profiling
+        // let the residency manager know the texture is used, this reloads evicted textures
+        TextureResidency::OnBind(this);
+        RendererStats::AddTextureBind();
         glBindTextureUnit(slot, m_RendererID);
     }
 
+    /*
+     * ==============================RESIDENCY==============================
+     */
+    uint64_t OpenGLTexture2D::GetMemorySize() const
+    {
+        if (!IsResident())
+            return 0;
+
+        // Sum of all the resident mips, this is an estimate as drivers are free to pad the storage
+        uint64_t size = 0;
+        uint32_t bpp = BytesPerPixel(m_InternalFormat);
+        for (uint32_t level = m_ResidentMip; level < m_Levels; level++)
+        {
+            uint64_t width = std::max(1u, m_Width >> level);
+            uint64_t height = std::max(1u, m_Height >> level);
+            size += width * height * bpp;
+        }
+        return size;
+    }
+
+    void OpenGLTexture2D::SetResidentMip(uint32_t mip)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        MK_CORE_ASSERT(IsReloadable(), "Only textures loaded from a file can change their resident mips!");
+        mip = std::min(mip, m_Levels - 1);
+
+        // the detailed mips are gone, they can only come back from the file
+        if (!IsResident() || mip < m_ResidentMip)
+            LoadFromFile();
+
+        if (mip > m_ResidentMip)
+            DropMips(mip);
+    }
+
+    void OpenGLTexture2D::DropMips(uint32_t mip)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // Create a smaller storage and copy the remaining mips over, on the GPU, then release the old storage
+        uint32_t levels = m_Levels - mip;
+        uint32_t width = std::max(1u, m_Width >> mip);
+        uint32_t height = std::max(1u, m_Height >> mip);
+
+        uint32_t rendererID;
+        glCreateTextures(GL_TEXTURE_2D, 1, &rendererID);
+        glTextureStorage2D(rendererID, levels, m_InternalFormat, width, height);
+        SetParameters(rendererID);
+
+        // Explanation: https://www.khronos.org/opengl/wiki/GLAPI/glCopyImageSubData
+        for (uint32_t level = 0; level < levels; level++)
+        {
+            uint32_t sourceLevel = level + mip - m_ResidentMip;
+            glCopyImageSubData(m_RendererID, GL_TEXTURE_2D, sourceLevel, 0, 0, 0,
+                               rendererID, GL_TEXTURE_2D, level, 0, 0, 0,
+                               std::max(1u, width >> level), std::max(1u, height >> level), 1);
+        }
+
+        glDeleteTextures(1, &m_RendererID);
+        m_RendererID = rendererID;
+        m_ResidentMip = mip;
+    }
 
+    void OpenGLTexture2D::Evict()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        MK_CORE_ASSERT(IsReloadable(), "Only textures loaded from a file can be evicted!");
+        glDeleteTextures(1, &m_RendererID);
+        m_RendererID = 0;
+        m_ResidentMip = 0;
+    }
+
+    void OpenGLTexture2D::MakeResident()
+    {
+        if (IsResident() && m_ResidentMip == 0)
+            return;
+        LoadFromFile();
+    }
 }
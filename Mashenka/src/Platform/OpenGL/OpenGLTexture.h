@@ -23,11 +23,31 @@ namespace Mashenka
 
         virtual void Bind(uint32_t slot = 0) const override;
 
+        // Residency
+        virtual uint64_t GetMemorySize() const override;
+        virtual uint32_t GetMipLevelCount() const override { return m_Levels; }
+        virtual uint32_t GetResidentMip() const override { return m_ResidentMip; }
+        virtual bool IsResident() const override { return m_RendererID != 0; }
+        virtual bool IsReloadable() const override { return !m_Path.empty(); }
+
+        virtual void SetResidentMip(uint32_t mip) override;
+        virtual void Evict() override;
+        virtual void MakeResident() override;
+
+    private:
+        // (Re)load the image from m_Path with a full mip chain
+        void LoadFromFile();
+        // Move the texture into a smaller storage that starts at the given mip of the full resolution texture
+        void DropMips(uint32_t mip);
+        void SetParameters(uint32_t rendererID) const;
+
     private:
         std::string m_Path;
-        uint32_t m_Width, m_Height;
-        uint32_t m_RendererID; //generated by OpenGL with glGenTextures
+        uint32_t m_Width, m_Height; // size of the full resolution texture, even when mips are dropped
+        uint32_t m_RendererID = 0; //generated by OpenGL with glGenTextures, 0 when evicted
         GLenum m_InternalFormat, m_DataFormat; // internal format is the format that OpenGL uses to store the texture, data format is the format of the data that we pass to OpenGL
+        uint32_t m_Levels = 1; // mip levels of the full resolution texture
+        uint32_t m_ResidentMip = 0; // most detailed mip that is currently stored on the GPU
         
     };
 
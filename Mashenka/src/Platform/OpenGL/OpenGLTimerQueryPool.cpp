@@ -0,0 +1,62 @@
+﻿#include "mkpch.h"
+#include "Platform/OpenGL/OpenGLTimerQueryPool.h"
+#include <glad/glad.h>
+
+namespace Mashenka
+{
+    OpenGLTimerQueryPool::OpenGLTimerQueryPool(uint32_t capacity)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        m_Queries.resize(capacity);
+        glGenQueries(static_cast<GLsizei>(capacity), m_Queries.data());
+
+        // hand out the low indices first
+        m_FreeQueries.reserve(capacity);
+        for (uint32_t i = capacity; i > 0; i--)
+            m_FreeQueries.push_back(i - 1);
+    }
+
+    OpenGLTimerQueryPool::~OpenGLTimerQueryPool()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        glDeleteQueries(static_cast<GLsizei>(m_Queries.size()), m_Queries.data());
+    }
+
+    uint32_t OpenGLTimerQueryPool::WriteTimestamp()
+    {
+        if (m_FreeQueries.empty())
+            return InvalidQuery;
+
+        uint32_t query = m_FreeQueries.back();
+        m_FreeQueries.pop_back();
+        // Explanation: https://www.khronos.org/opengl/wiki/Query_Object#Timer_queries
+        glQueryCounter(m_Queries[query], GL_TIMESTAMP);
+        return query;
+    }
+
+    bool OpenGLTimerQueryPool::IsAvailable(uint32_t query) const
+    {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(m_Queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+        return available == GL_TRUE;
+    }
+
+    uint64_t OpenGLTimerQueryPool::GetTimestamp(uint32_t query) const
+    {
+        GLuint64 timestamp = 0;
+        glGetQueryObjectui64v(m_Queries[query], GL_QUERY_RESULT, &timestamp);
+        return timestamp;
+    }
+
+    void OpenGLTimerQueryPool::Release(uint32_t query)
+    {
+        m_FreeQueries.push_back(query);
+    }
+
+    uint64_t OpenGLTimerQueryPool::GetCurrentTimestamp() const
+    {
+        GLint64 timestamp = 0;
+        glGetInteger64v(GL_TIMESTAMP, &timestamp);
+        return static_cast<uint64_t>(timestamp);
+    }
+}
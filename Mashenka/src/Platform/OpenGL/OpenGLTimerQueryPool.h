@@ -0,0 +1,24 @@
+﻿#pragma once
+#include "Mashenka/Renderer/GPUTimerQueryPool.h"
+
+namespace Mashenka
+{
+    // GL_TIMESTAMP queries written with glQueryCounter, which unlike GL_TIME_ELAPSED can be nested
+    class OpenGLTimerQueryPool : public GPUTimerQueryPool
+    {
+    public:
+        OpenGLTimerQueryPool(uint32_t capacity);
+        ~OpenGLTimerQueryPool() override;
+
+        uint32_t WriteTimestamp() override;
+        bool IsAvailable(uint32_t query) const override;
+        uint64_t GetTimestamp(uint32_t query) const override;
+        void Release(uint32_t query) override;
+
+        uint64_t GetCurrentTimestamp() const override;
+
+    private:
+        std::vector<uint32_t> m_Queries; // GL names
+        std::vector<uint32_t> m_FreeQueries; // indices into m_Queries
+    };
+}
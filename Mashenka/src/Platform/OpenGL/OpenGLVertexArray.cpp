@@ -20,6 +20,7 @@ namespace Mashenka
         case ShaderDataType::Int3:
         case ShaderDataType::Int4: return GL_INT;
         case ShaderDataType::Bool: return GL_BOOL;
+        case ShaderDataType::UByte4: return GL_UNSIGNED_BYTE;
         case ShaderDataType::None: break;
         }
 
@@ -91,9 +92,13 @@ namespace Mashenka
                 // intptr_t is a signed integer type with the property that any valid pointer to void can be converted to this type, then converted back to pointer to void, and the result will compare equal to the original pointer.
                 // intptr_t is used to represent the difference between two pointers, thus the size of intptr_t is the same as the size of a pointer.
             );
+            // instanced attributes advance once per instance
+            glVertexAttribDivisor(index + m_VertexBufferIndex, layout.IsPerInstance() ? 1 : 0);
             index++;
         }
 
+        // the attributes of the next vertex buffer come after these
+        m_VertexBufferIndex += index;
         m_VertexBuffers.push_back(vertexBuffer);
     }
 }
@@ -0,0 +1,93 @@
+﻿#include "mkpch.h"
+
+#ifdef MK_PLATFORM_WINDOWS
+#include "Platform/Windows/WindowsFileWatcher.h"
+
+#include <filesystem>
+
+namespace Mashenka
+{
+    WindowsFileWatcher::WindowsFileWatcher(const std::string& directory)
+        : FileWatcher(directory)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // Overlapped, so the watcher thread can wait for a change and for the stop event at the same time
+        HANDLE directoryHandle = CreateFileA(directory.c_str(), FILE_LIST_DIRECTORY,
+                                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                             OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (directoryHandle == INVALID_HANDLE_VALUE)
+        {
+            MK_CORE_ERROR("Could not watch directory '{0}'", directory);
+            return;
+        }
+
+        m_DirectoryHandle = directoryHandle;
+        m_StopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        m_Thread = std::thread(&WindowsFileWatcher::Watch, this);
+    }
+
+    WindowsFileWatcher::~WindowsFileWatcher()
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        if (m_StopEvent)
+            SetEvent(m_StopEvent);
+        if (m_Thread.joinable())
+            m_Thread.join();
+        if (m_StopEvent)
+            CloseHandle(m_StopEvent);
+        if (m_DirectoryHandle)
+            CloseHandle(m_DirectoryHandle);
+    }
+
+    void WindowsFileWatcher::Watch()
+    {
+        // Explanation: https://learn.microsoft.com/en-us/windows/win32/api/winbase/nf-winbase-readdirectorychangesw
+        alignas(DWORD) char buffer[4096];
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+
+        while (true)
+        {
+            ResetEvent(overlapped.hEvent);
+            if (!ReadDirectoryChangesW(m_DirectoryHandle, buffer, sizeof(buffer), FALSE,
+                                       FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, nullptr,
+                                       &overlapped, nullptr))
+            {
+                MK_CORE_ERROR("Watching directory '{0}' failed", GetDirectory());
+                break;
+            }
+
+            DWORD bytes = 0;
+            HANDLE handles[2] = {overlapped.hEvent, m_StopEvent};
+            if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0)
+            {
+                // stopping, the pending read has to finish before the buffer goes away
+                CancelIo(m_DirectoryHandle);
+                GetOverlappedResult(m_DirectoryHandle, &overlapped, &bytes, TRUE);
+                break;
+            }
+
+            // 0 bytes means the buffer overflowed and the changes are lost, nothing to report
+            if (!GetOverlappedResult(m_DirectoryHandle, &overlapped, &bytes, FALSE) || bytes == 0)
+                continue;
+
+            auto* info = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(buffer);
+            while (true)
+            {
+                if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED ||
+                    info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+                {
+                    std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                    PushChange(GetDirectory() + "/" + std::filesystem::path(name).string());
+                }
+
+                if (info->NextEntryOffset == 0)
+                    break;
+                info = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(reinterpret_cast<char*>(info) + info->NextEntryOffset);
+            }
+        }
+
+        CloseHandle(overlapped.hEvent);
+    }
+}
+#endif
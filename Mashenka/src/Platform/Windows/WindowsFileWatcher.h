@@ -0,0 +1,23 @@
+﻿#pragma once
+#include "Mashenka/Core/FileWatcher.h"
+
+#include <thread>
+
+namespace Mashenka
+{
+    // ReadDirectoryChangesW implementation of the FileWatcher
+    class WindowsFileWatcher : public FileWatcher
+    {
+    public:
+        WindowsFileWatcher(const std::string& directory);
+        ~WindowsFileWatcher() override;
+
+    private:
+        void Watch();
+
+    private:
+        void* m_DirectoryHandle = nullptr; // HANDLE, Windows.h is only included by the pch
+        void* m_StopEvent = nullptr;
+        std::thread m_Thread;
+    };
+}
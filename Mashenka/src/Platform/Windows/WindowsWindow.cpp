@@ -54,6 +54,7 @@ namespace Mashenka
         }
         {
             MK_PROFILE_SCOPE("glfwCreateWindow"); // Profiling
+            glfwWindowHint(GLFW_VISIBLE, props.Visible ? GLFW_TRUE : GLFW_FALSE);
             m_Window = glfwCreateWindow((int)props.Width, (int)props.Height, m_Data.Title.c_str(), nullptr, nullptr); 
             s_GLFWWindowCount++; // Increase the window count
         }
@@ -94,6 +95,21 @@ namespace Mashenka
             data.EventCallback(event);
         });
 
+        glfwSetWindowFocusCallback(m_Window, [](GLFWwindow* window, int focused)
+        {
+            WindowData& data = *(WindowData*)glfwGetWindowUserPointer(window);
+            if (focused)
+            {
+                WindowFocusEvent event;
+                data.EventCallback(event);
+            }
+            else
+            {
+                WindowLostFocusEvent event;
+                data.EventCallback(event);
+            }
+        });
+
         glfwSetKeyCallback(m_Window, [](GLFWwindow* window, int key, int scancode, int action, int mods)
         {
             WindowData& data = *(WindowData*)glfwGetWindowUserPointer(window);
@@ -196,6 +212,13 @@ namespace Mashenka
         m_Context->SwapBuffers();
     }
 
+    void WindowsWindow::WaitEvents(float timeoutSeconds)
+    {
+        MK_PROFILE_FUNCTION(); // Profiling
+        // the thread sleeps in the OS until something happens to the window
+        glfwWaitEventsTimeout(timeoutSeconds);
+    }
+
     // Setup Vertical Sync for the GPU
     void WindowsWindow::SetVSync(bool enabled)
     {
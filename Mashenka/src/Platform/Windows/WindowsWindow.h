@@ -16,6 +16,7 @@ namespace Mashenka
         ~WindowsWindow() override;
 
         void OnUpdate() override;
+        void WaitEvents(float timeoutSeconds) override;
 
         inline unsigned int GetWidth() const override {return m_Data.Width;}
         inline unsigned int GetHeight() const override {return m_Data.Height;}
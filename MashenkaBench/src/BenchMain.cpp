@@ -0,0 +1,83 @@
+﻿// Engine: Mashenka Game Engine
+// MashenkaBench: micro benchmarks of the engine hot paths
+//   --filter <text>     only run benchmarks whose name contains text
+//   --json <file>       also write the results as JSON, for tracking them over time
+//   --samples <n>       measured samples per benchmark, 15
+//   --sample-time <s>   minimum length of one sample in seconds, 0.02
+// Build it in Release, the Debug numbers say little about the shipped engine. Run it from the Sandbox directory,
+// the shader benchmarks read assets/shaders
+#include "Benchmark.h"
+#include "Mashenka/Core/JobSystem.h"
+#include "Mashenka/Core/Log.h"
+
+#include <cstdlib>
+
+#ifdef MK_PLATFORM_WINDOWS
+#include <Windows.h>
+#endif
+
+using namespace Mashenka;
+
+// One core and a high priority, so the scheduler doesn't move or preempt the benchmark in the middle of a sample
+static void ReduceNoise()
+{
+#ifdef MK_PLATFORM_WINDOWS
+    SetThreadAffinityMask(GetCurrentThread(), 1);
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    Log::Init();
+
+    BenchmarkSuite suite;
+    std::string jsonPath;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string argument = argv[i];
+        const char* value = argv[i + 1];
+        if (argument == "--filter")
+            suite.SetFilter(value);
+        else if (argument == "--json")
+            jsonPath = value;
+        else if (argument == "--samples")
+            suite.SetSamples(static_cast<uint32_t>(std::max(1, std::atoi(value))));
+        else if (argument == "--sample-time")
+            suite.SetMinSampleTime(std::atof(value));
+        else
+        {
+            MK_ERROR("Unknown option: {0}", argument);
+            return 2;
+        }
+    }
+    if (argc % 2 == 0)
+    {
+        MK_ERROR("Missing value for {0}", argv[argc - 1]);
+        return 2;
+    }
+
+    // the worker threads the engine runs with, the JobSystem benchmarks and parallel layers use them
+    JobSystem::Init();
+
+    RegisterCoreBenchmarks(suite);
+    RegisterInstrumentorBenchmarks(suite);
+    RegisterJobSystemBenchmarks(suite);
+    RegisterQuadKernelBenchmarks(suite);
+    RegisterShaderBenchmarks(suite);
+
+    ReduceNoise();
+    std::vector<BenchmarkResult> results = suite.Run();
+    JobSystem::Shutdown();
+
+    if (!jsonPath.empty())
+    {
+        if (!BenchmarkSuite::WriteJSON(jsonPath, results))
+        {
+            MK_ERROR("Could not write '{0}'", jsonPath);
+            return 1;
+        }
+        MK_INFO("Wrote '{0}'", jsonPath);
+    }
+    return 0;
+}
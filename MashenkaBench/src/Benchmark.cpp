@@ -0,0 +1,118 @@
+﻿// Engine: Mashenka Game Engine
+// MashenkaBench: calibration, sampling and the JSON report
+#include "Benchmark.h"
+#include "Mashenka/Core/Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+static double Median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : 0.5 * (values[middle - 1] + values[middle]);
+}
+
+// seconds
+static double TimeRun(const BenchmarkFunction& function, uint64_t iterations)
+{
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    function(iterations);
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void BenchmarkSuite::Add(const std::string& name, BenchmarkFunction function, uint64_t itemsPerIteration)
+{
+    m_Benchmarks.push_back({name, std::move(function), itemsPerIteration, nullptr, nullptr});
+}
+
+void BenchmarkSuite::Add(const std::string& name, BenchmarkFunction function, BenchmarkHook setup,
+                         BenchmarkHook teardown, uint64_t itemsPerIteration)
+{
+    m_Benchmarks.push_back({name, std::move(function), itemsPerIteration, std::move(setup), std::move(teardown)});
+}
+
+BenchmarkResult BenchmarkSuite::Measure(const Entry& entry) const
+{
+    // grow the iteration count until a sample is long enough, aim a bit over so the samples don't fall short
+    uint64_t iterations = 1;
+    while (true)
+    {
+        double seconds = TimeRun(entry.Function, iterations);
+        if (seconds >= m_MinSampleTime)
+            break;
+        double scale = seconds > 0.0 ? 1.2 * m_MinSampleTime / seconds : 10.0;
+        iterations = std::max(iterations + 1, static_cast<uint64_t>(iterations * std::min(scale, 10.0)));
+    }
+
+    TimeRun(entry.Function, iterations); // warm up
+    std::vector<double> samples;
+    samples.reserve(m_Samples);
+    for (uint32_t i = 0; i < m_Samples; i++)
+        samples.push_back(TimeRun(entry.Function, iterations) * 1e9 / iterations);
+
+    BenchmarkResult result;
+    result.Name = entry.Name;
+    result.ItemsPerIteration = entry.ItemsPerIteration;
+    result.Iterations = iterations;
+    result.Samples = m_Samples;
+    result.Median = Median(samples);
+    result.Min = *std::min_element(samples.begin(), samples.end());
+
+    std::vector<double> deviations;
+    deviations.reserve(samples.size());
+    for (double sample : samples)
+        deviations.push_back(std::abs(sample - result.Median));
+    result.Deviation = result.Median > 0.0 ? Median(deviations) / result.Median : 0.0;
+    return result;
+}
+
+std::vector<BenchmarkResult> BenchmarkSuite::Run() const
+{
+    std::vector<BenchmarkResult> results;
+    MK_INFO("{0:<40} {1:>12} {2:>12} {3:>7} {4:>14}", "benchmark", "median", "min", "+/-", "items/s");
+    for (const auto& entry : m_Benchmarks)
+    {
+        if (!m_Filter.empty() && entry.Name.find(m_Filter) == std::string::npos)
+            continue;
+
+        if (entry.Setup)
+            entry.Setup();
+        BenchmarkResult result = Measure(entry);
+        if (entry.Teardown)
+            entry.Teardown();
+        double itemsPerSecond = result.ItemsPerIteration * 1e9 / result.Median;
+        MK_INFO("{0:<40} {1:>9.2f} ns {2:>9.2f} ns {3:>6.1f}% {4:>14.4g}", result.Name, result.Median, result.Min,
+                result.Deviation * 100.0, itemsPerSecond);
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+bool BenchmarkSuite::WriteJSON(const std::string& path, const std::vector<BenchmarkResult>& results)
+{
+    std::ofstream file(path);
+    if (!file)
+        return false;
+
+    file << "{\n    \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results[i];
+        char line[512];
+        std::snprintf(line, sizeof(line),
+                      "        {\"name\": \"%s\", \"median_ns\": %.3f, \"min_ns\": %.3f, \"deviation\": %.4f, "
+                      "\"items_per_second\": %.1f, \"iterations\": %llu, \"samples\": %u}%s\n",
+                      result.Name.c_str(), result.Median, result.Min, result.Deviation,
+                      result.ItemsPerIteration * 1e9 / result.Median,
+                      static_cast<unsigned long long>(result.Iterations), result.Samples,
+                      i + 1 < results.size() ? "," : "");
+        file << line;
+    }
+    file << "    ]\n}\n";
+    return static_cast<bool>(file);
+}
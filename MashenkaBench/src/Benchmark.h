@@ -0,0 +1,87 @@
+﻿#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Keeps the compiler from removing work whose result is never used
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    static const volatile void* s_Sink;
+    s_Sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Runs the measured work iterations times, the suite picks the count
+using BenchmarkFunction = std::function<void(uint64_t iterations)>;
+// Untimed work around all the samples of one benchmark, e.g. opening a file once
+using BenchmarkHook = std::function<void()>;
+
+struct BenchmarkResult
+{
+    std::string Name;
+    uint64_t ItemsPerIteration = 1;
+    uint64_t Iterations = 0; // per sample
+    uint32_t Samples = 0;
+    double Median = 0.0; // nanoseconds per iteration
+    double Min = 0.0;
+    double Deviation = 0.0; // median absolute deviation of the samples, relative to the median
+};
+
+/*
+ * BenchmarkSuite Class
+ * Every benchmark first gets an iteration count that makes one sample last long enough for the clock,
+ * then runs one warm up sample and the measured samples. The median is reported, it ignores the odd sample
+ * that was interrupted by the OS, the deviation tells how much a number can be trusted
+ */
+class BenchmarkSuite
+{
+public:
+    // items per iteration turn the time into a throughput, e.g. quads per batch
+    void Add(const std::string& name, BenchmarkFunction function, uint64_t itemsPerIteration = 1);
+    // setup runs before the calibration, teardown after the last sample
+    void Add(const std::string& name, BenchmarkFunction function, BenchmarkHook setup, BenchmarkHook teardown,
+             uint64_t itemsPerIteration = 1);
+
+    // only benchmarks whose name contains the filter run
+    void SetFilter(const std::string& filter) { m_Filter = filter; }
+    void SetSamples(uint32_t samples) { m_Samples = samples; }
+    void SetMinSampleTime(double seconds) { m_MinSampleTime = seconds; }
+
+    std::vector<BenchmarkResult> Run() const;
+
+    static bool WriteJSON(const std::string& path, const std::vector<BenchmarkResult>& results);
+
+private:
+    struct Entry
+    {
+        std::string Name;
+        BenchmarkFunction Function;
+        uint64_t ItemsPerIteration;
+        BenchmarkHook Setup, Teardown;
+    };
+
+    BenchmarkResult Measure(const Entry& entry) const;
+
+private:
+    std::vector<Entry> m_Benchmarks;
+    std::string m_Filter;
+    uint32_t m_Samples = 15;
+    double m_MinSampleTime = 0.02;
+};
+
+// One function per file, called by main
+void RegisterCoreBenchmarks(BenchmarkSuite& suite);
+void RegisterInstrumentorBenchmarks(BenchmarkSuite& suite);
+void RegisterJobSystemBenchmarks(BenchmarkSuite& suite);
+void RegisterQuadKernelBenchmarks(BenchmarkSuite& suite);
+void RegisterShaderBenchmarks(BenchmarkSuite& suite);
@@ -0,0 +1,210 @@
+﻿// Engine: Mashenka Game Engine
+// MashenkaBench: buffer layouts, event dispatch and layer updates, the per frame and per event plumbing
+#include "mkpch.h"
+#include "Benchmark.h"
+#include "Mashenka/Core/LayerStack.h"
+#include "Mashenka/Events/ApplicationEvent.h"
+#include "Mashenka/Events/MouseEvent.h"
+#include "Mashenka/Renderer/Buffer.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+
+using namespace Mashenka;
+
+// Counts its updates, so the virtual call has something to do
+class CountingLayer : public Layer
+{
+public:
+    CountingLayer() : Layer("CountingLayer") {}
+
+    void OnUpdate(TimeStep ts) override
+    {
+        m_Updates++;
+        m_Time += ts;
+    }
+
+    uint64_t GetUpdates() const { return m_Updates; }
+
+private:
+    uint64_t m_Updates = 0;
+    float m_Time = 0.0f;
+};
+
+// A piece of state shared by the parallel layers, with what is needed to catch an update graph that is wrong
+struct SharedState
+{
+    std::atomic<int32_t> Users{0}; // readers at the moment, -1 while a layer writes it
+    std::atomic<uint64_t> Writes{0}; // updates that wrote it so far
+    uint32_t WritersPerFrame = 0;
+};
+using SharedStates = std::map<std::string, SharedState>;
+
+// A parallel layer that spends some time on its declared state. It counts the frames where a conflicting layer
+// ran at the same time, or where a layer before it in the stack had not written the state yet
+class AccessLayer : public Layer
+{
+public:
+    AccessLayer(const std::string& name, const LayerAccess& access, SharedStates& states)
+        : Layer(name), m_States(states)
+    {
+        SetParallelUpdate(access);
+        // the writers before this layer in the stack, they run first every frame
+        for (const std::string& state : GetStates())
+            m_WritersBefore[state] = m_States[state].WritersPerFrame;
+        for (const std::string& state : access.Writes)
+            m_States[state].WritersPerFrame++;
+    }
+
+    void OnUpdate(TimeStep ts) override
+    {
+        for (const std::string& state : GetStates())
+        {
+            SharedState& shared = m_States.at(state);
+            if (shared.Writes.load() != m_Frame * shared.WritersPerFrame + m_WritersBefore[state])
+                m_Errors++;
+        }
+        for (const std::string& state : GetAccess().Reads)
+        {
+            int32_t users = m_States.at(state).Users.load();
+            do
+            {
+                if (users < 0)
+                {
+                    m_Errors++;
+                    users = 0;
+                }
+            } while (!m_States.at(state).Users.compare_exchange_weak(users, users + 1));
+        }
+        for (const std::string& state : GetAccess().Writes)
+        {
+            if (m_States.at(state).Users.exchange(-1) != 0)
+                m_Errors++;
+        }
+
+        // the update itself
+        for (uint32_t i = 0; i < 2048; i++)
+            m_Value = m_Value * 1664525u + 1013904223u + static_cast<uint32_t>(ts.GetSeconds());
+
+        for (const std::string& state : GetAccess().Writes)
+        {
+            m_States.at(state).Users.store(0);
+            m_States.at(state).Writes++;
+        }
+        for (const std::string& state : GetAccess().Reads)
+            m_States.at(state).Users--;
+        m_Frame++;
+    }
+
+    uint32_t GetErrors() const { return m_Errors; }
+    uint32_t GetValue() const { return m_Value; }
+
+private:
+    std::vector<std::string> GetStates() const
+    {
+        std::vector<std::string> states = GetAccess().Reads;
+        states.insert(states.end(), GetAccess().Writes.begin(), GetAccess().Writes.end());
+        return states;
+    }
+
+private:
+    SharedStates& m_States;
+    std::map<std::string, uint32_t> m_WritersBefore;
+    uint64_t m_Frame = 0;
+    uint32_t m_Errors = 0, m_Value = 1;
+};
+
+void RegisterCoreBenchmarks(BenchmarkSuite& suite)
+{
+    // the quad layout of Renderer2D, built for every vertex array
+    suite.Add("BufferLayout/QuadVertex", [](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            BufferLayout layout = {
+                {ShaderDataType::Float3, "a_Position"},
+                {ShaderDataType::Float4, "a_Color"},
+                {ShaderDataType::Float2, "a_TexCoord"},
+                {ShaderDataType::Float, "a_TexIndex"},
+                {ShaderDataType::Float, "a_TilingFactor"}
+            };
+            DoNotOptimize(layout.GetStride());
+        }
+    });
+
+    // Application::OnEvent tries every handler, most of them don't match
+    suite.Add("EventDispatcher/Match", [](uint64_t iterations)
+    {
+        WindowResizeEvent event(1280, 720);
+        uint64_t handled = 0;
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            EventDispatcher dispatcher(event);
+            dispatcher.Dispatch<WindowResizeEvent>([&](WindowResizeEvent& e)
+            {
+                handled += e.GetWidth();
+                return false;
+            });
+            DoNotOptimize(handled);
+        }
+    });
+
+    suite.Add("EventDispatcher/Miss", [](uint64_t iterations)
+    {
+        MouseMovedEvent event(100.0f, 200.0f);
+        uint64_t handled = 0;
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            EventDispatcher dispatcher(event);
+            dispatcher.Dispatch<WindowResizeEvent>([&](WindowResizeEvent& e)
+            {
+                handled += e.GetWidth();
+                return false;
+            });
+            DoNotOptimize(handled);
+        }
+    });
+
+    // one Application::Run frame worth of OnUpdate calls, per layer
+    const uint32_t layerCount = 16;
+    auto layerStack = std::make_shared<LayerStack>();
+    for (uint32_t i = 0; i < layerCount; i++)
+        layerStack->PushLayer(new CountingLayer());
+
+    suite.Add("LayerStack/OnUpdate", [layerStack](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; i++)
+            layerStack->Update(1.0f / 60.0f);
+        DoNotOptimize(static_cast<CountingLayer*>(*layerStack->begin())->GetUpdates());
+    }, layerCount);
+
+    // a frame of game systems as parallel layers, the update graph keeps the conflicting ones apart
+    auto states = std::make_shared<SharedStates>();
+    auto parallelStack = std::make_shared<LayerStack>();
+    const std::vector<std::pair<std::string, LayerAccess>> systems = {
+        {"Input", {{}, {"Input"}}},
+        {"Physics", {{"Input"}, {"World"}}},
+        {"Audio", {{}, {"Audio"}}},
+        {"AI", {{"World"}, {"Agents"}}},
+        {"Particles", {{"World"}, {"Particles"}}},
+        {"Animation", {{"Agents"}, {"World"}}},
+        {"Streaming", {{}, {"Assets"}}},
+        {"Camera", {{"World", "Input"}, {}}}
+    };
+    for (const auto& [name, access] : systems)
+        parallelStack->PushLayer(new AccessLayer(name, access, *states));
+
+    suite.Add("LayerStack/ParallelUpdate", [parallelStack, states](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; i++)
+            parallelStack->Update(1.0f / 60.0f);
+
+        uint32_t errors = 0;
+        for (Layer* layer : *parallelStack)
+            errors += static_cast<AccessLayer*>(layer)->GetErrors();
+        if (errors)
+            MK_ERROR("LayerStack/ParallelUpdate: {0} updates overlapped a conflicting one or ran out of order", errors);
+        DoNotOptimize(static_cast<AccessLayer*>(*parallelStack->begin())->GetValue());
+    }, systems.size());
+}
@@ -0,0 +1,46 @@
+﻿// Engine: Mashenka Game Engine
+// MashenkaBench: what one MK_PROFILE_SCOPE costs, with and without a profiling session
+#include "Benchmark.h"
+#include "Mashenka/Core/Log.h"
+#include "Mashenka/Debug/Instrumentor.h"
+
+#include <filesystem>
+
+using namespace Mashenka;
+
+void RegisterInstrumentorBenchmarks(BenchmarkSuite& suite)
+{
+    // the floor, a scope reads the clock twice
+    suite.Add("Instrumentor/steady_clock::now", [](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; i++)
+            DoNotOptimize(std::chrono::steady_clock::now());
+    });
+
+    // the engine always has scopes in its functions, this is their cost outside of a session
+    suite.Add("Instrumentor/Scope", [](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            InstrumentorTimer timer("Bench");
+        }
+    });
+
+    // while a session records, every scope becomes a line in the trace file
+    // the session is opened once around all the samples, opening and flushing the file is not part of a scope
+    const std::string path = (std::filesystem::temp_directory_path() / "MashenkaBench-profile.json").string();
+    suite.Add("Instrumentor/Scope in session", [](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            InstrumentorTimer timer("Bench");
+        }
+    },
+    [path]() { Instrumentor::Get().BeginSession("Bench", path); },
+    [path]()
+    {
+        Instrumentor::Get().EndSession();
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    });
+}
@@ -0,0 +1,98 @@
+﻿// Engine: Mashenka Game Engine
+// MashenkaBench: the JobSystem overhead of splitting work, chaining groups, waiting from a job and stealing
+#include "mkpch.h"
+#include "Benchmark.h"
+#include "Mashenka/Core/JobSystem.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace Mashenka;
+
+// Little work per job, so the numbers are mostly the cost of the JobSystem itself
+static constexpr uint32_t s_JobCount = 256;
+
+void RegisterJobSystemBenchmarks(BenchmarkSuite& suite)
+{
+    // a Renderer2D sized loop split into ranges, the caller takes the first one
+    const uint32_t elementCount = 64 * 1024;
+    auto values = std::make_shared<std::vector<uint32_t>>(elementCount);
+    suite.Add("JobSystem/ParallelFor", [values](uint64_t iterations)
+    {
+        std::vector<uint32_t>& data = *values;
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            JobSystem::ParallelFor(static_cast<uint32_t>(data.size()), 1024, [&data, i](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t element = begin; element < end; element++)
+                    data[element] = element * static_cast<uint32_t>(i);
+            });
+            DoNotOptimize(data.back());
+        }
+    }, elementCount);
+
+    // one group fans out into a second one that only starts once the first is done
+    suite.Add("JobSystem/RunAfter", [](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            std::atomic<uint32_t> first{0}, second{0};
+            JobCounter firstJobs, secondJobs;
+            for (uint32_t job = 0; job < s_JobCount / 2; job++)
+                JobSystem::Run([&first]() { first.fetch_add(1, std::memory_order_relaxed); }, &firstJobs);
+            for (uint32_t job = 0; job < s_JobCount / 2; job++)
+            {
+                JobSystem::RunAfter(firstJobs, [&first, &second]()
+                {
+                    // the dependency finished, every job of the first group counted
+                    second.fetch_add(first.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }, &secondJobs);
+            }
+            JobSystem::Wait(secondJobs);
+            if (second.load() != (s_JobCount / 2) * (s_JobCount / 2))
+                MK_ERROR("JobSystem/RunAfter: a continuation ran before its dependency finished");
+        }
+    }, s_JobCount);
+
+    // jobs that wait for their own ParallelFor, the waiting threads run the ranges of the others
+    suite.Add("JobSystem/NestedWait", [](uint64_t iterations)
+    {
+        const uint32_t outerJobs = 16, innerRanges = s_JobCount / outerJobs;
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            std::atomic<uint32_t> ranges{0};
+            JobCounter outer;
+            for (uint32_t job = 0; job < outerJobs; job++)
+            {
+                JobSystem::Run([&ranges, innerRanges]()
+                {
+                    JobSystem::ParallelFor(innerRanges, 1, [&ranges](uint32_t begin, uint32_t end)
+                    {
+                        ranges.fetch_add(end - begin, std::memory_order_relaxed);
+                    });
+                }, &outer);
+            }
+            JobSystem::Wait(outer);
+            if (ranges.load() != outerJobs * innerRanges)
+                MK_ERROR("JobSystem/NestedWait: a nested ParallelFor returned before its ranges ran");
+        }
+    }, s_JobCount);
+
+    // one worker queues every job on its own deque, the other threads only get work by stealing from it
+    suite.Add("JobSystem/Steal", [](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            std::atomic<uint32_t> done{0};
+            JobCounter jobs;
+            JobSystem::Run([&done, &jobs]()
+            {
+                for (uint32_t job = 0; job < s_JobCount; job++)
+                    JobSystem::Run([&done]() { done.fetch_add(1, std::memory_order_relaxed); }, &jobs);
+            }, &jobs);
+            JobSystem::Wait(jobs);
+            if (done.load() != s_JobCount)
+                MK_ERROR("JobSystem/Steal: {0} of {1} jobs ran", done.load(), s_JobCount);
+        }
+    }, s_JobCount);
+}
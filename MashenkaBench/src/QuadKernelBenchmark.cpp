@@ -0,0 +1,124 @@
+﻿// Engine: Mashenka Game Engine
+// MashenkaBench: quads/second of the Renderer2D vertex generation
+#include "Benchmark.h"
+#include "Mashenka/Core/Log.h"
+#include "Mashenka/Renderer/QuadKernel.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <vector>
+
+using namespace Mashenka;
+
+// One Renderer2D batch worth of quads, small enough to stay in the cache like the real batch does
+static constexpr uint32_t s_QuadCount = 10000;
+
+struct QuadData
+{
+    std::vector<float> PositionX, PositionY, PositionZ, SizeX, SizeY, Rotation, TexIndex, TilingFactor;
+    std::vector<glm::vec4> Color;
+
+    QuadKernelInput GetInput() const
+    {
+        QuadKernelInput input;
+        input.PositionX = PositionX.data();
+        input.PositionY = PositionY.data();
+        input.PositionZ = PositionZ.data();
+        input.SizeX = SizeX.data();
+        input.SizeY = SizeY.data();
+        input.Rotation = Rotation.data();
+        input.Color = Color.data();
+        input.TexIndex = TexIndex.data();
+        input.TilingFactor = TilingFactor.data();
+        return input;
+    }
+};
+
+static QuadData GenerateQuads(uint32_t count)
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f), size(0.1f, 4.0f), rotation(-3.14f, 3.14f);
+
+    QuadData quads;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        quads.PositionX.push_back(position(random));
+        quads.PositionY.push_back(position(random));
+        quads.PositionZ.push_back(0.0f);
+        quads.SizeX.push_back(size(random));
+        quads.SizeY.push_back(size(random));
+        quads.Rotation.push_back(rotation(random));
+        quads.Color.emplace_back(1.0f, 0.5f, 0.25f, 1.0f);
+        quads.TexIndex.push_back(static_cast<float>(i % 16));
+        quads.TilingFactor.push_back(1.0f);
+    }
+    return quads;
+}
+
+// What Renderer2D::DrawRotatedQuad did before the kernel: translate * rotate * scale, then 4 corners
+static void TransformMatrices(const QuadData& quads, QuadVertex* output)
+{
+    static const glm::vec4 corners[4] = {
+        {-0.5f, -0.5f, 0.0f, 1.0f}, {0.5f, -0.5f, 0.0f, 1.0f}, {0.5f, 0.5f, 0.0f, 1.0f}, {-0.5f, 0.5f, 0.0f, 1.0f}
+    };
+    static const glm::vec2 texCoords[4] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+
+    for (uint32_t i = 0; i < s_QuadCount; i++)
+    {
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), {quads.PositionX[i], quads.PositionY[i], quads.PositionZ[i]})
+            * glm::rotate(glm::mat4(1.0f), quads.Rotation[i], {0.0f, 0.0f, 1.0f})
+            * glm::scale(glm::mat4(1.0f), {quads.SizeX[i], quads.SizeY[i], 1.0f});
+        for (uint32_t corner = 0; corner < 4; corner++)
+        {
+            QuadVertex& vertex = output[i * 4 + corner];
+            vertex.Position = glm::vec3(transform * corners[corner]);
+            vertex.Color = quads.Color[i];
+            vertex.TexCoord = texCoords[corner];
+            vertex.TexIndex = quads.TexIndex[i];
+            vertex.TilingFactor = quads.TilingFactor[i];
+        }
+    }
+}
+
+// Shared by the benchmarks, generated once
+struct QuadBenchmarkData
+{
+    QuadData Quads = GenerateQuads(s_QuadCount);
+    QuadKernelInput Input = Quads.GetInput();
+    std::vector<QuadVertex> Vertices = std::vector<QuadVertex>(s_QuadCount * 4);
+};
+
+void RegisterQuadKernelBenchmarks(BenchmarkSuite& suite)
+{
+    auto data = std::make_shared<QuadBenchmarkData>();
+
+    suite.Add("QuadKernel/glm::mat4", [data](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            TransformMatrices(data->Quads, data->Vertices.data());
+            DoNotOptimize(data->Vertices[0]);
+        }
+    }, s_QuadCount);
+
+    for (auto implementation : {QuadKernel::Implementation::Scalar, QuadKernel::Implementation::SSE2,
+                                QuadKernel::Implementation::AVX2})
+    {
+        const char* name = QuadKernel::GetImplementationName(implementation);
+        if (!QuadKernel::IsSupported(implementation))
+        {
+            MK_INFO("QuadKernel/{0} is not supported by this CPU", name);
+            continue;
+        }
+
+        suite.Add(std::string("QuadKernel/") + name, [data, implementation](uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; i++)
+            {
+                QuadKernel::Transform(implementation, data->Input, s_QuadCount, data->Vertices.data());
+                DoNotOptimize(data->Vertices[0]);
+            }
+        }, s_QuadCount);
+    }
+    MK_INFO("Renderer2D uses {0}", QuadKernel::GetImplementationName(QuadKernel::GetImplementation()));
+}
@@ -0,0 +1,41 @@
+﻿// Engine: Mashenka Game Engine
+// MashenkaBench: splitting a shader file into stages and variants, done for every load and hot reload
+#include "Benchmark.h"
+#include "Mashenka/Core/Log.h"
+#include "Platform/OpenGL/OpenGLShader.h"
+
+#include <fstream>
+#include <iterator>
+
+using namespace Mashenka;
+
+// The shader the renderer loads, relative to the Sandbox directory like every asset
+static const char* s_QuadShaderPath = "assets/shaders/Renderer2D_Quad.glsl";
+
+static bool ReadFile(const std::string& filepath, std::string& contents)
+{
+    std::ifstream in(filepath, std::ios::in | std::ios::binary);
+    if (!in)
+        return false;
+    contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+void RegisterShaderBenchmarks(BenchmarkSuite& suite)
+{
+    std::string source;
+    if (!ReadFile(s_QuadShaderPath, source))
+    {
+        MK_ERROR("Could not open '{0}', run MashenkaBench from the Sandbox directory", s_QuadShaderPath);
+        return;
+    }
+
+    suite.Add("OpenGLShader::PreProcess/Renderer2D_Quad", [source](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            OpenGLShaderSource result = OpenGLShader::PreProcess(source);
+            DoNotOptimize(result.Stages.size());
+        }
+    });
+}
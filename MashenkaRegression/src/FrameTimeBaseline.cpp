@@ -0,0 +1,107 @@
+﻿// Engine: Mashenka Game Engine
+// MashenkaRegression: the JSON baseline the frame time percentiles are compared against
+#include "FrameTimeBaseline.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+// The text between the first two quotes of the line
+static bool ReadQuoted(const std::string& line, size_t from, std::string& text, size_t& end)
+{
+    size_t begin = line.find('"', from);
+    if (begin == std::string::npos)
+        return false;
+    end = line.find('"', begin + 1);
+    if (end == std::string::npos)
+        return false;
+    text = line.substr(begin + 1, end - begin - 1);
+    return true;
+}
+
+// The number after "name": in the object, whitespace around the colon and the number is fine
+static bool ReadField(const std::string& object, const char* name, double& value)
+{
+    size_t key = object.find(std::string("\"") + name + "\"");
+    if (key == std::string::npos)
+        return false;
+    size_t colon = object.find_first_not_of(" \t", key + std::strlen(name) + 2);
+    if (colon == std::string::npos || object[colon] != ':')
+        return false;
+
+    const char* begin = object.c_str() + colon + 1;
+    char* end = nullptr;
+    value = std::strtod(begin, &end); // skips the leading whitespace
+    return end != begin;
+}
+
+bool ReadBaseline(const std::string& path, FrameTimeBaseline& baseline, std::string& error)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        error = "could not open '" + path + "'";
+        return false;
+    }
+
+    std::string line;
+    for (uint32_t lineNumber = 1; std::getline(file, line); lineNumber++)
+    {
+        std::string key;
+        size_t end;
+        if (!ReadQuoted(line, 0, key, end))
+            continue;
+
+        if (key == "renderer")
+        {
+            ReadQuoted(line, end + 1, baseline.Renderer, end);
+            continue;
+        }
+
+        // "Scene": {"frames": 200, "mean": 1.0, "p50": 1.0, "p95": 1.0, "p99": 1.0},
+        size_t object = line.find('{', end);
+        if (key == "scenes" || object == std::string::npos)
+            continue;
+
+        // a scene that is silently skipped would lose its performance check, so anything unexpected is an error
+        std::string fields = line.substr(object);
+        FrameTimeSummary summary;
+        double frames = 0.0;
+        if (!ReadField(fields, "frames", frames) || !ReadField(fields, "mean", summary.Mean) ||
+            !ReadField(fields, "p50", summary.P50) || !ReadField(fields, "p95", summary.P95) ||
+            !ReadField(fields, "p99", summary.P99))
+        {
+            error = path + ":" + std::to_string(lineNumber) + ": can't read the frame times of '" + key +
+                "', expected frames, mean, p50, p95 and p99 on one line";
+            return false;
+        }
+        summary.Count = static_cast<uint32_t>(frames);
+        baseline.Scenes[key] = summary;
+    }
+    return true;
+}
+
+bool WriteBaseline(const std::string& path, const FrameTimeBaseline& baseline)
+{
+    std::ofstream file(path);
+    if (!file)
+        return false;
+
+    file << "{\n";
+    file << "    \"renderer\": \"" << baseline.Renderer << "\",\n";
+    file << "    \"scenes\": {\n";
+    size_t index = 0;
+    for (const auto& [name, summary] : baseline.Scenes)
+    {
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "        \"%s\": {\"frames\": %u, \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f}%s\n",
+                      name.c_str(), summary.Count, summary.Mean, summary.P50, summary.P95, summary.P99,
+                      ++index < baseline.Scenes.size() ? "," : "");
+        file << line;
+    }
+    file << "    }\n";
+    file << "}\n";
+    return static_cast<bool>(file);
+}
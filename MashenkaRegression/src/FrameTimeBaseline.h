@@ -0,0 +1,23 @@
+﻿#pragma once
+#include "Mashenka/Renderer/SampleSummary.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// CPU frame time percentiles of one scene, in milliseconds, made by Mashenka::Summarize
+using FrameTimeSummary = Mashenka::SampleSummary<double>;
+
+// The frame times of a previous run, by scene name
+// Timings are only comparable on the same machine and driver, so the GL renderer is stored next to them
+struct FrameTimeBaseline
+{
+    std::string Renderer;
+    std::map<std::string, FrameTimeSummary> Scenes;
+};
+
+// A small JSON file, one scene per line. The reader takes any spacing, but every scene object on one line
+// Returns false with the reason in error when the file is missing or a scene line can't be read
+bool ReadBaseline(const std::string& path, FrameTimeBaseline& baseline, std::string& error);
+bool WriteBaseline(const std::string& path, const FrameTimeBaseline& baseline);
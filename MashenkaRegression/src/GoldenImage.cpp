@@ -0,0 +1,107 @@
+﻿// Engine: Mashenka Game Engine
+// MashenkaRegression: golden image files and the comparison against them
+#include "GoldenImage.h"
+
+#include <stb_image/stb_image.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+bool ReadTGA(const std::string& path, Image& image)
+{
+    // bottom row first, like the readback
+    stbi_set_flip_vertically_on_load(1);
+    int width, height, channels;
+    stbi_uc* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+    if (!data)
+        return false;
+
+    image.Width = static_cast<uint32_t>(width);
+    image.Height = static_cast<uint32_t>(height);
+    image.Pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(data);
+
+    // stb_image gives RGBA
+    for (size_t i = 0; i < image.Pixels.size(); i += 4)
+        std::swap(image.Pixels[i], image.Pixels[i + 2]);
+    return true;
+}
+
+bool WriteTGA(const std::string& path, const Image& image)
+{
+    const uint8_t header[18] = {
+        0, // no image id
+        0, // no color map
+        2, // uncompressed true color
+        0, 0, 0, 0, 0, // color map specification
+        0, 0, 0, 0, // origin
+        static_cast<uint8_t>(image.Width & 0xFF), static_cast<uint8_t>(image.Width >> 8),
+        static_cast<uint8_t>(image.Height & 0xFF), static_cast<uint8_t>(image.Height >> 8),
+        24, // bits per pixel
+        0 // bottom left origin
+    };
+
+    std::vector<uint8_t> data(header, header + sizeof(header));
+    data.reserve(sizeof(header) + static_cast<size_t>(image.Width) * image.Height * 3);
+    for (size_t i = 0; i < image.Pixels.size(); i += 4)
+        data.insert(data.end(), image.Pixels.begin() + i, image.Pixels.begin() + i + 3);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+ImageDifference CompareImages(const Image& actual, const Image& expected, uint32_t tolerance, Image* difference)
+{
+    ImageDifference result;
+    const size_t pixelCount = static_cast<size_t>(expected.Width) * expected.Height;
+    if (actual.Width != expected.Width || actual.Height != expected.Height)
+    {
+        result.DifferentPixels = static_cast<uint32_t>(pixelCount);
+        result.MaxChannelDifference = 255;
+        result.DifferentFraction = 1.0f;
+        return result;
+    }
+
+    if (difference)
+    {
+        difference->Width = expected.Width;
+        difference->Height = expected.Height;
+        difference->Pixels.resize(pixelCount * 4);
+    }
+
+    for (size_t i = 0; i < pixelCount * 4; i += 4)
+    {
+        uint32_t maxDifference = 0;
+        for (size_t channel = 0; channel < 3; channel++)
+        {
+            int channelDifference = std::abs(actual.Pixels[i + channel] - expected.Pixels[i + channel]);
+            maxDifference = std::max(maxDifference, static_cast<uint32_t>(channelDifference));
+        }
+        result.MaxChannelDifference = std::max(result.MaxChannelDifference, maxDifference);
+
+        bool different = maxDifference > tolerance;
+        if (different)
+            result.DifferentPixels++;
+
+        if (difference)
+        {
+            uint8_t* pixel = &difference->Pixels[i];
+            for (size_t channel = 0; channel < 3; channel++)
+                pixel[channel] = static_cast<uint8_t>(expected.Pixels[i + channel] / 4);
+            if (different)
+            {
+                pixel[0] = 0;
+                pixel[1] = 0;
+                pixel[2] = 255;
+            }
+            pixel[3] = 255;
+        }
+    }
+
+    result.DifferentFraction = pixelCount ? static_cast<float>(result.DifferentPixels) / pixelCount : 0.0f;
+    return result;
+}
@@ -0,0 +1,26 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// BGRA8 pixels, bottom row first, the way FrameReadback returns them
+struct Image
+{
+    uint32_t Width = 0, Height = 0;
+    std::vector<uint8_t> Pixels;
+};
+
+struct ImageDifference
+{
+    uint32_t DifferentPixels = 0; // pixels with a channel off by more than the tolerance
+    uint32_t MaxChannelDifference = 0;
+    float DifferentFraction = 0.0f;
+};
+
+// TGA files, the golden images are written as uncompressed 24 bit so they diff well in git
+bool ReadTGA(const std::string& path, Image& image);
+bool WriteTGA(const std::string& path, const Image& image);
+
+// Compares the color channels, alpha of the framebuffer is not part of the picture
+// The difference image shows the expected image darkened, with the pixels over the tolerance in red
+ImageDifference CompareImages(const Image& actual, const Image& expected, uint32_t tolerance, Image* difference);
@@ -0,0 +1,326 @@
+﻿// Engine: Mashenka Game Engine
+// MashenkaRegression: renders the scripted scenes offscreen, compares the last frame of each against its golden
+// image and the CPU frame times against the baseline. Exits with 1 on a visual or performance regression, 2 on bad
+// options and 3 when no golden image or baseline was recorded yet
+//
+// Run it from the Sandbox directory (shaders and textures are loaded from assets/), on a software rasterizer so
+// the images don't depend on the GPU. On Windows, put the opengl32.dll of a Mesa build (e.g. mesa-dist-win) next to
+// the executable, it is loaded instead of the system OpenGL. Mesa picks llvmpipe through GALLIUM_DRIVER, which is
+// set unless the caller set it already
+//   --update             write the golden images and the baseline from this run, without it a missing one fails
+//   --golden <dir>       golden images, ../MashenkaRegression/golden
+//   --baseline <file>    frame time baseline, ../MashenkaRegression/baseline.json
+//   --output <dir>       actual and difference images of failed scenes, regression-output
+//   --tolerance <n>      per channel difference that still counts as the same pixel, 2
+//   --max-different <f>  fraction of different pixels a scene may have, 0.001
+//   --perf-threshold <f> allowed slowdown of the p50 and p95 frame times, 0.25
+//   --frames <n>         measured frames per scene, 300
+#include "RegressionScene.h"
+#include "GoldenImage.h"
+#include "FrameTimeBaseline.h"
+#include "Mashenka/Renderer/FrameReadback.h"
+#include "Mashenka/Renderer/GPUFence.h"
+#include "Platform/OpenGL/OpenGLCapabilities.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+
+using namespace Mashenka;
+
+static constexpr uint32_t s_Width = 640, s_Height = 360;
+static constexpr uint32_t s_WarmupFrames = 30;
+static constexpr float s_TimeStep = 1.0f / 60.0f; // fixed, every run renders the same frames
+// Slowdowns smaller than this are noise, even when they are over the threshold of a very cheap scene
+static constexpr double s_PerfSlackMs = 0.05;
+
+struct Options
+{
+    bool Update = false;
+    std::string GoldenDirectory = "../MashenkaRegression/golden";
+    std::string BaselinePath = "../MashenkaRegression/baseline.json";
+    std::string OutputDirectory = "regression-output";
+    uint32_t Tolerance = 2;
+    float MaxDifferentFraction = 0.001f;
+    double PerfThreshold = 0.25;
+    uint32_t Frames = 300;
+};
+
+static bool ParseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (argument == "--update")
+        {
+            options.Update = true;
+            continue;
+        }
+        if (!value)
+        {
+            MK_ERROR("Unknown option or missing value: {0}", argument);
+            return false;
+        }
+
+        if (argument == "--golden")
+            options.GoldenDirectory = value;
+        else if (argument == "--baseline")
+            options.BaselinePath = value;
+        else if (argument == "--output")
+            options.OutputDirectory = value;
+        else if (argument == "--tolerance")
+            options.Tolerance = static_cast<uint32_t>(std::atoi(value));
+        else if (argument == "--max-different")
+            options.MaxDifferentFraction = static_cast<float>(std::atof(value));
+        else if (argument == "--perf-threshold")
+            options.PerfThreshold = std::atof(value);
+        else if (argument == "--frames")
+            options.Frames = std::max(1, std::atoi(value));
+        else
+        {
+            MK_ERROR("Unknown option: {0}", argument);
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+// Mesa reads these when the context is created, values set by the caller win
+static void SetDefaultEnvironment(const char* name, const char* value)
+{
+    if (std::getenv(name))
+        return;
+    _putenv_s(name, value);
+}
+
+// The last frame of a run and its CPU frame times
+struct SceneResult
+{
+    Image Frame;
+    FrameTimeSummary FrameTimes;
+};
+
+static SceneResult RunScene(RegressionScene& scene, const Ref<Framebuffer>& framebuffer, FrameReadback& readback,
+                            uint32_t frames)
+{
+    using Clock = std::chrono::steady_clock;
+    SceneResult result;
+    std::vector<double> frameTimes;
+    frameTimes.reserve(frames);
+
+    scene.OnAttach();
+    for (uint32_t frame = 0; frame < s_WarmupFrames + frames; frame++)
+    {
+        auto start = Clock::now();
+        Renderer::BeginFrame();
+        framebuffer->Bind();
+        scene.OnUpdate(s_TimeStep);
+        Renderer::EndFrame();
+        auto end = Clock::now();
+        if (frame >= s_WarmupFrames)
+            frameTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+
+        // frames don't overlap, the next one is measured on its own
+        GPUFence::Create()->Wait(UINT64_MAX);
+    }
+
+    // the framebuffer is still bound, read the last frame
+    readback.Request(s_Width, s_Height);
+    GPUFence::Create()->Wait(UINT64_MAX);
+    FrameReadback::PollResult polled;
+    do
+    {
+        polled = readback.Poll(result.Frame.Pixels, result.Frame.Width, result.Frame.Height);
+    } while (polled == FrameReadback::PollResult::NotReady && readback.GetPendingCount() > 0);
+    if (polled != FrameReadback::PollResult::Ready)
+        result.Frame = {}; // mapping failed, logged by the readback, the empty frame fails the comparison
+    framebuffer->Unbind();
+    scene.OnDetach();
+
+    result.FrameTimes = Summarize(std::move(frameTimes));
+    return result;
+}
+
+// true when at least one golden image or the baseline exists
+static bool HasReferences(const Options& options)
+{
+    std::error_code error;
+    if (std::filesystem::exists(options.BaselinePath, error))
+        return true;
+    for (const auto& entry : std::filesystem::directory_iterator(options.GoldenDirectory, error))
+    {
+        if (entry.path().extension() == ".tga")
+            return true;
+    }
+    return false;
+}
+
+// Returns false when the frame differs from the golden image
+static bool CheckImage(const std::string& name, const std::string& goldenName, const Image& frame,
+                       const Options& options)
+{
+    std::string goldenPath = (std::filesystem::path(options.GoldenDirectory) / (goldenName + ".tga")).string();
+    // a scene that shares the golden image of an earlier one is compared, not written
+    if (options.Update && name == goldenName)
+    {
+        if (frame.Pixels.empty())
+        {
+            MK_ERROR("  no frame was read back, '{0}' is left alone", goldenPath);
+            return false;
+        }
+        if (!WriteTGA(goldenPath, frame))
+        {
+            MK_ERROR("  could not write '{0}'", goldenPath);
+            return false;
+        }
+        MK_INFO("  wrote golden image '{0}'", goldenPath);
+        return true;
+    }
+
+    Image golden;
+    if (!ReadTGA(goldenPath, golden))
+    {
+        // a missing reference is a failure, otherwise a lost or misnamed golden image would pass unnoticed
+        MK_ERROR("  no golden image '{0}', write it with --update and check it in", goldenPath);
+        return false;
+    }
+
+    Image differenceImage;
+    ImageDifference difference = CompareImages(frame, golden, options.Tolerance, &differenceImage);
+    bool passed = difference.DifferentFraction <= options.MaxDifferentFraction;
+    MK_INFO("  image: {0} pixels ({1:.4f}%) over the tolerance, max channel difference {2} -> {3}",
+            difference.DifferentPixels, difference.DifferentFraction * 100.0f, difference.MaxChannelDifference,
+            passed ? "ok" : "FAILED");
+
+    if (!passed)
+    {
+        std::filesystem::path output(options.OutputDirectory);
+        WriteTGA((output / (name + "_actual.tga")).string(), frame);
+        if (!differenceImage.Pixels.empty())
+            WriteTGA((output / (name + "_difference.tga")).string(), differenceImage);
+        MK_ERROR("  images written to '{0}'", options.OutputDirectory);
+    }
+    return passed;
+}
+
+// Returns false when the scene got slower than the baseline allows
+static bool CheckFrameTimes(const FrameTimeSummary& frameTimes, const FrameTimeSummary* baseline,
+                            const Options& options)
+{
+    MK_INFO("  frame time: mean {0:.3f} ms, p50 {1:.3f} ms, p95 {2:.3f} ms, p99 {3:.3f} ms", frameTimes.Mean,
+            frameTimes.P50, frameTimes.P95, frameTimes.P99);
+    if (!baseline)
+        return true;
+
+    auto regressed = [&](double current, double previous)
+    {
+        return current > previous * (1.0 + options.PerfThreshold) && current - previous > s_PerfSlackMs;
+    };
+    bool passed = !regressed(frameTimes.P50, baseline->P50) && !regressed(frameTimes.P95, baseline->P95);
+    MK_INFO("  baseline:   p50 {0:.3f} ms, p95 {1:.3f} ms ({2:+.1f}%, {3:+.1f}%) -> {4}", baseline->P50, baseline->P95,
+            (frameTimes.P50 / baseline->P50 - 1.0) * 100.0, (frameTimes.P95 / baseline->P95 - 1.0) * 100.0,
+            passed ? "ok" : "FAILED");
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    Log::Init();
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+        return 2;
+
+    // without any reference every scene would fail, say once what is missing instead
+    if (!options.Update && !HasReferences(options))
+    {
+        MK_ERROR("No golden images in '{0}' and no baseline '{1}' were recorded yet. Run once with --update on "
+                 "llvmpipe, check the images and check them in", options.GoldenDirectory, options.BaselinePath);
+        return 3;
+    }
+
+    SetDefaultEnvironment("GALLIUM_DRIVER", "llvmpipe");
+
+    // nothing is shown, the scenes render into the framebuffer
+    Scope<Window> window = Window::Create(WindowProps("Mashenka Regression", s_Width, s_Height, false));
+    window->SetEventCallback([](Event&) {});
+    window->SetVSync(false);
+    // the same worker threads as the application, the scenes take the same code paths
+    JobSystem::Init();
+    Renderer::Init();
+    Renderer::OnWindowResize(s_Width, s_Height);
+
+    const std::string& renderer = OpenGLCapabilities::GetRendererName();
+    if (renderer.find("llvmpipe") == std::string::npos)
+        MK_WARN("Running on '{0}', the golden images are made with llvmpipe and may not match", renderer);
+
+    FramebufferSpecification specification;
+    specification.Width = s_Width;
+    specification.Height = s_Height;
+    Ref<Framebuffer> framebuffer = Framebuffer::Create(specification);
+    Scope<FrameReadback> readback = FrameReadback::Create(1);
+
+    std::error_code error;
+    std::filesystem::create_directories(options.GoldenDirectory, error);
+    std::filesystem::create_directories(options.OutputDirectory, error);
+
+    FrameTimeBaseline baseline;
+    std::string baselineError;
+    bool hasBaseline = !options.Update && ReadBaseline(options.BaselinePath, baseline, baselineError);
+    if (!options.Update && !hasBaseline)
+        MK_ERROR("No frame time baseline: {0}. Write it with --update and check it in", baselineError);
+    bool compareFrameTimes = hasBaseline && baseline.Renderer == renderer;
+    if (hasBaseline && !compareFrameTimes)
+        MK_WARN("The baseline was recorded on '{0}', frame times are not compared", baseline.Renderer);
+
+    FrameTimeBaseline results;
+    results.Renderer = renderer;
+    uint32_t failures = 0;
+    {
+        std::vector<Scope<RegressionScene>> scenes = CreateRegressionScenes();
+        for (auto& scene : scenes)
+        {
+            MK_INFO("{0}", scene->GetName());
+            SceneResult result = RunScene(*scene, framebuffer, *readback, options.Frames);
+            results.Scenes[scene->GetName()] = result.FrameTimes;
+
+            bool passed = CheckImage(scene->GetName(), scene->GetGoldenName(), result.Frame, options);
+            auto previous = baseline.Scenes.find(scene->GetName());
+            bool hasEntry = previous != baseline.Scenes.end();
+            passed &= CheckFrameTimes(result.FrameTimes, compareFrameTimes && hasEntry ? &previous->second : nullptr,
+                                      options);
+            // like a missing golden image, a scene without frame times would never be checked
+            if (compareFrameTimes && !hasEntry)
+            {
+                MK_ERROR("  no entry in the baseline, record it with --update and check it in");
+                passed = false;
+            }
+            if (!passed)
+                failures++;
+        }
+    }
+
+    // only --update records the baseline, other runs leave it alone so a slow drift is still caught
+    if (options.Update)
+    {
+        if (WriteBaseline(options.BaselinePath, results))
+            MK_INFO("Wrote frame time baseline '{0}'", options.BaselinePath);
+        else
+            MK_ERROR("Could not write '{0}'", options.BaselinePath);
+    }
+
+    readback.reset();
+    framebuffer.reset();
+    // the same order as Application, no job can be running while the renderer goes away
+    JobSystem::Shutdown();
+    Renderer::Shutdown();
+
+    if (failures)
+        MK_ERROR("{0} scenes regressed", failures);
+    if (!options.Update && !hasBaseline)
+        failures++;
+    if (!failures)
+        MK_INFO("No regressions");
+    return failures ? 1 : 0;
+}
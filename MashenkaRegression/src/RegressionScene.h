@@ -0,0 +1,28 @@
+﻿#pragma once
+#include "Mashenka.h"
+
+// A scripted Sandbox2D style scene, OnUpdate simulates and renders one frame
+// The harness always steps it with the same time step, so every run renders the same frames and the last one
+// can be compared against a golden image
+class RegressionScene : public Mashenka::Layer
+{
+public:
+    // Scenes that render the same picture through another renderer path share the golden image
+    RegressionScene(const std::string& name, const std::string& goldenName = "")
+        : Layer(name), m_GoldenName(goldenName.empty() ? name : goldenName)
+    {
+    }
+    virtual ~RegressionScene() = default;
+
+    const std::string& GetGoldenName() const { return m_GoldenName; }
+
+protected:
+    // 16:9, like the harness framebuffer
+    Mashenka::OrthographicCamera m_Camera{-8.0f, 8.0f, -4.5f, 4.5f};
+
+private:
+    std::string m_GoldenName;
+};
+
+// Every scene the harness runs, in order
+std::vector<Mashenka::Scope<RegressionScene>> CreateRegressionScenes();
@@ -0,0 +1,268 @@
+﻿// Engine: Mashenka Game Engine
+// MashenkaRegression: the scripted scenes, they cover the Renderer2D paths the optimizations touch
+#include "RegressionScene.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Mashenka;
+
+static void BeginFrame(const OrthographicCamera& camera)
+{
+    RenderCommand::SetClearColor({0.1f, 0.1f, 0.1f, 1.0f});
+    RenderCommand::Clear();
+    Renderer2D::BeginScene(camera);
+}
+
+// Thousands of colored rotated quads over a tiled texture, the batching and quad kernel path
+// With parallel submission the grid is recorded on the JobSystem and merged, it must come out in the same order
+class QuadGridScene : public RegressionScene
+{
+public:
+    QuadGridScene(const std::string& name, bool vertexPulling, bool parallelSubmit = false)
+        : RegressionScene(name, "Quads"), m_VertexPulling(vertexPulling), m_ParallelSubmit(parallelSubmit)
+    {
+    }
+
+    void OnAttach() override
+    {
+        m_CheckerboardTexture = Texture2D::Create("assets/textures/Checkerboard.png");
+        m_WasVertexPulling = Renderer2D::IsVertexPullingEnabled();
+        Renderer2D::SetVertexPullingEnabled(m_VertexPulling);
+    }
+
+    void OnDetach() override
+    {
+        Renderer2D::SetVertexPullingEnabled(m_WasVertexPulling);
+    }
+
+    void OnUpdate(TimeStep ts) override
+    {
+        m_Time += ts;
+
+        BeginFrame(m_Camera);
+        Renderer2D::DrawQuad({0.0f, 0.0f, -0.1f}, {16.0f, 9.0f}, m_CheckerboardTexture, 8.0f,
+                             {0.6f, 0.6f, 0.7f, 1.0f});
+        // the overlapping translucent quads only blend to the golden image in this order
+        const uint32_t count = s_Columns * s_Rows + 1;
+        if (m_ParallelSubmit)
+        {
+            Renderer2D::ParallelSubmit(count, 512, [this](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t i = begin; i < end; i++)
+                    DrawElement(i);
+            });
+        }
+        else
+        {
+            for (uint32_t i = 0; i < count; i++)
+                DrawElement(i);
+        }
+        Renderer2D::EndScene();
+    }
+
+private:
+    // The grid row by row, then a textured quad on top
+    void DrawElement(uint32_t i) const
+    {
+        if (i == s_Columns * s_Rows)
+        {
+            Renderer2D::DrawRotatedQuad({2.0f, 1.0f}, {3.0f, 3.0f}, m_Time * 0.5f, m_CheckerboardTexture, 2.0f);
+            return;
+        }
+
+        uint32_t x = i % s_Columns, y = i / s_Columns;
+        glm::vec2 position = {-7.9f + x * 0.166f, -4.4f + y * 0.166f};
+        glm::vec4 color = {x / float(s_Columns), 0.4f, y / float(s_Rows), 0.75f};
+        Renderer2D::DrawRotatedQuad(position, {0.12f, 0.12f}, m_Time + (x + y) * 0.1f, color);
+    }
+
+private:
+    static constexpr uint32_t s_Columns = 96, s_Rows = 54;
+
+    Ref<Texture2D> m_CheckerboardTexture;
+    bool m_VertexPulling, m_WasVertexPulling = false;
+    bool m_ParallelSubmit;
+    float m_Time = 0.0f;
+};
+
+// A large tile map under a retained sprite batch, the chunk culling and dirty range upload path
+class TileMapScene : public RegressionScene
+{
+public:
+    TileMapScene() : RegressionScene("TileMap") {}
+
+    void OnAttach() override
+    {
+        const uint32_t mapSize = 256;
+        const float tileSize = 0.25f;
+        m_TileMap = CreateScope<TileMap>(mapSize, mapSize, tileSize,
+                                         glm::vec3(-0.5f * mapSize * tileSize, -0.5f * mapSize * tileSize, -0.2f));
+        for (uint32_t y = 0; y < mapSize; y++)
+        {
+            for (uint32_t x = 0; x < mapSize; x++)
+            {
+                float shade = (x + y) % 2 ? 0.25f : 0.3f;
+                m_TileMap->SetTile(x, y, 0, {shade, shade + 0.05f * (x % 4), shade, 1.0f});
+            }
+        }
+
+        m_SpriteBatch = CreateScope<SpriteBatch>(1024);
+        for (int y = 0; y < 24; y++)
+        {
+            for (int x = 0; x < 24; x++)
+            {
+                glm::vec3 position = {-6.0f + x * 0.5f, -4.0f + y * 0.35f, 0.05f};
+                SpriteHandle sprite = m_SpriteBatch->Add(position, {0.3f, 0.3f}, {x / 24.0f, 0.5f, y / 24.0f, 1.0f});
+                if ((x + y) % 5 == 0)
+                    m_SpinningSprites.push_back(sprite);
+            }
+        }
+    }
+
+    void OnUpdate(TimeStep ts) override
+    {
+        m_Time += ts;
+        // only a few sprites change, the rest of the batch stays on the GPU
+        for (size_t i = 0; i < m_SpinningSprites.size(); i++)
+            m_SpriteBatch->SetRotation(m_SpinningSprites[i], m_Time * (1.0f + i % 3));
+
+        // the camera pans, so chunks enter and leave the view
+        m_Camera.SetPosition({3.0f * std::sin(m_Time * 0.5f), 2.0f * std::cos(m_Time * 0.3f), 0.0f});
+
+        BeginFrame(m_Camera);
+        Renderer2D::DrawTileMap(*m_TileMap);
+        Renderer2D::DrawSpriteBatch(*m_SpriteBatch);
+        Renderer2D::EndScene();
+    }
+
+private:
+    Scope<TileMap> m_TileMap;
+    Scope<SpriteBatch> m_SpriteBatch;
+    std::vector<SpriteHandle> m_SpinningSprites;
+    float m_Time = 0.0f;
+};
+
+// The Sandbox2D fountain, the instanced particle path
+class ParticleScene : public RegressionScene
+{
+public:
+    ParticleScene() : RegressionScene("Particles") {}
+
+    void OnAttach() override
+    {
+        m_ParticleSystem = CreateScope<ParticleSystem>(100000);
+        m_ParticleSystem->SetDepth(0.2f);
+        m_Fountain.Position = {0.0f, -3.0f};
+        m_Fountain.Velocity = {0.0f, 3.0f};
+        m_Fountain.VelocityVariation = {3.0f, 1.5f};
+        m_Fountain.ColorBegin = {1.0f, 0.6f, 0.2f, 1.0f};
+        m_Fountain.ColorEnd = {0.8f, 0.1f, 0.3f, 0.0f};
+        m_Fountain.SizeBegin = 0.08f;
+        m_Fountain.SizeVariation = 0.04f;
+        m_Fountain.LifeTime = 2.0f;
+    }
+
+    void OnUpdate(TimeStep ts) override
+    {
+        m_ParticleSystem->Emit(m_Fountain, 500);
+        m_ParticleSystem->OnUpdate(ts);
+
+        BeginFrame(m_Camera);
+        Renderer2D::DrawQuad({0.0f, -3.5f}, {16.0f, 1.0f}, {0.2f, 0.3f, 0.8f, 1.0f});
+        Renderer2D::DrawParticles(*m_ParticleSystem);
+        Renderer2D::EndScene();
+    }
+
+private:
+    Scope<ParticleSystem> m_ParticleSystem;
+    ParticleProps m_Fountain;
+};
+
+// Three meshes in one MeshPool, drawn as instances of one MultiDrawIndexedIndirect call
+// The pool starts with room for fewer draws than the scene queues, so the command buffer has to grow
+class MeshPoolScene : public RegressionScene
+{
+public:
+    MeshPoolScene() : RegressionScene("MeshPool") {}
+
+    void OnAttach() override
+    {
+        m_Shader = Shader::Create("assets/shaders/MeshPool.glsl");
+
+        BufferLayout layout = {{ShaderDataType::Float3, "a_Position"}};
+        m_MeshPool = CreateScope<MeshPool>(layout, 1024, 1024, 4);
+
+        float triangle[] = {-0.5f, -0.4f, 0.0f, 0.5f, -0.4f, 0.0f, 0.0f, 0.5f, 0.0f};
+        uint32_t triangleIndices[] = {0, 1, 2};
+        m_Meshes.push_back(m_MeshPool->Add(triangle, 3, triangleIndices, 3));
+
+        float quad[] = {-0.4f, -0.4f, 0.0f, 0.4f, -0.4f, 0.0f, 0.4f, 0.4f, 0.0f, -0.4f, 0.4f, 0.0f};
+        uint32_t quadIndices[] = {0, 1, 2, 2, 3, 0};
+        m_Meshes.push_back(m_MeshPool->Add(quad, 4, quadIndices, 6));
+
+        // a hexagon as a fan around its center
+        std::vector<float> hexagon = {0.0f, 0.0f, 0.0f};
+        std::vector<uint32_t> hexagonIndices;
+        for (uint32_t i = 0; i < 6; i++)
+        {
+            float angle = glm::radians(60.0f * i);
+            hexagon.insert(hexagon.end(), {0.5f * std::cos(angle), 0.5f * std::sin(angle), 0.0f});
+            hexagonIndices.insert(hexagonIndices.end(), {0, 1 + i, 1 + (i + 1) % 6});
+        }
+        m_Meshes.push_back(m_MeshPool->Add(hexagon.data(), 7, hexagonIndices.data(),
+                                           static_cast<uint32_t>(hexagonIndices.size())));
+
+        // one row of instances per draw, the draws of a mesh use different instance ranges
+        std::vector<float> instances;
+        for (uint32_t row = 0; row < s_Rows; row++)
+        {
+            for (uint32_t column = 0; column < s_Columns; column++)
+            {
+                float x = -7.0f + column * 1.0f, y = -3.75f + row * 1.0f;
+                float scale = 0.6f + 0.05f * (column % 4);
+                glm::vec4 color = {column / float(s_Columns), 0.3f + 0.1f * (row % 3), row / float(s_Rows), 1.0f};
+                instances.insert(instances.end(), {x, y, scale, color.r, color.g, color.b, color.a});
+            }
+        }
+        auto instanceBytes = static_cast<uint32_t>(instances.size() * sizeof(float));
+        Ref<VertexBuffer> instanceBuffer = VertexBuffer::Create(instances.data(), instanceBytes);
+        instanceBuffer->SetLayout(BufferLayout({
+            {ShaderDataType::Float2, "a_Offset"},
+            {ShaderDataType::Float, "a_Scale"},
+            {ShaderDataType::Float4, "a_Color"}
+        }, true));
+        m_MeshPool->AddInstanceBuffer(instanceBuffer);
+    }
+
+    void OnUpdate(TimeStep ts) override
+    {
+        RenderCommand::SetClearColor({0.1f, 0.1f, 0.1f, 1.0f});
+        RenderCommand::Clear();
+        Renderer::BeginScene(m_Camera);
+        for (uint32_t row = 0; row < s_Rows; row++)
+            m_MeshPool->Submit(m_Meshes[row % m_Meshes.size()], s_Columns, row * s_Columns);
+        Renderer::Submit(m_Shader, *m_MeshPool);
+        Renderer::EndScene();
+    }
+
+private:
+    static constexpr uint32_t s_Rows = 8, s_Columns = 15;
+
+    Ref<Shader> m_Shader;
+    Scope<MeshPool> m_MeshPool;
+    std::vector<MeshHandle> m_Meshes;
+};
+
+std::vector<Scope<RegressionScene>> CreateRegressionScenes()
+{
+    std::vector<Scope<RegressionScene>> scenes;
+    scenes.push_back(CreateScope<QuadGridScene>("Quads", false));
+    // vertex pulling must draw exactly what the vertex path draws
+    scenes.push_back(CreateScope<QuadGridScene>("QuadsVertexPulling", true));
+    // so must the quads recorded on the JobSystem threads and merged
+    scenes.push_back(CreateScope<QuadGridScene>("QuadsParallelSubmit", false, true));
+    scenes.push_back(CreateScope<TileMapScene>());
+    scenes.push_back(CreateScope<ParticleScene>());
+    scenes.push_back(CreateScope<MeshPoolScene>());
+    return scenes;
+}
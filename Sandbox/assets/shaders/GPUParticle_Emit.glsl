@@ -0,0 +1,90 @@
+﻿// GPUParticleSystem emission, one thread per new particle
+// The slot comes from the instance count of the draw command, particles that do not fit are dropped
+#version 450 core
+
+layout(local_size_x = 256) in;
+
+struct Particle
+{
+	vec2 Position;
+	vec2 Velocity;
+	vec4 Color;
+	vec4 ColorDelta;
+	float Size;
+	float SizeDelta;
+	float Life;
+	float Padding;
+};
+
+struct DrawCommand
+{
+	uint Count;
+	uint InstanceCount;
+	uint FirstIndex;
+	int BaseVertex;
+	uint BaseInstance;
+};
+
+layout(std430, binding = 2) writeonly buffer Particles { Particle d_Particles[]; };
+layout(std430, binding = 3) buffer Command { DrawCommand d_Command; };
+
+uniform int u_Count;
+uniform int u_MaxParticles;
+uniform int u_Seed;
+
+uniform vec2 u_Position;
+uniform vec2 u_Velocity;
+uniform vec2 u_VelocityVariation;
+uniform vec4 u_ColorBegin;
+uniform vec4 u_ColorEnd;
+uniform float u_SizeBegin;
+uniform float u_SizeEnd;
+uniform float u_SizeVariation;
+uniform float u_LifeTime;
+
+uint Hash(uint x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+// in [0, 1)
+float Random(inout uint state)
+{
+	state = Hash(state);
+	return float(state >> 8) / 16777216.0;
+}
+
+void main()
+{
+	uint index = gl_GlobalInvocationID.x;
+	if (index >= uint(u_Count))
+		return;
+
+	uint slot = atomicAdd(d_Command.InstanceCount, 1u);
+	if (slot >= uint(u_MaxParticles))
+	{
+		// give the slot back, the count ends up at the capacity
+		atomicAdd(d_Command.InstanceCount, 0xFFFFFFFFu);
+		return;
+	}
+
+	uint state = Hash(index ^ Hash(uint(u_Seed)));
+	float inverseLifeTime = 1.0 / u_LifeTime;
+
+	Particle particle;
+	particle.Position = u_Position;
+	particle.Velocity.x = u_Velocity.x + u_VelocityVariation.x * (Random(state) - 0.5);
+	particle.Velocity.y = u_Velocity.y + u_VelocityVariation.y * (Random(state) - 0.5);
+	particle.Color = u_ColorBegin;
+	particle.ColorDelta = (u_ColorEnd - u_ColorBegin) * inverseLifeTime;
+	particle.Size = u_SizeBegin + u_SizeVariation * (Random(state) - 0.5);
+	particle.SizeDelta = (u_SizeEnd - particle.Size) * inverseLifeTime;
+	particle.Life = u_LifeTime;
+	particle.Padding = 0.0;
+	d_Particles[slot] = particle;
+}
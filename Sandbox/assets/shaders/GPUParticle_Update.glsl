@@ -0,0 +1,54 @@
+﻿// GPUParticleSystem update, one thread per particle of the source buffer
+// Live particles are appended to the destination buffer, the instance count of its draw command is the counter
+#version 450 core
+
+layout(local_size_x = 256) in;
+
+struct Particle
+{
+	vec2 Position;
+	vec2 Velocity;
+	vec4 Color;
+	vec4 ColorDelta;
+	float Size;
+	float SizeDelta;
+	float Life;
+	float Padding;
+};
+
+// same layout as DrawElementsIndirectCommand
+struct DrawCommand
+{
+	uint Count;
+	uint InstanceCount;
+	uint FirstIndex;
+	int BaseVertex;
+	uint BaseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer SourceParticles { Particle s_Particles[]; };
+layout(std430, binding = 1) readonly buffer SourceCommand { DrawCommand s_Command; };
+layout(std430, binding = 2) writeonly buffer DestinationParticles { Particle d_Particles[]; };
+layout(std430, binding = 3) buffer DestinationCommand { DrawCommand d_Command; };
+
+uniform float u_DeltaTime;
+
+void main()
+{
+	uint index = gl_GlobalInvocationID.x;
+	if (index >= s_Command.InstanceCount)
+		return;
+
+	Particle particle = s_Particles[index];
+	particle.Life -= u_DeltaTime;
+	if (particle.Life <= 0.0)
+		return;
+
+	particle.Position += particle.Velocity * u_DeltaTime;
+	particle.Color += particle.ColorDelta * u_DeltaTime;
+	particle.Size += particle.SizeDelta * u_DeltaTime;
+
+	// never more live particles than in the source, the slot always fits
+	uint slot = atomicAdd(d_Command.InstanceCount, 1u);
+	d_Particles[slot] = particle;
+}
@@ -0,0 +1,32 @@
+﻿// MeshPool shader, every draw of the pool picks its instances with the baseInstance of its indirect command
+// The instance moves, scales and colors the mesh
+
+#type vertex
+#version 430 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec2 a_Offset;
+layout(location = 2) in float a_Scale;
+layout(location = 3) in vec4 a_Color;
+
+uniform mat4 u_ViewProjection;
+
+out vec4 v_Color;
+
+void main()
+{
+	v_Color = a_Color;
+	gl_Position = u_ViewProjection * vec4(a_Position.xy * a_Scale + a_Offset, a_Position.z, 1.0);
+}
+
+#type fragment
+#version 430 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+	color = v_Color;
+}
@@ -0,0 +1,46 @@
+﻿// Renderer2D shader for GPUParticleSystem, one instance per particle
+// The particles stay in the storage buffer written by the compute shaders, the vertex shader reads them directly
+
+#type vertex
+#version 450 core
+
+struct Particle
+{
+	vec2 Position;
+	vec2 Velocity;
+	vec4 Color;
+	vec4 ColorDelta;
+	float Size;
+	float SizeDelta;
+	float Life;
+	float Padding;
+};
+
+layout(std430, binding = 0) readonly buffer Particles { Particle s_Particles[]; };
+
+uniform mat4 u_ViewProjection;
+uniform float u_Depth;
+
+out vec4 v_Color;
+
+const vec2 c_Corners[4] = vec2[4](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
+
+void main()
+{
+	Particle particle = s_Particles[gl_InstanceID];
+	v_Color = clamp(particle.Color, 0.0, 1.0);
+	vec2 corner = c_Corners[gl_VertexID];
+	gl_Position = u_ViewProjection * vec4(particle.Position + corner * particle.Size, u_Depth, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+	color = v_Color;
+}
@@ -0,0 +1,33 @@
+﻿// Renderer2D particle shader, one instance per particle
+// The instance carries the position, the size and the packed color, the corner comes from the shared quad
+
+#type vertex
+#version 330 core
+
+layout(location = 0) in vec2 a_Corner;
+layout(location = 1) in vec2 a_Position;
+layout(location = 2) in float a_Size;
+layout(location = 3) in vec4 a_Color;
+
+uniform mat4 u_ViewProjection;
+uniform float u_Depth;
+
+out vec4 v_Color;
+
+void main()
+{
+	v_Color = a_Color;
+	gl_Position = u_ViewProjection * vec4(a_Position + a_Corner * a_Size, u_Depth, 1.0);
+}
+
+#type fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+	color = v_Color;
+}
@@ -0,0 +1,95 @@
+﻿// Renderer2D batched quad shader with vertex pulling
+// There are no vertex attributes, every quad is one 32 byte instance in a storage buffer and the vertex shader
+// builds its corners, gl_VertexID comes from the quad index buffer: gl_VertexID / 4 is the quad, % 4 the corner
+#variant TEXTURED
+
+#type vertex
+#version 450 core
+
+// must match QuadInstance in QuadKernel.h
+struct QuadInstance
+{
+	vec3 Position;
+	float Rotation;
+	vec2 Size;
+	uint Color;
+	uint TexIndexTiling;
+};
+
+layout(std430, binding = 0) readonly buffer Instances { QuadInstance s_Instances[]; };
+
+uniform mat4 u_ViewProjection;
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+flat out float v_TexIndex;
+out float v_TilingFactor;
+
+// in the order of the index buffer (0, 1, 2, 2, 3, 0)
+const vec2 c_Corners[4] = vec2[4](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
+const vec2 c_TexCoords[4] = vec2[4](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+void main()
+{
+	QuadInstance quad = s_Instances[gl_VertexID >> 2];
+	int corner = gl_VertexID & 3;
+
+	vec2 local = c_Corners[corner] * quad.Size;
+	float c = cos(quad.Rotation);
+	float s = sin(quad.Rotation);
+	vec2 position = quad.Position.xy + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+
+	v_Color = unpackUnorm4x8(quad.Color);
+	v_TexCoord = c_TexCoords[corner];
+	v_TexIndex = float(quad.TexIndexTiling & 0xFFu);
+	v_TilingFactor = unpackHalf2x16(quad.TexIndexTiling >> 16).x;
+	gl_Position = u_ViewProjection * vec4(position, quad.Position.z, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+flat in float v_TexIndex;
+in float v_TilingFactor;
+
+#ifdef TEXTURED
+uniform sampler2D u_Textures[16];
+
+// the index is the same for the whole quad, but not dynamically uniform across the draw, keep the switch
+vec4 SampleTexture(int index, vec2 texCoord)
+{
+	switch (index)
+	{
+	case 0: return texture(u_Textures[0], texCoord);
+	case 1: return texture(u_Textures[1], texCoord);
+	case 2: return texture(u_Textures[2], texCoord);
+	case 3: return texture(u_Textures[3], texCoord);
+	case 4: return texture(u_Textures[4], texCoord);
+	case 5: return texture(u_Textures[5], texCoord);
+	case 6: return texture(u_Textures[6], texCoord);
+	case 7: return texture(u_Textures[7], texCoord);
+	case 8: return texture(u_Textures[8], texCoord);
+	case 9: return texture(u_Textures[9], texCoord);
+	case 10: return texture(u_Textures[10], texCoord);
+	case 11: return texture(u_Textures[11], texCoord);
+	case 12: return texture(u_Textures[12], texCoord);
+	case 13: return texture(u_Textures[13], texCoord);
+	case 14: return texture(u_Textures[14], texCoord);
+	case 15: return texture(u_Textures[15], texCoord);
+	}
+	return vec4(1.0);
+}
+#endif
+
+void main()
+{
+#ifdef TEXTURED
+	color = SampleTexture(int(v_TexIndex), v_TexCoord * v_TilingFactor) * v_Color;
+#else
+	color = v_Color;
+#endif
+}
@@ -1,4 +1,6 @@
 ﻿// Basic Texture Shader
+// The base program samples u_Texture, the FLAT variant skips the texture fetch and only draws u_Color
+#variant FLAT
 
 #type vertex
 #version 330 core
@@ -25,10 +27,16 @@ layout(location = 0) out vec4 color;
 in vec2 v_TexCoord;
 
 uniform vec4 u_Color;
+#ifndef FLAT
 uniform float u_TilingFactor;
 uniform sampler2D u_Texture;
+#endif
 
 void main()
 {
+#ifndef FLAT
 	color = texture(u_Texture, v_TexCoord * u_TilingFactor) * u_Color;
+#else
+	color = u_Color;
+#endif
 }
\ No newline at end of file
@@ -148,6 +148,9 @@ ExampleLayer::ExampleLayer()
     m_ChernoLogoTexture = Mashenka::Texture2D::Create("assets/textures/ChernoLogo.png");
     std::dynamic_pointer_cast<Mashenka::OpenGLShader>(textureShader)->Bind();
     std::dynamic_pointer_cast<Mashenka::OpenGLShader>(textureShader)->UploadUniformInt("u_Texture", 0);
+
+    // edit the shaders in assets/shaders while the sandbox runs
+    m_ShaderLibrary.EnableHotReload("assets/shaders");
 }
 
 ExampleLayer::~ExampleLayer()
@@ -169,6 +172,13 @@ void ExampleLayer::OnUpdate(Mashenka::TimeStep ts)
     // Update the camera controller
     m_CameraController.OnUpdate(ts);
 
+    // Swap in reloaded shaders, the texture slot is a uniform of the new program
+    for (const auto& shader : m_ShaderLibrary.Update())
+    {
+        shader->Bind();
+        shader->SetInt("u_Texture", 0);
+    }
+
 
     // ==Render Pipeline==
     // call on render command
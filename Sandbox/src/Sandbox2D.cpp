@@ -14,6 +14,53 @@ void Sandbox2D::OnAttach()
 {
     MK_PROFILE_FUNCTION(); // Profiling
     m_CheckerboardTexture = Mashenka::Texture2D::Create("assets/textures/Checkerboard.png");
+
+    // a large map, only the chunks around the camera are drawn
+    const uint32_t mapSize = 512;
+    const float tileSize = 0.25f;
+    m_TileMap = Mashenka::CreateScope<Mashenka::TileMap>(mapSize, mapSize, tileSize,
+                                                         glm::vec3(-0.5f * mapSize * tileSize,
+                                                                   -0.5f * mapSize * tileSize, -0.2f));
+    for (uint32_t y = 0; y < mapSize; y++)
+    {
+        for (uint32_t x = 0; x < mapSize; x++)
+        {
+            float shade = (x + y) % 2 ? 0.25f : 0.3f;
+            m_TileMap->SetTile(x, y, 0, {shade, shade + 0.05f * (x % 4), shade, 1.0f});
+        }
+    }
+
+    m_SpriteBatch = Mashenka::CreateScope<Mashenka::SpriteBatch>(1024);
+    for (int y = 0; y < 10; y++)
+    {
+        for (int x = 0; x < 10; x++)
+        {
+            glm::vec3 position = {2.0f + x * 0.3f, -1.5f + y * 0.3f, 0.05f};
+            m_SpriteBatch->Add(position, {0.25f, 0.25f}, {x / 10.0f, 0.4f, y / 10.0f, 1.0f});
+        }
+    }
+    m_SpinningSprite = m_SpriteBatch->Add({3.35f, 1.75f, 0.1f}, {0.5f, 0.5f}, m_CheckerboardTexture);
+
+    m_ParticleSystem = Mashenka::CreateScope<Mashenka::ParticleSystem>(100000);
+    m_ParticleSystem->SetDepth(0.2f);
+    m_Fountain.Position = {-3.0f, -1.0f};
+    m_Fountain.Velocity = {0.0f, 2.0f};
+    m_Fountain.VelocityVariation = {2.0f, 1.0f};
+    m_Fountain.ColorBegin = {1.0f, 0.6f, 0.2f, 1.0f};
+    m_Fountain.ColorEnd = {0.8f, 0.1f, 0.3f, 0.0f};
+    m_Fountain.SizeBegin = 0.08f;
+    m_Fountain.SizeVariation = 0.04f;
+    m_Fountain.LifeTime = 2.0f;
+
+    // the same effect simulated by compute shaders, a lot more of it
+    m_GPUParticleSystem = Mashenka::CreateScope<Mashenka::GPUParticleSystem>(1000000);
+    m_GPUParticleSystem->SetDepth(0.2f);
+    m_GPUFountain = m_Fountain;
+    m_GPUFountain.Position = {-5.0f, -1.0f};
+    m_GPUFountain.ColorBegin = {0.2f, 0.6f, 1.0f, 1.0f};
+    m_GPUFountain.ColorEnd = {0.3f, 0.1f, 0.8f, 0.0f};
+    m_GPUFountain.SizeBegin = 0.03f;
+    m_GPUFountain.SizeVariation = 0.02f;
 }
 
 void Sandbox2D::OnDetach()
@@ -32,6 +79,16 @@ void Sandbox2D::OnUpdate(Mashenka::TimeStep ts)
         MK_PROFILE_SCOPE("CameraController::OnUpdate");
         m_CameraController.OnUpdate(ts);
     }
+    {
+        MK_PROFILE_SCOPE("ParticleSystem::OnUpdate");
+        m_ParticleSystem->Emit(m_Fountain, 200);
+        m_ParticleSystem->OnUpdate(ts);
+    }
+    {
+        MK_PROFILE_SCOPE("GPUParticleSystem::OnUpdate");
+        m_GPUParticleSystem->Emit(m_GPUFountain, 5000);
+        m_GPUParticleSystem->OnUpdate(ts);
+    }
 
     //render
     {
@@ -45,10 +102,16 @@ void Sandbox2D::OnUpdate(Mashenka::TimeStep ts)
     {
         MK_PROFILE_SCOPE("Render Draw");
         Mashenka::Renderer2D::BeginScene(m_CameraController.GetCamera());
+        Mashenka::Renderer2D::DrawTileMap(*m_TileMap);
+        m_SpinAngle += ts * 1.0f;
+        m_SpriteBatch->SetRotation(m_SpinningSprite, m_SpinAngle);
+        Mashenka::Renderer2D::DrawSpriteBatch(*m_SpriteBatch);
+        Mashenka::Renderer2D::DrawParticles(*m_ParticleSystem);
+        Mashenka::Renderer2D::DrawParticles(*m_GPUParticleSystem);
         Mashenka::Renderer2D::DrawRotatedQuad({ -1.0f, 0.0f }, { 0.8f, 0.8f }, glm::radians(-45.0f), { 0.8f, 0.2f, 0.3f, 1.0f });
         Mashenka::Renderer2D::DrawRotatedQuad({ 0.5f, -0.5f }, { 0.5f, 0.75f }, 0.0f, { 0.2f, 0.3f, 0.8f, 1.0f });
         Mashenka::Renderer2D::DrawRotatedQuad({ 0.0f, 0.0f, -0.1f }, { 10.0f, 10.0f }, 0.0f, m_CheckerboardTexture, 10.f);
-        Mashenka::Renderer::EndScene();
+        Mashenka::Renderer2D::EndScene(); // draws the batch
     }
 
 }
@@ -61,6 +124,53 @@ void Sandbox2D::OnImGuiRender()
     // Setup a settings window and use Square Color as a color picker
     ImGui::Begin("Settings");
     ImGui::ColorEdit4("Square Color", glm::value_ptr(m_SquareColor));
+
+    // the stats of this frame, the full panel lives in the ImGuiLayer
+    const auto& stats = Mashenka::RendererStats::GetStats();
+    ImGui::Text("Draw calls: %u, quads: %u", stats.DrawCalls, stats.QuadCount);
+    Mashenka::ImGuiLayer* imGuiLayer = Mashenka::Application::Get().GetImGuiLayer();
+    bool showStats = imGuiLayer->IsShowingRendererStats();
+    if (ImGui::Checkbox("Renderer Stats", &showStats))
+        imGuiLayer->SetShowRendererStats(showStats);
+    bool vertexPulling = Mashenka::Renderer2D::IsVertexPullingEnabled();
+    if (ImGui::Checkbox("Vertex Pulling", &vertexPulling))
+        Mashenka::Renderer2D::SetVertexPullingEnabled(vertexPulling);
+    bool dynamicResolution = Mashenka::DynamicResolution::IsEnabled();
+    if (ImGui::Checkbox("Dynamic Resolution", &dynamicResolution))
+        Mashenka::DynamicResolution::SetEnabled(dynamicResolution);
+    if (dynamicResolution)
+    {
+        ImGui::Text("Scale: %.2f, scene GPU time: %.2f ms", Mashenka::DynamicResolution::GetScale(),
+                    Mashenka::DynamicResolution::GetGPUFrameTime());
+    }
+
+    int framesInFlight = static_cast<int>(Mashenka::FramePacer::GetMaxFramesInFlight());
+    if (ImGui::SliderInt("Frames In Flight", &framesInFlight, 1, 3))
+        Mashenka::FramePacer::SetMaxFramesInFlight(static_cast<uint32_t>(framesInFlight));
+    float frameRateCap = Mashenka::FramePacer::GetFrameRateCap();
+    if (ImGui::DragFloat("FPS Cap (0 = off)", &frameRateCap, 1.0f, 0.0f, 500.0f))
+        Mashenka::FramePacer::SetFrameRateCap(frameRateCap);
+    float backgroundCap = Mashenka::FramePacer::GetBackgroundFrameRateCap();
+    if (ImGui::DragFloat("Background FPS Cap", &backgroundCap, 1.0f, 0.0f, 120.0f))
+        Mashenka::FramePacer::SetBackgroundFrameRateCap(backgroundCap);
+    const auto& pacing = Mashenka::FramePacer::GetStats();
+    ImGui::Text("Frame: %.2f ms, jitter: %.2f ms (max %.2f), GPU wait: %.2f ms", pacing.FrameTime, pacing.Jitter,
+                pacing.MaxDeviation, pacing.FenceWaitTime);
+
+    if (ImGui::Button("Screenshot"))
+        Mashenka::FrameCapture::Screenshot("Screenshot.tga");
+    ImGui::SameLine();
+    bool recording = Mashenka::FrameCapture::IsRecording();
+    if (ImGui::Button(recording ? "Stop Recording" : "Record"))
+    {
+        if (recording)
+            Mashenka::FrameCapture::StopRecording();
+        else
+            Mashenka::FrameCapture::StartRecording("Capture");
+    }
+    const auto capture = Mashenka::FrameCapture::GetStats();
+    ImGui::Text("Captured: %u, written: %u, dropped: %u", capture.FramesCaptured, capture.FramesWritten,
+                capture.FramesDropped);
     ImGui::End();
 }
 
@@ -25,6 +25,16 @@ private:
     Mashenka::Ref<Mashenka::Shader> m_FlatColorShader;
 
     Mashenka::Ref<Mashenka::Texture2D> m_CheckerboardTexture;
+    Mashenka::Scope<Mashenka::TileMap> m_TileMap; // ground, behind everything else
+    // static sprites, only the spinning one is uploaded again every frame
+    Mashenka::Scope<Mashenka::SpriteBatch> m_SpriteBatch;
+    Mashenka::SpriteHandle m_SpinningSprite;
+    float m_SpinAngle = 0.0f;
+
+    Mashenka::Scope<Mashenka::ParticleSystem> m_ParticleSystem;
+    Mashenka::ParticleProps m_Fountain;
+    Mashenka::Scope<Mashenka::GPUParticleSystem> m_GPUParticleSystem;
+    Mashenka::ParticleProps m_GPUFountain;
 
     glm::vec4 m_SquareColor = { 0.2f, 0.3f, 0.8f, 1.0f };
 };
@@ -5,6 +5,7 @@
 // sandbox2D
 #include "ExampleLayer.h"
 #include "Sandbox2D.h"
+#include "StressTestLayer.h"
 
 
 // Should not include anything else than the engine to make it work, below is TEMP
@@ -20,22 +21,57 @@
  * == SandBox App for the Mashenka Game Engine ====================
  */
 
+// --stress runs the stress test instead of Sandbox2D, the other options set it up
+//   --quads <n> --textures <n>   what is drawn
+//   --frames <n>                 measure n frames, write the metrics and exit, for the perf farm
+//   --metrics <file>             where the metrics go, stress-metrics.json
+static bool ParseStressTest(const Mashenka::ApplicationCommandLineArgs& args, StressTestSpecification& specification)
+{
+    bool stress = false;
+    for (int i = 1; i < args.Count; i++)
+    {
+        std::string argument = args[i];
+        if (argument == "--stress")
+        {
+            stress = true;
+            continue;
+        }
+        if (i + 1 >= args.Count)
+            break;
+
+        if (argument == "--quads")
+            specification.QuadCount = static_cast<uint32_t>(std::atoi(args[++i]));
+        else if (argument == "--textures")
+            specification.TextureCount = static_cast<uint32_t>(std::atoi(args[++i]));
+        else if (argument == "--frames")
+            specification.Frames = static_cast<uint32_t>(std::atoi(args[++i]));
+        else if (argument == "--metrics")
+            specification.MetricsPath = args[++i];
+    }
+    return stress;
+}
+
 // The Sandbox class is the client application that using the engine
 class Sandbox : public Mashenka::Application
 {
 public:
-    Sandbox()
+    Sandbox(Mashenka::ApplicationCommandLineArgs args)
+        : Application(args)
     {
         //PushLayer(new ExampleLayer);
-        PushLayer(new Sandbox2D());
+        StressTestSpecification stressTest;
+        if (ParseStressTest(args, stressTest))
+            PushLayer(new StressTestLayer(stressTest));
+        else
+            PushLayer(new Sandbox2D());
     }
 
     // destructor
     ~Sandbox() = default;
 };
 
-Mashenka::Application* Mashenka::CreateApplication()
+Mashenka::Application* Mashenka::CreateApplication(ApplicationCommandLineArgs args)
 {
     printf("Sandbox is now on!");
-    return new Sandbox();
+    return new Sandbox(args);
 }
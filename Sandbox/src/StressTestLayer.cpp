@@ -0,0 +1,305 @@
+﻿#include "StressTestLayer.h"
+#include "Mashenka/Renderer/SampleSummary.h"
+
+#include <imgui/imgui.h>
+#include <chrono>
+#include <fstream>
+
+static constexpr uint32_t s_MaxQuadCount = 1000000;
+static constexpr uint32_t s_MaxTextureCount = 64;
+static constexpr uint32_t s_TextureSize = 16;
+static constexpr float s_Smoothing = 0.05f; // of the panel numbers, per frame
+static const glm::vec2 s_WorldHalfSize = {16.0f, 9.0f};
+
+StressTestLayer::StressTestLayer(const StressTestSpecification& specification)
+    : Layer("StressTestLayer"), m_Specification(specification)
+{
+    // the quads belong to the layer, its update shares nothing and can run next to any other layer
+    SetParallelUpdate({});
+}
+
+void StressTestLayer::OnAttach()
+{
+    MK_PROFILE_FUNCTION(); // Profiling
+    m_Queries = Mashenka::GPUTimerQueryPool::Create(64);
+    SetTextureCount(m_Specification.TextureCount);
+    SetQuadCount(m_Specification.QuadCount);
+
+    if (m_Specification.Frames > 0)
+    {
+        // the perf farm measures the renderer, not the pacing
+        Mashenka::FramePacer::SetFrameRateCap(0.0f);
+        Mashenka::FramePacer::SetBackgroundFrameRateCap(0.0f);
+        MK_INFO("Stress test: {0} quads, {1} textures, {2} frames", m_Specification.QuadCount,
+                m_Specification.TextureCount, m_Specification.Frames);
+    }
+}
+
+void StressTestLayer::SetTextureCount(uint32_t count)
+{
+    MK_PROFILE_FUNCTION(); // Profiling
+    count = std::clamp(count, 1u, s_MaxTextureCount);
+    m_Specification.TextureCount = count;
+
+    // small checkerboards, every texture in its own color
+    while (m_Textures.size() < count)
+    {
+        uint32_t index = static_cast<uint32_t>(m_Textures.size());
+        glm::vec3 color = {0.5f + 0.5f * std::sin(index * 0.9f), 0.5f + 0.5f * std::sin(index * 1.7f + 2.0f),
+                           0.5f + 0.5f * std::sin(index * 2.3f + 4.0f)};
+        std::vector<uint32_t> pixels(s_TextureSize * s_TextureSize);
+        for (uint32_t y = 0; y < s_TextureSize; y++)
+        {
+            for (uint32_t x = 0; x < s_TextureSize; x++)
+            {
+                float shade = ((x / 4 + y / 4) % 2) ? 1.0f : 0.6f;
+                uint32_t r = static_cast<uint32_t>(color.r * shade * 255.0f);
+                uint32_t g = static_cast<uint32_t>(color.g * shade * 255.0f);
+                uint32_t b = static_cast<uint32_t>(color.b * shade * 255.0f);
+                pixels[y * s_TextureSize + x] = 0xFF000000u | (b << 16) | (g << 8) | r;
+            }
+        }
+
+        auto texture = Mashenka::Texture2D::Create(s_TextureSize, s_TextureSize);
+        texture->SetData(pixels.data(), static_cast<uint32_t>(pixels.size() * sizeof(uint32_t)));
+        m_Textures.push_back(texture);
+    }
+    m_Textures.resize(count);
+
+    for (uint32_t& textureIndex : m_TextureIndices)
+        textureIndex %= count;
+}
+
+void StressTestLayer::SetQuadCount(uint32_t count)
+{
+    MK_PROFILE_FUNCTION(); // Profiling
+    count = std::clamp(count, 1u, s_MaxQuadCount);
+    m_Specification.QuadCount = count;
+
+    // xorshift, the same quads on every run
+    auto random = [this]()
+    {
+        m_RandomState ^= m_RandomState << 13;
+        m_RandomState ^= m_RandomState >> 17;
+        m_RandomState ^= m_RandomState << 5;
+        return static_cast<float>(m_RandomState >> 8) / 16777216.0f;
+    };
+
+    size_t previous = m_Positions.size();
+    m_Positions.resize(count);
+    m_Velocities.resize(count);
+    m_Sizes.resize(count);
+    m_Rotations.resize(count);
+    m_AngularVelocities.resize(count);
+    m_Colors.resize(count);
+    m_TextureIndices.resize(count);
+    for (size_t i = previous; i < count; i++)
+    {
+        m_Positions[i] = {(random() * 2.0f - 1.0f) * s_WorldHalfSize.x, (random() * 2.0f - 1.0f) * s_WorldHalfSize.y};
+        m_Velocities[i] = {(random() - 0.5f) * 4.0f, (random() - 0.5f) * 4.0f};
+        float size = 0.05f + random() * 0.2f;
+        m_Sizes[i] = {size, size};
+        m_Rotations[i] = random() * 6.2831853f;
+        m_AngularVelocities[i] = (random() - 0.5f) * 4.0f;
+        m_Colors[i] = {0.7f + 0.3f * random(), 0.7f + 0.3f * random(), 0.7f + 0.3f * random(), 1.0f};
+        m_TextureIndices[i] = static_cast<uint32_t>(i % m_Specification.TextureCount);
+    }
+}
+
+void StressTestLayer::UpdateQuads(float dt)
+{
+    MK_PROFILE_FUNCTION(); // Profiling
+    // the quads are independent, ranges of them update on the job system workers
+    auto count = static_cast<uint32_t>(m_Positions.size());
+    Mashenka::JobSystem::ParallelFor(count, 4096, [this, dt](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+            UpdateQuad(i, dt);
+    });
+}
+
+void StressTestLayer::UpdateQuad(uint32_t i, float dt)
+{
+    glm::vec2& position = m_Positions[i];
+    glm::vec2& velocity = m_Velocities[i];
+    position += velocity * dt;
+
+    // bounce off the edges of the view
+    if (std::abs(position.x) > s_WorldHalfSize.x)
+    {
+        velocity.x = -velocity.x;
+        position.x = std::clamp(position.x, -s_WorldHalfSize.x, s_WorldHalfSize.x);
+    }
+    if (std::abs(position.y) > s_WorldHalfSize.y)
+    {
+        velocity.y = -velocity.y;
+        position.y = std::clamp(position.y, -s_WorldHalfSize.y, s_WorldHalfSize.y);
+    }
+    m_Rotations[i] += m_AngularVelocities[i] * dt;
+}
+
+void StressTestLayer::ReadGPUTimes()
+{
+    while (!m_PendingQueries.empty() && m_Queries->IsAvailable(m_PendingQueries.front().second))
+    {
+        auto [begin, end] = m_PendingQueries.front();
+        m_PendingQueries.pop_front();
+        float gpuTime = static_cast<float>(m_Queries->GetTimestamp(end) - m_Queries->GetTimestamp(begin)) * 1e-6f;
+        m_Queries->Release(begin);
+        m_Queries->Release(end);
+
+        m_GPUTime += (gpuTime - m_GPUTime) * s_Smoothing;
+        if (m_Specification.Frames > 0 && m_Frame > m_Specification.WarmupFrames)
+            m_GPUTimes.push_back(gpuTime);
+    }
+}
+
+void StressTestLayer::OnUpdate(Mashenka::TimeStep ts)
+{
+    MK_PROFILE_FUNCTION(); // Profiling
+    // on a job system worker, everything touching GL is in OnRender
+    m_UpdateStart = std::chrono::steady_clock::now();
+    m_TimeStep = ts;
+    UpdateQuads(ts);
+}
+
+void StressTestLayer::OnRender()
+{
+    MK_PROFILE_FUNCTION(); // Profiling
+    ReadGPUTimes();
+
+    uint32_t beginQuery = m_Queries->WriteTimestamp();
+    {
+        MK_PROFILE_SCOPE("StressTest Draw");
+        Mashenka::RenderCommand::SetClearColor({0.05f, 0.05f, 0.08f, 1.0f});
+        Mashenka::RenderCommand::Clear();
+        Mashenka::Renderer2D::BeginScene(m_Camera);
+        // every core records a range of the quads, they are drawn in the same order as from one loop
+        auto count = static_cast<uint32_t>(m_Positions.size());
+        Mashenka::Renderer2D::ParallelSubmit(count, 8192, [this](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                Mashenka::Renderer2D::DrawRotatedQuad(m_Positions[i], m_Sizes[i], m_Rotations[i],
+                                                      m_Textures[m_TextureIndices[i]], 1.0f, m_Colors[i]);
+            }
+        });
+        Mashenka::Renderer2D::EndScene();
+    }
+    uint32_t endQuery = m_Queries->WriteTimestamp();
+    const uint32_t invalid = Mashenka::GPUTimerQueryPool::InvalidQuery;
+    if (beginQuery != invalid && endQuery != invalid)
+    {
+        m_PendingQueries.emplace_back(beginQuery, endQuery);
+    }
+    else
+    {
+        // the GPU is more frames behind than the pool covers, skip this frame
+        if (beginQuery != invalid)
+            m_Queries->Release(beginQuery);
+        if (endQuery != invalid)
+            m_Queries->Release(endQuery);
+    }
+
+    float cpuTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_UpdateStart).count();
+    float frameTime = m_TimeStep.GetMilliseconds();
+    const auto& stats = Mashenka::RendererStats::GetStats();
+    m_DrawCalls = stats.DrawCalls;
+    m_QuadsDrawn = stats.QuadCount;
+    m_FrameTime += (frameTime - m_FrameTime) * s_Smoothing;
+    m_CPUTime += (cpuTime - m_CPUTime) * s_Smoothing;
+
+    if (m_Specification.Frames == 0)
+        return;
+
+    // command line mode, the time step of the first frames includes the loading
+    m_Frame++;
+    if (m_Frame <= m_Specification.WarmupFrames)
+        return;
+
+    m_FrameTimes.push_back(frameTime);
+    m_CPUTimes.push_back(cpuTime);
+    m_QuadsPerSecond.push_back(frameTime > 0.0f ? m_QuadsDrawn * 1000.0f / frameTime : 0.0f);
+    m_DrawCallCounts.push_back(static_cast<float>(m_DrawCalls));
+    if (m_FrameTimes.size() == m_Specification.Frames)
+    {
+        WriteMetrics();
+        Mashenka::Application::Get().Close();
+    }
+}
+
+void StressTestLayer::WriteMetrics() const
+{
+    MK_PROFILE_FUNCTION(); // Profiling
+    using Mashenka::Summarize;
+    const Mashenka::SampleSummary<float> frame = Summarize(m_FrameTimes), cpu = Summarize(m_CPUTimes),
+                                         gpu = Summarize(m_GPUTimes);
+    const Mashenka::SampleSummary<float> quadsPerSecond = Summarize(m_QuadsPerSecond),
+                                         drawCalls = Summarize(m_DrawCallCounts);
+
+    MK_INFO("Stress test: {0} quads, {1} textures, {2} frames", m_Specification.QuadCount,
+            m_Specification.TextureCount, m_FrameTimes.size());
+    MK_INFO("  frame: mean {0:.3f} ms, p50 {1:.3f} ms, p95 {2:.3f} ms, p99 {3:.3f} ms", frame.Mean, frame.P50,
+            frame.P95, frame.P99);
+    MK_INFO("  CPU:   mean {0:.3f} ms, p50 {1:.3f} ms, p95 {2:.3f} ms, p99 {3:.3f} ms", cpu.Mean, cpu.P50, cpu.P95,
+            cpu.P99);
+    MK_INFO("  GPU:   mean {0:.3f} ms, p50 {1:.3f} ms, p95 {2:.3f} ms, p99 {3:.3f} ms", gpu.Mean, gpu.P50, gpu.P95,
+            gpu.P99);
+    MK_INFO("  {0:.3f} Mquads/s, {1:.1f} draw calls", quadsPerSecond.Mean / 1e6f, drawCalls.Mean);
+
+    std::ofstream file(m_Specification.MetricsPath);
+    if (!file)
+    {
+        MK_ERROR("Could not write the metrics to '{0}'", m_Specification.MetricsPath);
+        return;
+    }
+
+    auto writeSummary = [&file](const char* name, const Mashenka::SampleSummary<float>& summary, const char* separator)
+    {
+        file << "    \"" << name << "\": {\"mean\": " << summary.Mean << ", \"p50\": " << summary.P50
+            << ", \"p95\": " << summary.P95 << ", \"p99\": " << summary.P99 << "}" << separator << "\n";
+    };
+    file << "{\n";
+    file << "    \"quads\": " << m_Specification.QuadCount << ",\n";
+    file << "    \"textures\": " << m_Specification.TextureCount << ",\n";
+    file << "    \"frames\": " << m_FrameTimes.size() << ",\n";
+    writeSummary("frame_ms", frame, ",");
+    writeSummary("cpu_ms", cpu, ",");
+    writeSummary("gpu_ms", gpu, ",");
+    writeSummary("quads_per_second", quadsPerSecond, ",");
+    writeSummary("draw_calls", drawCalls, "");
+    file << "}\n";
+    MK_INFO("Wrote the metrics to '{0}'", m_Specification.MetricsPath);
+}
+
+void StressTestLayer::OnImGuiRender()
+{
+    MK_PROFILE_FUNCTION(); // Profiling
+    ImGui::Begin("Stress Test");
+
+    int quadCount = static_cast<int>(m_Specification.QuadCount);
+    if (ImGui::DragInt("Quads", &quadCount, 1000.0f, 1000, static_cast<int>(s_MaxQuadCount)))
+        SetQuadCount(static_cast<uint32_t>(quadCount));
+    const uint32_t presets[] = {1000u, 10000u, 100000u, 1000000u};
+    for (uint32_t preset : presets)
+    {
+        if (preset != presets[0])
+            ImGui::SameLine();
+        std::string label = preset >= 1000000u ? std::to_string(preset / 1000000u) + "M"
+                                               : std::to_string(preset / 1000u) + "k";
+        if (ImGui::Button(label.c_str()))
+            SetQuadCount(preset);
+    }
+
+    int textureCount = static_cast<int>(m_Specification.TextureCount);
+    if (ImGui::SliderInt("Textures", &textureCount, 1, static_cast<int>(s_MaxTextureCount)))
+        SetTextureCount(static_cast<uint32_t>(textureCount));
+
+    ImGui::Separator();
+    float quadsPerSecond = m_FrameTime > 0.0f ? m_QuadsDrawn * 1000.0f / m_FrameTime : 0.0f;
+    ImGui::Text("%.2f Mquads/s", quadsPerSecond / 1e6f);
+    ImGui::Text("Draw calls: %u, quads drawn: %u", m_DrawCalls, m_QuadsDrawn);
+    ImGui::Text("Frame: %.2f ms (%.0f FPS)", m_FrameTime, m_FrameTime > 0.0f ? 1000.0f / m_FrameTime : 0.0f);
+    ImGui::Text("CPU: %.2f ms, GPU: %.2f ms", m_CPUTime, m_GPUTime);
+    ImGui::End();
+}
@@ -0,0 +1,66 @@
+﻿#pragma once
+#include "Mashenka.h"
+#include "Mashenka/Renderer/GPUTimerQueryPool.h"
+
+#include <chrono>
+#include <deque>
+
+// What the stress test draws and for how long, from the ImGui panel or the command line
+struct StressTestSpecification
+{
+    uint32_t QuadCount = 10000; // 1k to 1M
+    uint32_t TextureCount = 32; // more than the 16 texture slots forces extra batches
+    // More than 0 is the command line mode: measure that many frames, write the metrics and close the application
+    uint32_t Frames = 0;
+    uint32_t WarmupFrames = 60;
+    std::string MetricsPath = "stress-metrics.json";
+};
+
+// Moving, rotating, textured quads through Renderer2D, to see how the renderer scales with the quad count
+class StressTestLayer : public Mashenka::Layer
+{
+public:
+    StressTestLayer(const StressTestSpecification& specification);
+    virtual ~StressTestLayer() = default;
+
+    virtual void OnAttach() override;
+    void OnUpdate(Mashenka::TimeStep ts) override;
+    void OnRender() override;
+    virtual void OnImGuiRender() override;
+
+private:
+    void SetQuadCount(uint32_t count);
+    void SetTextureCount(uint32_t count);
+    void UpdateQuads(float dt);
+    void UpdateQuad(uint32_t i, float dt);
+    void ReadGPUTimes();
+    void WriteMetrics() const;
+
+private:
+    StressTestSpecification m_Specification;
+    Mashenka::OrthographicCamera m_Camera{-16.0f, 16.0f, -9.0f, 9.0f};
+    std::vector<Mashenka::Ref<Mashenka::Texture2D>> m_Textures;
+
+    // the quads as structure of arrays, only the update walks over them
+    std::vector<glm::vec2> m_Positions, m_Velocities, m_Sizes;
+    std::vector<float> m_Rotations, m_AngularVelocities;
+    std::vector<glm::vec4> m_Colors;
+    std::vector<uint32_t> m_TextureIndices;
+    uint32_t m_RandomState = 0x2545F491u;
+
+    // GPU time of the scene, read a few frames later
+    Mashenka::Scope<Mashenka::GPUTimerQueryPool> m_Queries;
+    std::deque<std::pair<uint32_t, uint32_t>> m_PendingQueries;
+
+    // from OnUpdate to the end of OnRender
+    std::chrono::steady_clock::time_point m_UpdateStart;
+    Mashenka::TimeStep m_TimeStep;
+
+    // smoothed for the panel, milliseconds
+    float m_FrameTime = 0.0f, m_CPUTime = 0.0f, m_GPUTime = 0.0f;
+    uint32_t m_DrawCalls = 0, m_QuadsDrawn = 0;
+
+    // command line mode, one entry per measured frame
+    uint32_t m_Frame = 0;
+    std::vector<float> m_FrameTimes, m_CPUTimes, m_GPUTimes, m_QuadsPerSecond, m_DrawCallCounts;
+};
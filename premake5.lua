@@ -140,6 +140,104 @@ project "Sandbox"
         "Mashenka"
     }
 
+    filter "system:windows"
+        systemversion "latest"
+
+    filter "configurations:Debug"
+        defines "MK_DEBUG"
+        runtime "Debug"
+        symbols "On"
+
+    filter "configurations:Release"             
+        defines "MK_RELEASE"
+        runtime "Release"
+        optimize "On"
+
+    filter "configurations:Dist"  
+        defines "MK_DIST"
+        runtime "Release"
+        optimize "On"
+
+project "MashenkaBench"
+    location "MashenkaBench"
+    kind "ConsoleApp"
+    language "C++"
+    staticruntime "on"
+    cppdialect "C++17"
+
+    targetdir ("bin/" ..outputdir.. "/%{prj.name}")
+    objdir ("bin-int/" ..outputdir.. "/%{prj.name}")
+
+    debugdir "Sandbox" -- the shader benchmarks read assets/shaders
+
+    files
+    {
+        "%{prj.name}/src/**.h",
+        "%{prj.name}/src/**.cpp"
+    }
+    
+    includedirs
+    {
+        "Mashenka/vendor/spdlog/include",
+        "Mashenka/src",
+        "%{IncludeDir.glm}",
+        "Mashenka/vendor"
+    }
+
+    links
+    {
+        "Mashenka"
+    }
+
+    filter "system:windows"
+        systemversion "latest"
+
+    filter "configurations:Debug"
+        defines "MK_DEBUG"
+        runtime "Debug"
+        symbols "On"
+
+    filter "configurations:Release"             
+        defines "MK_RELEASE"
+        runtime "Release"
+        optimize "On"
+
+    filter "configurations:Dist"  
+        defines "MK_DIST"
+        runtime "Release"
+        optimize "On"
+
+-- Renders scripted scenes on llvmpipe, fails on golden image or frame time regressions --
+project "MashenkaRegression"
+    location "MashenkaRegression"
+    kind "ConsoleApp"
+    language "C++"
+    staticruntime "on"
+    cppdialect "C++17"
+
+    targetdir ("bin/" ..outputdir.. "/%{prj.name}")
+    objdir ("bin-int/" ..outputdir.. "/%{prj.name}")
+    debugdir "Sandbox" -- the scenes load assets/ like the Sandbox does
+
+    files
+    {
+        "%{prj.name}/src/**.h",
+        "%{prj.name}/src/**.cpp"
+    }
+    
+    includedirs
+    {
+        "Mashenka/vendor/spdlog/include",
+        "Mashenka/src",
+        "%{IncludeDir.glm}",
+        "Mashenka/vendor"
+    }
+
+    links
+    {
+        "Mashenka"
+    }
+
     filter "system:windows"
         systemversion "latest"
 